@@ -35,7 +35,8 @@ public:
 } menuMgrListener;
 
 
-BaseMenuRenderer::BaseMenuRenderer(int bufferSize, RendererType rType, uint8_t displayNum) : MenuRenderer(rType, bufferSize) {
+BaseMenuRenderer::BaseMenuRenderer(int bufferSize, RendererType rType, uint8_t displayNum) : MenuRenderer(rType, bufferSize),
+                                                                                               requestEvent(this) {
 	ticksToReset = 0;
     lastOffset = 0;
     displayNumber = displayNum;
@@ -80,6 +81,10 @@ bool BaseMenuRenderer::tryTakeSelectIfNeeded(int currentReading, RenderPressMode
 }
 
 void BaseMenuRenderer::exec() {
+    renderTaskId = TASKMGR_INVALIDID;
+    frameScheduled = false;
+    lastFrameMillis = millis();
+
     // If a dialog is active, they take priority, either menu based or rendering based dialog, these are highest.
     // Then we check if the display is taken over, if it is, that takes priority (either functional or OO takeover,
     // finally we render the menu if none of the above are true.
@@ -101,10 +106,117 @@ void BaseMenuRenderer::exec() {
 
     // here we work out when we should be called again, this allows the number of updates per second to be changed
     // during the run of the application.
-    if(updatesPerSecond != UPDATES_SEC_DISPLAY_OFF) {
-        int refreshInterval = 1000 / updatesPerSecond;
-        taskManager.scheduleOnce(refreshInterval, this);
+    if(updatesPerSecond == UPDATES_SEC_DISPLAY_OFF) return;
+    if(maxFramesPerSecond != 0) {
+        scheduleNextEventDrivenWake();
+    } else {
+        int refreshInterval = 1000 / updateEffectiveFrameRate();
+        nextFrameMillis = millis() + refreshInterval;
+        renderTaskId = taskManager.scheduleOnce(refreshInterval, this);
+    }
+}
+
+void BaseMenuRenderer::setAdaptiveFrameRate(const AdaptiveFrameRate& curve) {
+    adaptiveRate = curve;
+    if(adaptiveRate.activeFps < adaptiveRate.idleFps) adaptiveRate.activeFps = adaptiveRate.idleFps;
+    if(adaptiveRate.idleFps != 0) registerRequestEvent();
+}
+
+void BaseMenuRenderer::registerRequestEvent() {
+    if(requestEventRegistered) return;
+    requestEventRegistered = true;
+    taskManager.registerEvent(&requestEvent);
+}
+
+void RenderRequestEvent::exec() {
+    renderer->scheduleFrame();
+}
+
+uint8_t BaseMenuRenderer::updateEffectiveFrameRate() {
+    if(adaptiveRate.idleFps == 0) {
+        effectiveFps = maxFramesPerSecond ? maxFramesPerSecond : updatesPerSecond;
+        return effectiveFps;
     }
+
+    // boosted while editing and for the hold time after any interaction, then decays in a straight line to idle.
+    unsigned long since = millis() - lastAlteredMillis;
+    if(menuMgr.getCurrentEditor() != nullptr || since < adaptiveRate.holdMillis) {
+        effectiveFps = adaptiveRate.activeFps;
+    } else if(since - adaptiveRate.holdMillis >= adaptiveRate.decayMillis) {
+        effectiveFps = adaptiveRate.idleFps;
+    } else {
+        unsigned long range = adaptiveRate.activeFps - adaptiveRate.idleFps;
+        effectiveFps = adaptiveRate.activeFps - (range * (since - adaptiveRate.holdMillis)) / adaptiveRate.decayMillis;
+    }
+    return effectiveFps;
+}
+
+void BaseMenuRenderer::setEventDrivenRendering(uint8_t maxFrameRate) {
+    if(maxFramesPerSecond == 0 && maxFrameRate != 0 && updatesPerSecond != UPDATES_SEC_DISPLAY_OFF) {
+        // there is already a fixed rate frame on its way, when it runs it will decide when to wake next.
+        frameScheduled = true;
+    }
+    bool wasEventDriven = maxFramesPerSecond != 0;
+    maxFramesPerSecond = maxFrameRate;
+    if(maxFrameRate != 0) registerRequestEvent();
+    if(wasEventDriven && maxFrameRate == 0 && !frameScheduled) {
+        // go back to polling, the fixed rate frames reschedule themselves from now on.
+        if(renderTaskId != TASKMGR_INVALIDID) taskManager.cancelTask(renderTaskId);
+        renderTaskId = TASKMGR_INVALIDID;
+        frameScheduled = true;
+        taskManager.execute(this);
+    }
+}
+
+void BaseMenuRenderer::requestRender() {
+    // without the event there is neither event driven nor adaptive rendering, so the next frame is on its way anyway.
+    if(requestEventRegistered) requestEvent.markTriggeredAndNotify();
+}
+
+void BaseMenuRenderer::scheduleFrame() {
+    if(updatesPerSecond == UPDATES_SEC_DISPLAY_OFF) return;
+    if(maxFramesPerSecond == 0) {
+        // at a low idle rate the next fixed rate frame may be a long way off, bring it forward once boosted.
+        if(adaptiveRate.idleFps == 0 || renderTaskId == TASKMGR_INVALIDID) return;
+        unsigned long interval = 1000UL / updateEffectiveFrameRate();
+        if(long(nextFrameMillis - millis()) <= long(interval)) return;
+        taskManager.cancelTask(renderTaskId);
+        nextFrameMillis = millis() + interval;
+        renderTaskId = taskManager.scheduleOnce(interval, this);
+        return;
+    }
+    if(frameScheduled && (adaptiveRate.idleFps == 0 || renderTaskId == TASKMGR_INVALIDID)) return;
+
+    unsigned long interval = 1000UL / updateEffectiveFrameRate();
+    unsigned long sinceLast = millis() - lastFrameMillis;
+    unsigned long delay = sinceLast >= interval ? 0 : interval - sinceLast;
+
+    // a frame scheduled while idle may be a long way off, only replace it when the boosted rate would draw sooner.
+    if(frameScheduled && long(nextFrameMillis - millis()) <= long(delay)) return;
+
+    // a wake up for the reset timeout may be waiting, the frame replaces it and works out the next wake itself.
+    if(renderTaskId != TASKMGR_INVALIDID) taskManager.cancelTask(renderTaskId);
+    frameScheduled = true;
+    nextFrameMillis = millis() + delay;
+    renderTaskId = taskManager.scheduleOnce(delay, this);
+}
+
+void BaseMenuRenderer::scheduleNextEventDrivenWake() {
+    // self rendering dialogs and taken over displays are drawn in a loop, so they keep going at the maximum rate.
+    if((dialog != nullptr && dialog->isRenderNeeded()) || displayTakenMode != NOT_TAKEN_OVER) {
+        scheduleFrame();
+        return;
+    }
+
+    // otherwise sleep until something changes, waking only when the reset timeout is due.
+    if(frameScheduled || (resetValInTicks & RENDERER_RESET_OFF) || ticksToReset == RENDERER_MAXIMUM_TICK_MASK) return;
+    unsigned long sinceAltered = millis() - lastAlteredMillis;
+    unsigned long timeout = resetTimeoutMillis();
+    renderTaskId = taskManager.scheduleOnce(sinceAltered >= timeout ? 0 : timeout - sinceAltered, this);
+}
+
+unsigned long BaseMenuRenderer::resetTimeoutMillis() const {
+    return ((resetValInTicks & RENDERER_MAXIMUM_TICK_MASK) * 1000UL) / (updatesPerSecond ? updatesPerSecond : 1);
 }
 
 void BaseMenuRenderer::resetToDefault() {
@@ -126,6 +238,16 @@ void BaseMenuRenderer::resetToDefault() {
 void BaseMenuRenderer::countdownToDefaulting() {
     if(dialog != nullptr && dialog->isInUse()) {
         ticksToReset = resetValInTicks;
+        lastAlteredMillis = millis();
+        return;
+    }
+    if(maxFramesPerSecond != 0 || adaptiveRate.idleFps != 0) {
+        // frames are irregular when event driven or adaptive, so the timeout is measured in time instead of frames.
+        if(ticksToReset == RENDERER_MAXIMUM_TICK_MASK || (resetValInTicks & RENDERER_RESET_OFF)) return;
+        if(millis() - lastAlteredMillis >= resetTimeoutMillis()) {
+            resetToDefault();
+            ticksToReset = RENDERER_MAXIMUM_TICK_MASK;
+        }
         return;
     }
 	if (ticksToReset == 0) {
@@ -143,6 +265,7 @@ void BaseMenuRenderer::takeOverDisplay(RendererCallbackFn displayFn) {
 	renderFnPressType = RPRESS_NONE;
     displayTakenMode = displayFn ? TAKEN_OVER_FN : START_CUSTOM_DRAW;
 	renderCallback = displayFn;
+    scheduleFrame();
 }
 
 void BaseMenuRenderer::giveBackDisplay() {
@@ -220,6 +343,15 @@ void BaseMenuRenderer::setUpdatesPerSecond(int updatesSec) {
     }
 }
 
+void TitleWidget::setCurrentState(uint8_t state) {
+    // if outside of allowable icons or value hasn't changed just return.
+    if (state >= maxStateIcons || currentState == state) return;
+
+    this->currentState = state;
+    this->changed = true;
+    if(MenuRenderer::getInstance()) MenuRenderer::getInstance()->requestRender();
+}
+
 TitleWidget::TitleWidget(const uint8_t * const* icons, uint8_t maxStateIcons, uint8_t width, uint8_t height, TitleWidget* next) {
 	this->iconData = icons;
 	this->maxStateIcons = maxStateIcons;
@@ -158,14 +158,11 @@ public:
     }
 #endif
 
-	/** sets the current state of the widget, there must be an icon for this value */
-	void setCurrentState(uint8_t state) {
-        // if outside of allowable icons or value hasn't changed just return.
-		if (state >= maxStateIcons || currentState == state) return; 
-        
-		this->currentState = state;
-		this->changed = true;
-	}
+	/**
+	 * sets the current state of the widget, there must be an icon for this value. When the renderer is event driven,
+	 * this also asks for a frame, so in that mode it must not be called from an interrupt.
+	 */
+	void setCurrentState(uint8_t state);
 
 	/** checks if the widget has changed since last drawn. */
 	bool isChanged() {return this->changed;}
@@ -228,7 +225,10 @@ public:
     virtual BaseDialog* getDialog() = 0;
 
 	/** virtual destructor is required by the language */
-	virtual ~MenuRenderer() { }
+	virtual ~MenuRenderer() {
+        // menu items ask the instance to render when they change, so it must never point to a deleted renderer.
+        if(theInstance == this) theInstance = nullptr;
+    }
 
     /* Gets the rendering instance */
     static MenuRenderer* getInstance() { return theInstance; }
@@ -245,6 +245,13 @@ public:
 
     /** Returns if this is a no display type renderer or a base renderer type. */
     RendererType getRendererType() { return rendererType; }
+
+    /**
+     * Tells the renderer that something needs drawing, renderers that draw on a fixed schedule ignore this, but
+     * event driven renderers schedule a frame. Menu items and title widgets call this when they change, so it must
+     * be safe to call from an interrupt or another thread.
+     */
+    virtual void requestRender() { }
 };
 
 /**
@@ -271,6 +278,37 @@ public:
 
 class RemoteMenuItem; // forward reference.
 
+/**
+ * Describes how the frame rate of a renderer changes with user interaction. The renderer draws at the active rate
+ * while an item is being edited, and for the hold time after any encoder, key or touch activity. After that, the rate
+ * falls in a straight line to the idle rate over the decay time, a decay time of 0 drops straight to idle.
+ */
+struct AdaptiveFrameRate {
+    /** the frame rate when there has been no interaction for a while, 0 turns adaptive frame rate off */
+    uint8_t idleFps;
+    /** the frame rate during and shortly after interaction */
+    uint8_t activeFps;
+    /** how long to stay at the active rate after the last interaction */
+    uint16_t holdMillis;
+    /** how long it takes to get from the active rate down to the idle rate */
+    uint16_t decayMillis;
+};
+
+class BaseMenuRenderer; // forward reference.
+
+/**
+ * Passes render requests over to task manager's thread. Menu items and title widgets can change from an interrupt
+ * or another thread, so a request only marks this event as triggered, and the frame is scheduled when it runs.
+ */
+class RenderRequestEvent : public BaseEvent {
+private:
+    BaseMenuRenderer* renderer;
+public:
+    explicit RenderRequestEvent(BaseMenuRenderer* renderer) : renderer(renderer) {}
+    uint32_t timeOfNextCheck() override { return secondsToMicros(60); }
+    void exec() override;
+};
+
 /**
  * This class provides the base functionality that will be required by most implementations
  * of renderer, you can extend this class to add new renderers, it proivides much of the
@@ -297,6 +335,16 @@ protected:
 	RenderPressMode renderFnPressType;
 	RendererCallbackFn renderCallback;
     MenuItem* activeItem = nullptr;
+    unsigned long lastFrameMillis = 0;
+    unsigned long lastAlteredMillis = 0;
+    taskid_t renderTaskId = TASKMGR_INVALIDID;
+    unsigned long nextFrameMillis = 0;
+    AdaptiveFrameRate adaptiveRate = {};
+    uint8_t maxFramesPerSecond = 0;
+    uint8_t effectiveFps = 0;
+    bool frameScheduled = false;
+    bool requestEventRegistered = false;
+    RenderRequestEvent requestEvent;
 public:
 	/**
 	 * constructs the renderer with a given buffer size 
@@ -322,6 +370,65 @@ public:
 	 */
 	void setUpdatesPerSecond(int updatesSec);
 
+    /**
+     * Switches the renderer to event driven mode, where instead of drawing at a fixed rate, a frame is only scheduled
+     * when something changes, such as a menu item, navigation, a dialog or input. Frames are never closer together
+     * than the maximum rate given, and when nothing changes there are no wakeups at all apart from one for the reset
+     * timeout. Dialogs that render themselves and displays that have been taken over still draw in a loop at the
+     * maximum rate.
+     *
+     * Menu items and title widgets may still be changed from an interrupt, their render request is passed to task
+     * manager's thread by an event that this registers, and the frame is scheduled when that event runs.
+     * @param maxFrameRate the most frames to draw per second, or 0 to go back to drawing at a fixed rate
+     */
+    void setEventDrivenRendering(uint8_t maxFrameRate);
+
+    /** @return true if the renderer only draws when something changes */
+    bool isEventDrivenRendering() const { return maxFramesPerSecond != 0; }
+
+    /**
+     * Makes the frame rate follow user interaction, drawing at a high rate while the encoder, keys or touch screen
+     * are in use or an item is being edited, and dropping back to a low idle rate afterwards. With polling, this
+     * replaces the updates per second, and when event driven it replaces the maximum frame rate. The reset timeout is
+     * measured in time rather than frames while this is on.
+     * @param curve the idle and active rates, and how long to hold the active rate and decay from it.
+     */
+    void setAdaptiveFrameRate(const AdaptiveFrameRate& curve);
+
+    /**
+     * Makes the frame rate follow user interaction, see the overload taking AdaptiveFrameRate for details.
+     * @param idleFps the frame rate when there has been no interaction for a while
+     * @param activeFps the frame rate during and shortly after interaction
+     * @param holdMillis how long to stay at the active rate after the last interaction
+     * @param decayMillis how long it takes to get from the active rate down to the idle rate
+     */
+    void setAdaptiveFrameRate(uint8_t idleFps, uint8_t activeFps, uint16_t holdMillis = 2000, uint16_t decayMillis = 3000) {
+        setAdaptiveFrameRate(AdaptiveFrameRate{idleFps, activeFps, holdMillis, decayMillis});
+    }
+
+    /** turn off adaptive frame rate, going back to the updates per second or maximum frame rate */
+    void turnOffAdaptiveFrameRate() { adaptiveRate = {}; }
+
+    /** @return the adaptive frame rate curve, where an idle rate of 0 means that it is off */
+    const AdaptiveFrameRate& getAdaptiveFrameRate() const { return adaptiveRate; }
+
+    /** @return the frame rate that was chosen when the most recent frame was scheduled, useful for telemetry */
+    uint8_t getEffectiveFrameRate() const { return effectiveFps; }
+
+    /**
+     * Asks for a frame when event driven or using an adaptive frame rate, otherwise this does nothing as the next
+     * frame is already on its way. This is safe to call from an interrupt or another thread, it only triggers an
+     * event, and the frame is scheduled on task manager's thread by scheduleFrame.
+     */
+    void requestRender() override;
+
+    /**
+     * When event driven, schedules a frame as soon as the maximum frame rate allows, if one is not already scheduled.
+     * With an adaptive frame rate, in either mode, brings the next frame forward when the rate has been boosted. As it
+     * cancels and schedules tasks, it must only be called on task manager's thread, use requestRender anywhere else.
+     */
+    void scheduleFrame();
+
     /**
      * Turn off the display updates to allow for low power state transition, to re-enable call setUpdatesPerSecond
      * @see setUpdatesPerSecond
@@ -454,9 +561,13 @@ public:
 
 	/**
 	 * Called when the menu has been altered, to reset the countdown to
-	 * reset behaviour
+	 * reset behaviour. Input devices call this on any activity, which also boosts an adaptive frame rate.
 	 */
-	void menuAltered() { ticksToReset = resetValInTicks; }
+	void menuAltered() {
+        ticksToReset = resetValInTicks;
+        lastAlteredMillis = millis();
+        scheduleFrame();
+    }
 
 	/**
 	 * In order to take over the display, provide a callback function that will receive
@@ -485,12 +596,18 @@ public:
 	 * Sets the type of redraw that is needed
 	 * @param state the required redraw
 	 */
-	void redrawRequirement(MenuRedrawState state) { if (state > redrawMode) redrawMode = state; }
+	void redrawRequirement(MenuRedrawState state) {
+        if (state > redrawMode) redrawMode = state;
+        scheduleFrame();
+    }
 
     /**
      * Completely invalidate all drawing and instigate a complete redraw of all elements.
      */
-    void invalidateAll() { redrawMode = MENUDRAW_COMPLETE_REDRAW; }
+    void invalidateAll() {
+        redrawMode = MENUDRAW_COMPLETE_REDRAW;
+        scheduleFrame();
+    }
 
     static BaseMenuRenderer* getInstance() { return reinterpret_cast<BaseMenuRenderer *>(theInstance); }
 
@@ -499,6 +616,12 @@ protected:
 	 * set up a countdown to default back to the submenu
 	 */
 	void countdownToDefaulting();
+
+private:
+    void scheduleNextEventDrivenWake();
+    void registerRequestEvent();
+    uint8_t updateEffectiveFrameRate();
+    unsigned long resetTimeoutMillis() const;
 };
 
 bool isCardLayoutActive(MenuItem* root);
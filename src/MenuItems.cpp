@@ -97,6 +97,9 @@ uint16_t MenuItem::getMaximumValue() const
 }
 
 void MenuItem::changeOccurred(bool silent) {
+#if TC_MENU_CHANGE_TIMESTAMPS != 0
+    lastChangeMillis = millis();
+#endif
     setChanged(true);
     setSendRemoteNeededAll();
     if(!silent) triggerCallback();
@@ -116,7 +119,9 @@ void MenuItem::setChanged(bool changed) {
         flags = flags & (~MENUITEM_ALL_CHANGE);
     }
 
-    if(isLocalOnly() || !changed) return;
+    if(!changed) return;
+    if(MenuRenderer::getInstance()) MenuRenderer::getInstance()->requestRender();
+    if(isLocalOnly()) return;
 
     setSendRemoteNeededAll();
 }
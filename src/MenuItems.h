@@ -38,6 +38,15 @@ typedef uint16_t menuid_t;
 #define UNIT_SIZE_T 5
 #endif // NAME_SIZE_T
 
+/**
+ * When enabled, each menu item records the device millis at which its last change occurred, and this is sent to remotes
+ * along with value changes so that they can plot and order changes by when they happened rather than when they arrived.
+ * It costs four bytes of RAM per item and adds a field to change messages, so it is off unless you define it as 1.
+ */
+#ifndef TC_MENU_CHANGE_TIMESTAMPS
+#define TC_MENU_CHANGE_TIMESTAMPS 0
+#endif // TC_MENU_CHANGE_TIMESTAMPS
+
 /** the value that represents no call back */
 #define NO_CALLBACK NULL
 
@@ -343,6 +352,9 @@ protected:
     const AnyMenuInfo *info = nullptr;
     RuntimeRenderingFn renderFn = nullptr;
 	MenuType menuType;
+#if TC_MENU_CHANGE_TIMESTAMPS != 0
+    uint32_t lastChangeMillis = 0;
+#endif
 public:
 
     /**
@@ -374,7 +386,8 @@ public:
     bool isInfoProgMem() const { return bitRead(flags, MENUITEM_INFO_STRUCT_PGM); }
 
 	/** set the item to be changed to all renderers, and when changed is true all remotes as well. When clearing
-	 * changed flag prefer to use the numbered version below. */
+	 * changed flag prefer to use the numbered version below. Marking it changed asks the renderer to draw, this only
+	 * triggers an event, so it is safe from an interrupt even when the renderer is event driven. */
 	void setChanged(bool changed);
 	/** set the item to be changed, this lets a renderer know it needs painting */
 	void setChanged(int num, bool changed) { bitWrite(flags, (num & 3), changed); }
@@ -415,9 +428,21 @@ public:
 	void setNext(MenuItem* pNext) { this->next = pNext; }
 
     /**
-     * Marks the menu item as having updated locally and remotely and also calls the callback if not silent
+     * Marks the menu item as having updated locally and remotely and also calls the callback if not silent. When
+     * TC_MENU_CHANGE_TIMESTAMPS is enabled, the time of the change is also recorded.
      */
     void changeOccurred(bool silent);
+
+    /**
+     * Gets the value of millis() when changeOccurred was last called for this item, this is sent to remotes along
+     * with the value. Always 0 when TC_MENU_CHANGE_TIMESTAMPS is not enabled, or if the item has not changed yet.
+     * @return the millis of the last change or 0.
+     */
+#if TC_MENU_CHANGE_TIMESTAMPS != 0
+    uint32_t getLastChangeMillis() const { return lastChangeMillis; }
+#else
+    uint32_t getLastChangeMillis() const { return 0; }
+#endif
 protected:
 	/**
 	 * Do not directly create menu items, always use the leaf classes, such as AnalogMenuItem etc.
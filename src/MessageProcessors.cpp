@@ -9,23 +9,156 @@
 #include "MenuIterator.h"
 #include "BaseDialog.h"
 #include "EditableLargeNumberMenuItem.h"
+#include <stddef.h>
 
 const EmbedControlFlashedForm** CombinedMessageProcessor::flashedFormTemplates = nullptr;
 
-CombinedMessageProcessor::CombinedMessageProcessor() {
+// the built in handlers, fields that are in the decoding table below have already been decoded when these are called.
+static void handleValueMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handleJoinMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handlePairingMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handleDialogMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handleHeartbeatMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handleListPageMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handleGetFormNames(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handleFormRequest(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handleValueQueryMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+static void handleExpandMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+
+struct BuiltInMsgHandler {
+    uint16_t msgType;
+    FieldUpdateFunction fn;
+};
+
+const BuiltInMsgHandler builtInHandlers[] PROGMEM = {
+    { MSG_CHANGE_INT, handleValueMsg },
+    { MSG_JOIN, handleJoinMsg },
+    { MSG_PAIR, handlePairingMsg },
+    { MSG_DIALOG, handleDialogMsg },
+    { MSG_HEARTBEAT, handleHeartbeatMsg },
+    { MSG_LIST_PAGE, handleListPageMsg },
+    { MSG_FORM_NAMES, handleGetFormNames },
+    { MSG_FORM_REQUEST, handleFormRequest },
+    { MSG_VALUE_QUERY, handleValueQueryMsg },
+    { MSG_SUBMENU_EXPAND, handleExpandMsg }
+};
+
+#define DECODE_INTO(msgType, field, decodeType, member) { msgType, field, decodeType, uint8_t(offsetof(MessageProcessorInfo, member)) }
+
+// entries for the same message type must be next to each other, as each message only searches its own entries.
+const MsgFieldDecoder fieldDecoders[] PROGMEM = {
+    DECODE_INTO(MSG_CHANGE_INT, FIELD_CORRELATION, FIELD_DECODE_HEX32, value.correlation),
+    DECODE_INTO(MSG_CHANGE_INT, FIELD_CHANGE_TYPE, FIELD_DECODE_UINT8, value.changeType),
+    DECODE_INTO(MSG_JOIN, FIELD_PLATFORM, FIELD_DECODE_UINT8, join.platform),
+    DECODE_INTO(MSG_JOIN, FIELD_JOIN_MODE, FIELD_DECODE_UINT8, join.joinMode),
+    DECODE_INTO(MSG_JOIN, FIELD_JOIN_CAPS, FIELD_DECODE_UINT8, join.capabilities),
+    DECODE_INTO(MSG_DIALOG, FIELD_BUTTON1, FIELD_DECODE_DIGIT, dialog.button),
+    DECODE_INTO(MSG_DIALOG, FIELD_MODE, FIELD_DECODE_CHAR, dialog.mode),
+    DECODE_INTO(MSG_DIALOG, FIELD_CORRELATION, FIELD_DECODE_HEX32, dialog.correlation),
+    DECODE_INTO(MSG_HEARTBEAT, FIELD_HB_MODE, FIELD_DECODE_UINT8, hb.hbMode),
+    DECODE_INTO(MSG_LIST_PAGE, FIELD_ID, FIELD_DECODE_MENU_ITEM, listPage.item),
+    DECODE_INTO(MSG_LIST_PAGE, FIELD_LIST_START, FIELD_DECODE_UINT16, listPage.start),
+    DECODE_INTO(MSG_LIST_PAGE, FIELD_LIST_COUNT, FIELD_DECODE_UINT16, listPage.count),
+    DECODE_INTO(MSG_LIST_PAGE, FIELD_CORRELATION, FIELD_DECODE_HEX32, listPage.correlation),
+    DECODE_INTO(MSG_FORM_REQUEST, FIELD_FORM_OFFSET, FIELD_DECODE_UINT32, formLoad.offset),
+    DECODE_INTO(MSG_FORM_REQUEST, FIELD_FORM_CREDIT, FIELD_DECODE_UINT8, formLoad.credits),
+    DECODE_INTO(MSG_FORM_REQUEST, FIELD_CORRELATION, FIELD_DECODE_HEX32, formLoad.correlation),
+    DECODE_INTO(MSG_VALUE_QUERY, FIELD_CORRELATION, FIELD_DECODE_HEX32, valueQuery.correlation),
+    DECODE_INTO(MSG_SUBMENU_EXPAND, FIELD_ID, FIELD_DECODE_UINT16, expand.id),
+    DECODE_INTO(MSG_SUBMENU_EXPAND, FIELD_CORRELATION, FIELD_DECODE_HEX32, expand.correlation)
+};
+
+#define BUILT_IN_HANDLER_COUNT (sizeof(builtInHandlers) / sizeof(builtInHandlers[0]))
+#define FIELD_DECODER_COUNT (sizeof(fieldDecoders) / sizeof(fieldDecoders[0]))
+
+static void decodeFieldInto(const MsgFieldDecoder& decoder, const char* value, MessageProcessorInfo* info) {
+    auto dest = reinterpret_cast<uint8_t*>(info) + decoder.offset;
+    switch(decoder.decodeType) {
+    case FIELD_DECODE_UINT8:
+        *dest = uint8_t(atoi(value));
+        break;
+    case FIELD_DECODE_UINT16:
+        *reinterpret_cast<uint16_t*>(dest) = uint16_t(atoi(value));
+        break;
+    case FIELD_DECODE_UINT32:
+        *reinterpret_cast<uint32_t*>(dest) = strtoul(value, nullptr, 10);
+        break;
+    case FIELD_DECODE_HEX32:
+        *reinterpret_cast<uint32_t*>(dest) = strtoul(value, nullptr, 16);
+        break;
+    case FIELD_DECODE_CHAR:
+        *dest = uint8_t(value[0]);
+        break;
+    case FIELD_DECODE_DIGIT:
+        *dest = uint8_t(value[0] - '0');
+        break;
+    case FIELD_DECODE_MENU_ITEM:
+        *reinterpret_cast<MenuItem**>(dest) = getMenuItemById(atoi(value));
+        break;
+    }
+}
+
+static bool decodeFieldInRange(uint8_t start, uint8_t count, FieldAndValue* field, MessageProcessorInfo* info) {
+    for(uint8_t i = start; i < start + count; i++) {
+        MsgFieldDecoder decoder;
+        memcpy_P(&decoder, &fieldDecoders[i], sizeof decoder);
+        if(decoder.field == field->field) {
+            decodeFieldInto(decoder, field->value, info);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void findDecoderRange(uint16_t msgType, uint8_t& start, uint8_t& count) {
+    start = count = 0;
+    for(uint8_t i = 0; i < FIELD_DECODER_COUNT; i++) {
+        if(pgm_read_word(&fieldDecoders[i].msgType) != msgType) {
+            if(count != 0) return;
+            continue;
+        }
+        if(count == 0) start = i;
+        count++;
+    }
+}
+
+bool decodeMessageField(FieldAndValue* field, MessageProcessorInfo* info) {
+    if(field->fieldType != FVAL_FIELD) return false;
+    uint8_t start, count;
+    findDecoderRange(field->msgType, start, count);
+    return decodeFieldInRange(start, count, field, info);
+}
+
+CombinedMessageProcessor::CombinedMessageProcessor() : inboundLimit(TC_REMOTE_RATE_PER_SECOND, TC_REMOTE_RATE_BURST) {
     this->currHandler = nullptr;
+    this->decoderStart = this->decoderCount = 0;
+    this->rejectedCorrelation = 0;
+    this->messagesRejected = 0;
+    this->msgCharged = this->msgRejected = this->rejectAckSent = false;
 }
 
 void CombinedMessageProcessor::initialise() {
-    messageHandlers.add(MsgHandler(MSG_CHANGE_INT, fieldUpdateValueMsg));
-    messageHandlers.add(MsgHandler(MSG_JOIN, fieldUpdateJoinMsg));
-    messageHandlers.add(MsgHandler(MSG_PAIR, fieldUpdatePairingMsg));
-    messageHandlers.add(MsgHandler(MSG_DIALOG, fieldUpdateDialogMsg));
-    messageHandlers.add(MsgHandler(MSG_HEARTBEAT, fieldUpdateHeartbeatMsg));
+    // the built in handlers and field decoders are in tables that are fixed at compile time, see above.
 }
 
 void CombinedMessageProcessor::newMsg(uint16_t msgType) {
-    currHandler = messageHandlers.getByKey(msgType);
+    msgCharged = msgRejected = false;
+    decoderStart = decoderCount = 0;
+
+    // custom handlers take priority, and handle all their own fields.
+    auto custom = messageHandlers.getByKey(msgType);
+    if(custom != nullptr) {
+        currHandler = custom->getFieldUpdateFn();
+    } else {
+        currHandler = nullptr;
+        for(uint8_t i = 0; i < BUILT_IN_HANDLER_COUNT; i++) {
+            if(pgm_read_word(&builtInHandlers[i].msgType) == msgType) {
+                memcpy_P(&currHandler, &builtInHandlers[i].fn, sizeof currHandler);
+                findDecoderRange(msgType, decoderStart, decoderCount);
+                break;
+            }
+        }
+    }
 
     if(currHandler != nullptr) {
         memset(&val, 0, sizeof val);
@@ -40,8 +173,38 @@ void CombinedMessageProcessor::newMsg(uint16_t msgType) {
 
 void CombinedMessageProcessor::fieldUpdate(TagValueRemoteConnector* connector, FieldAndValue* field) {
     uint16_t mt = field->msgType;
+
+    // each message other than those that set up or keep alive the connection takes a token when it is first seen, if
+    // there are none left the message is rejected before it is dispatched.
+    if(!msgCharged && mt != MSG_HEARTBEAT && mt != MSG_JOIN && mt != MSG_PAIR) {
+        msgCharged = true;
+        msgRejected = !inboundLimit.take(millis());
+        if(msgRejected) {
+            messagesRejected++;
+            rejectedCorrelation = 0;
+        } else {
+            rejectAckSent = false;
+        }
+    }
+
+    if(msgRejected) {
+        if(field->fieldType == FVAL_END_MSG) {
+            // a remote waiting on a correlation must always be told, otherwise only acknowledge the first rejection in
+            // a run, so a flood of uncorrelated messages does not cause a flood of acknowledgements.
+            if(rejectedCorrelation != 0 || !rejectAckSent) {
+                serlogF2(SER_WARNING, "Rate limited msgs ", messagesRejected);
+                connector->encodeAcknowledgement(rejectedCorrelation, ACK_RATE_LIMITED);
+                rejectAckSent = true;
+            }
+        } else if(field->field == FIELD_CORRELATION) {
+            rejectedCorrelation = strtoul(field->value, nullptr, 16);
+        }
+        return;
+    }
+
     if(currHandler != nullptr && (connector->isAuthenticated() || mt == MSG_JOIN || mt == MSG_PAIR || mt == MSG_HEARTBEAT)) {
-        currHandler->invoke(connector, field, &val);
+        if(field->fieldType == FVAL_FIELD && decodeFieldInRange(decoderStart, decoderCount, field, &val)) return;
+        currHandler(connector, field, &val);
     }
     else if(mt != MSG_HEARTBEAT) {
         serlogF3(SER_WARNING, "Did not proccess(mt,auth)", field->msgType, connector->isAuthenticated());
@@ -49,7 +212,7 @@ void CombinedMessageProcessor::fieldUpdate(TagValueRemoteConnector* connector, F
 }
 
 
-void fieldUpdateHeartbeatMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+static void handleHeartbeatMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
 	if(field->fieldType == FVAL_END_MSG) {
 		if (info->hb.hbMode == HBMODE_ENDCONNECT) {
 			serlogF(SER_NETWORK_INFO, "HB close msg");
@@ -59,14 +222,75 @@ void fieldUpdateHeartbeatMsg(TagValueRemoteConnector* connector, FieldAndValue*
             serlogF(SER_NETWORK_INFO, "HB start msg");
 			connector->encodeJoin();
 		}
-    } else {
-        if(field->field == FIELD_HB_MODE) {
-            info->hb.hbMode = (HeartbeatMode)(atoi(field->value));
+    }
+}
+
+static void handleListPageMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(field->fieldType == FVAL_END_MSG) {
+        if(info->listPage.item == nullptr || info->listPage.item->getMenuType() != MENUTYPE_RUNTIME_LIST) {
+            serlogF(SER_WARNING, "List page for non list item");
+            connector->encodeAcknowledgement(info->listPage.correlation, ACK_ID_NOT_FOUND);
+            return;
         }
+        int count = info->listPage.count == 0 ? TC_REMOTE_LIST_PAGE_SIZE : info->listPage.count;
+        connector->encodeListPage(reinterpret_cast<ListRuntimeMenuItem*>(info->listPage.item), info->listPage.start,
+                                  count, info->listPage.correlation);
     }
 }
 
-void fieldUpdateDialogMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+static void handleValueQueryMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(field->fieldType == FVAL_END_MSG) {
+        connector->encodeValueQueryResponse(info->valueQuery.ids, info->valueQuery.count, info->valueQuery.correlation);
+        return;
+    }
+
+    if(field->field == FIELD_ID) {
+        if(info->valueQuery.count < TC_REMOTE_QUERY_MAX_IDS) {
+            info->valueQuery.ids[info->valueQuery.count++] = atoi(field->value);
+        } else {
+            serlogF2(SER_WARNING, "Query too many IDs ", field->value);
+        }
+    }
+}
+
+static void handleExpandMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(field->fieldType == FVAL_END_MSG) {
+        connector->requestSubMenuExpansion(info->expand.id, info->expand.correlation);
+    }
+}
+
+static void handleGetFormNames(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo*) {
+    if(field->fieldType == FVAL_END_MSG) {
+        connector->encodeFormNames();
+    }
+}
+
+const EmbedControlFlashedForm* findFlashedForm(const char* name) {
+    auto forms = CombinedMessageProcessor::getFormTemplatesInFlash();
+    if(forms == nullptr) return nullptr;
+    for(int i = 0; forms[i] != nullptr; i++) {
+        if(strcmp_P(name, forms[i]->formName) == 0) return forms[i];
+    }
+    return nullptr;
+}
+
+static void handleFormRequest(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(field->fieldType == FVAL_END_MSG) {
+        if(info->formLoad.form == nullptr) {
+            serlogF(SER_WARNING, "Form not found");
+            connector->encodeAcknowledgement(info->formLoad.correlation, ACK_ID_NOT_FOUND);
+            return;
+        }
+        connector->startFormTransfer(info->formLoad.form, info->formLoad.offset, info->formLoad.credits);
+        return;
+    }
+
+    if(field->field == FIELD_MSG_NAME) {
+        info->formLoad.form = findFlashedForm(field->value);
+    }
+}
+
+static void handleDialogMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
 	if(field->fieldType == FVAL_END_MSG && info->dialog.mode == 'A') {
         BaseDialog* dialog = MenuRenderer::getInstance()->getDialog();
         if(dialog) {
@@ -76,24 +300,10 @@ void fieldUpdateDialogMsg(TagValueRemoteConnector* connector, FieldAndValue* fie
         else {
             connector->encodeAcknowledgement(info->dialog.correlation, ACK_UNKNOWN);
         }
-        return;
-    }
-
-    switch(field->field) {
-    case FIELD_BUTTON1:
-        info->dialog.button = field->value[0] - '0';
-        break;
-    case FIELD_MODE:
-        info->dialog.mode = field->value[0];
-        break;
-    case FIELD_CORRELATION:
-        info->dialog.correlation = strtoul(field->value, nullptr, 16);
-        break;
     }
-
 }
 
-void fieldUpdatePairingMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+static void handlePairingMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
 	if(field->fieldType == FVAL_END_MSG) return;
 
     switch(field->field) {
@@ -107,7 +317,7 @@ void fieldUpdatePairingMsg(TagValueRemoteConnector* connector, FieldAndValue* fi
     }
 }
 
-void fieldUpdateJoinMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+static void handleJoinMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
 	if(field->fieldType == FVAL_END_MSG) {
         serlogF2(SER_NETWORK_INFO, "Join from ", info->join.platform);
         serlogF3(SER_NETWORK_INFO, "Remote version was ", info->join.major, info->join.minor);
@@ -118,7 +328,8 @@ void fieldUpdateJoinMsg(TagValueRemoteConnector* connector, FieldAndValue* field
             connector->provideAuthentication(nullptr);
         }
         else {
-            connector->setRemoteConnected(info->join.major, info->join.minor, info->join.platform);
+            connector->setRemoteConnected(info->join.major, info->join.minor, info->join.platform, info->join.joinMode,
+                                          info->join.capabilities);
         }
 		return;
 	}
@@ -140,9 +351,6 @@ void fieldUpdateJoinMsg(TagValueRemoteConnector* connector, FieldAndValue* field
         info->join.authProvided = true;
         break;
     }
-	case FIELD_PLATFORM:
-		info->join.platform = (ApiPlatform) atoi(field->value);
-		break;
 	}
 }
 
@@ -251,7 +459,7 @@ bool processIdChangeField(FieldAndValue* field, MessageProcessorInfo* info) {
     }
 }
 
-void fieldUpdateValueMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+static void handleValueMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
 	if(field->fieldType == FVAL_END_MSG) {
 		// if this is an action item, we trigger the callback to occur just before ending.
 		if(info->value.item != nullptr && info->value.item->getMenuType() == MENUTYPE_ACTION_VALUE) {
@@ -263,9 +471,6 @@ void fieldUpdateValueMsg(TagValueRemoteConnector* connector, FieldAndValue* fiel
     bool ret;
 
 	switch(field->field) {
-    case FIELD_CORRELATION:
-        info->value.correlation = strtoul(field->value, nullptr, 16);
-        break;
 	case FIELD_ID:
         ret = processIdChangeField(field, info);
         if(!ret) connector->encodeAcknowledgement(info->value.correlation, ACK_ID_NOT_FOUND);
@@ -276,8 +481,50 @@ void fieldUpdateValueMsg(TagValueRemoteConnector* connector, FieldAndValue* fiel
             connector->encodeAcknowledgement(info->value.correlation, ret ? ACK_SUCCESS : ACK_VALUE_RANGE);
         }
 		break;
-	case FIELD_CHANGE_TYPE:
-		info->value.changeType = (ChangeType) atoi(field->value);
-		break;
 	}
 }
+
+//
+// The exported handlers decode the fields that are in the table themselves before calling the built in handler, so
+// that processors written before the decoding table, which call them for every field, keep working unchanged.
+//
+
+void fieldUpdateValueMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleValueMsg(connector, field, info);
+}
+
+void fieldUpdateJoinMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleJoinMsg(connector, field, info);
+}
+
+void fieldUpdatePairingMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handlePairingMsg(connector, field, info);
+}
+
+void fieldUpdateDialogMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleDialogMsg(connector, field, info);
+}
+
+void fieldUpdateHeartbeatMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleHeartbeatMsg(connector, field, info);
+}
+
+void fieldUpdateListPageMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleListPageMsg(connector, field, info);
+}
+
+void fieldGetFormNames(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleGetFormNames(connector, field, info);
+}
+
+void fieldHandleFormRequest(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleFormRequest(connector, field, info);
+}
+
+void fieldUpdateValueQueryMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleValueQueryMsg(connector, field, info);
+}
+
+void fieldUpdateExpandMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info) {
+    if(!decodeMessageField(field, info)) handleExpandMsg(connector, field, info);
+}
@@ -21,6 +21,73 @@
 class TagValueRemoteConnector; // forward reference
 struct FieldAndValue; // forward reference
 
+// The default inbound message rate allowed on each connection, messages arriving faster than this once the burst has
+// been used up are rejected. Heartbeats, joins and pairing are never limited. It is 0 by default, which turns off rate
+// limiting, define a rate to turn it on for all connections, or use setInboundRateLimit on a processor.
+#ifndef TC_REMOTE_RATE_PER_SECOND
+#define TC_REMOTE_RATE_PER_SECOND 0
+#endif
+
+// The default number of inbound messages that can arrive in a burst on each connection before rate limiting applies.
+#ifndef TC_REMOTE_RATE_BURST
+#define TC_REMOTE_RATE_BURST 50
+#endif
+
+/**
+ * A simple token bucket that allows a number of events per second with an allowed burst, each event takes a token,
+ * and tokens are added back over time up to the burst size. Tokens are stored in thousandths, so that slow rates
+ * still refill smoothly.
+ */
+class TokenBucket {
+private:
+    uint32_t milliTokens;
+    unsigned long lastRefill;
+    uint16_t ratePerSecond;
+    uint16_t burst;
+public:
+    TokenBucket(uint16_t ratePerSecond, uint16_t burst) : milliTokens(uint32_t(burst) * 1000UL), lastRefill(0),
+                                                          ratePerSecond(ratePerSecond), burst(burst) {}
+
+    /**
+     * Change the rate and burst, the bucket is refilled. A rate of 0 turns off limiting.
+     * @param rate the number of events allowed per second
+     * @param burstSize the number of events that can happen at once
+     */
+    void setLimit(uint16_t rate, uint16_t burstSize) {
+        ratePerSecond = rate;
+        burst = burstSize;
+        milliTokens = uint32_t(burst) * 1000UL;
+    }
+
+    /**
+     * Try to take a token from the bucket, refilling it according to the time elapsed first.
+     * @param now the current time in millis
+     * @return true if a token was available or limiting is off, otherwise false.
+     */
+    bool take(unsigned long now) {
+        if(ratePerSecond == 0) return true;
+        uint32_t maxTokens = uint32_t(burst) * 1000UL;
+        unsigned long elapsed = now - lastRefill;
+        lastRefill = now;
+        uint32_t refill = (elapsed > 60000UL) ? maxTokens : uint32_t(elapsed) * ratePerSecond;
+        milliTokens = (maxTokens - milliTokens) < refill ? maxTokens : milliTokens + refill;
+        if(milliTokens < 1000) return false;
+        milliTokens -= 1000;
+        return true;
+    }
+};
+
+/**
+ * Describes a form that is stored on the device, usually in program memory, which can be streamed to Embed Control
+ * on request. The name and gzipped data can both be in program memory, this structure itself should be in RAM. The
+ * form is streamed to the remote in chunks, see `TagValueRemoteConnector::startFormTransfer`.
+ */
+struct EmbedControlFlashedForm {
+    const char* formName;
+    const uint8_t* formDataGzipped;
+    const uint32_t formDataLen;
+};
+
 /**
  * Message processors need to store some state while they are working through the fields
  * of a message, this union keeps state between a message starting processing and ending
@@ -43,6 +110,8 @@ union MessageProcessorInfo {
 		uint8_t major, minor;
 		ApiPlatform platform;
         bool authProvided;
+        JoinMode joinMode;
+        uint8_t capabilities;
 	} join;
     struct {
         char name[20];
@@ -55,12 +124,29 @@ union MessageProcessorInfo {
     struct {
         HeartbeatMode hbMode;
     } hb;
+    struct {
+        MenuItem* item;
+        uint32_t correlation;
+        uint16_t start;
+        uint16_t count;
+    } listPage;
+    struct {
+        menuid_t id;
+        uint32_t correlation;
+    } expand;
+    struct {
+        menuid_t ids[TC_REMOTE_QUERY_MAX_IDS];
+        uint32_t correlation;
+        uint8_t count;
+    } valueQuery;
     struct {
         uint8_t data[20];
     } custom;
     struct {
-        uint16_t length;
-        const uint8_t* data;
+        const EmbedControlFlashedForm* form;
+        uint32_t offset;
+        uint32_t correlation;
+        uint8_t credits;
     } formLoad;
 };
 
@@ -88,11 +174,53 @@ public:
     MsgHandler(const MsgHandler& other) = default;
     MsgHandler& operator=(const MsgHandler& other) = default;
     uint16_t getKey() const { return msgType; }
+    FieldUpdateFunction getFieldUpdateFn() const { return fieldUpdateFn; }
     void invoke(TagValueRemoteConnector* rc, FieldAndValue* fv, MessageProcessorInfo* info) {
         if(fieldUpdateFn) fieldUpdateFn(rc, fv, info);
     }
 };
 
+/**
+ * How a field value is decoded into MessageProcessorInfo by the field decoding table.
+ */
+enum FieldDecodeType : uint8_t {
+    /** decimal into a uint8_t, also used for the single byte enumerations */
+    FIELD_DECODE_UINT8,
+    /** decimal into a uint16_t, such as a menu id */
+    FIELD_DECODE_UINT16,
+    /** decimal into a uint32_t */
+    FIELD_DECODE_UINT32,
+    /** hexadecimal into a uint32_t, as used for correlations */
+    FIELD_DECODE_HEX32,
+    /** the first character as it is */
+    FIELD_DECODE_CHAR,
+    /** the first character as a digit from 0 to 9 */
+    FIELD_DECODE_DIGIT,
+    /** a decimal menu item id that is looked up and stored as a MenuItem pointer, nullptr when not found */
+    FIELD_DECODE_MENU_ITEM
+};
+
+/**
+ * An entry in the field decoding table, for a message type and field, it says how to decode the value and where it is
+ * stored in MessageProcessorInfo. Fields that are in the table are stored without calling the message handler, so
+ * handlers only see fields that need more than storing, and the end of the message.
+ */
+struct MsgFieldDecoder {
+    uint16_t msgType;
+    uint16_t field;
+    FieldDecodeType decodeType;
+    uint8_t offset;
+};
+
+/**
+ * Decodes a field of an incoming message using the built in field decoding table. The handler functions below call
+ * this themselves, so processors that use them can pass every field and the end of message straight to the handler.
+ * @param field the field that has been received
+ * @param info the message state to decode into
+ * @return true if the field was in the table and has been stored, otherwise false.
+ */
+bool decodeMessageField(FieldAndValue* field, MessageProcessorInfo* info);
+
 /**
  * If you decide to write your own processor, this method can handle join messages
  */
@@ -118,19 +246,32 @@ void fieldUpdateDialogMsg(TagValueRemoteConnector* connector, FieldAndValue* fie
  */
 void fieldUpdateHeartbeatMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
 /**
- * If you decide to write your own processor, this method can handle get form names requests
+ * If you decide to write your own processor, this method can handle list page requests, where the remote asks for
+ * a window of rows from a runtime list.
+ */
+void fieldUpdateListPageMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+
+/**
+ * If you decide to write your own processor, this method can handle get form names requests, it responds with the
+ * names of all forms registered with `CombinedMessageProcessor::setFormTemplatesInFlash`.
  */
 void fieldGetFormNames(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
 /**
- * If you decide to write your own processor, this method can handle get form data requests
+ * If you decide to write your own processor, this method can handle get form data requests, the remote provides the
+ * form name, the offset to start (or resume) from, and how many chunks it is ready to receive. The chunks are then
+ * streamed by the connector between other messages.
  */
 void fieldHandleFormRequest(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
-
-struct EmbedControlFlashedForm {
-    const char* formName;
-    const uint8_t* formDataGzipped;
-    const uint16_t formDataLen;
-};
+/**
+ * If you decide to write your own processor, this method can handle value queries, where the remote provides a list
+ * of item IDs (as repeated ID fields) and the device responds with all their values in a single message.
+ */
+void fieldUpdateValueQueryMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
+/**
+ * If you decide to write your own processor, this method can handle submenu expand requests, where a remote that
+ * joined with lazy bootstrap asks for the children of a submenu.
+ */
+void fieldUpdateExpandMsg(TagValueRemoteConnector* connector, FieldAndValue* field, MessageProcessorInfo* info);
 
 /**
  * This message processor is responsible for handling messages coming off the wire and processing them into
@@ -138,7 +279,9 @@ struct EmbedControlFlashedForm {
  * full.
  * 
  * When a new message arrives, this class attempts to find a suitable processor function (or ignore if we
- * can't process), then each field in the message is passed to the function to processed.
+ * can't process), then each field in the message is passed to the function to processed. The built in messages are
+ * held in tables that are fixed at compile time, one maps each message type to its handler, and the other maps each
+ * message type and field to a decoder that stores the value straight into MessageProcessorInfo.
  *
  * You can customize a message process by adding your own additional message types that it can process using the
  * addCustomMsgHandler(..) function.
@@ -147,9 +290,21 @@ class CombinedMessageProcessor {
 private:
 	MessageProcessorInfo val;
     BtreeList<uint16_t, MsgHandler> messageHandlers;
-	MsgHandler* currHandler;
+	FieldUpdateFunction currHandler;
+    uint8_t decoderStart;
+    uint8_t decoderCount;
+    TokenBucket inboundLimit;
+    uint32_t rejectedCorrelation;
+    uint32_t messagesRejected;
+    bool msgCharged;
+    bool msgRejected;
+    bool rejectAckSent;
     static const EmbedControlFlashedForm** flashedFormTemplates;
 public:
+    /**
+     * Set the forms that can be streamed to the remote, this is a nullptr terminated array of form pointers.
+     * @param formTemplatesInFlash the forms that are available, terminated by nullptr.
+     */
     static void setFormTemplatesInFlash(const EmbedControlFlashedForm** formTemplatesInFlash) { flashedFormTemplates = formTemplatesInFlash; }
     static const EmbedControlFlashedForm** getFormTemplatesInFlash() { return flashedFormTemplates; }
 
@@ -159,7 +314,8 @@ public:
 	CombinedMessageProcessor();
 
     /**
-     * Called by the remote server component to initialise the message handlers before use.
+     * Called by the remote server component to initialise the message handlers before use. The built in handlers are
+     * in a table fixed at compile time, so there is nothing to set up for them.
      */
     void initialise();
 
@@ -172,9 +328,27 @@ public:
 	 */
 	void fieldUpdate(TagValueRemoteConnector* connector, FieldAndValue* field);
 
+    /**
+     * Set the rate at which inbound messages are accepted on this connection, messages beyond the burst that arrive
+     * faster than this are rejected before being dispatched. Every rejected message that has a correlation is sent an
+     * ACK_RATE_LIMITED acknowledgement, those without one are only acknowledged once for each run of rejections.
+     * Heartbeats, joins and pairing are never limited, so a remote can always connect. Limiting is off by default,
+     * see TC_REMOTE_RATE_PER_SECOND.
+     * @param messagesPerSecond the number of messages allowed per second, 0 turns off limiting
+     * @param burst the number of messages that can arrive at once
+     */
+    void setInboundRateLimit(uint16_t messagesPerSecond, uint16_t burst) { inboundLimit.setLimit(messagesPerSecond, burst); }
+
+    /**
+     * @return the number of inbound messages that have been rejected due to rate limiting.
+     */
+    uint32_t getMessagesRejected() const { return messagesRejected; }
+
     /**
      * If you want to be able to process a custom incoming message, simply add it here as a MsgHandler, see above.
-     * It can be a local, even inline object as it will be copy constructed to an internal list.
+     * It can be a local, even inline object as it will be copy constructed to an internal list. Custom handlers are
+     * checked before the built in ones, so a built in message can be replaced, in which case its fields are not
+     * decoded by the table and all of them are passed to your function.
      * Step 1. You define a custom message type using something similar to
      *
      *      `#define MSG_CUSTOM msgFieldToWord('Z','Z')`
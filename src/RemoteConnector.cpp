@@ -40,7 +40,10 @@ void stopPairing();
 
 TagValueRemoteConnector::TagValueRemoteConnector(uint8_t remoteNo) :
         bootPredicate(MENUTYPE_BACK_VALUE, TM_INVERTED_LOCAL_ONLY),
-        remotePredicate(remoteNo), remoteName{}, remoteMajorVer(0), remoteMinorVer(0),
+        remotePredicate(remoteNo), formTransfer(nullptr), formOffset(0), formCredits(0),
+        expandNext(nullptr), expandQueue{}, expandQueueCount(0), expandedMenus{}, expandedMenuCount(0), binaryStreamId(0), binaryStreamEnd(BINSTREAM_COMPLETE),
+        keyframeTicks(0), ticksSinceKeyframe(0), publishOnly(false),
+        remoteName{}, remoteMajorVer(0), remoteMinorVer(0),
         remotePlatform(PLATFORM_ARDUINO_8BIT) {
 	this->transport = nullptr;
 	this->processor = nullptr;
@@ -70,14 +73,22 @@ void TagValueRemoteConnector::setRemoteName(const char* name) {
 	remoteName[sizeof(remoteName)-1]=0;
 }
 
-void TagValueRemoteConnector::setRemoteConnected(uint8_t major, uint8_t minor, ApiPlatform platform) {
+void TagValueRemoteConnector::setRemoteConnected(uint8_t major, uint8_t minor, ApiPlatform platform, JoinMode joinMode,
+                                                  uint8_t capabilities) {
     if(isAuthenticated()) {
-        serlogF(SER_NETWORK_INFO, "Fully authenticated connection");
+        serlogF2(SER_NETWORK_INFO, "Fully authenticated connection, mode ", joinMode);
         remoteMajorVer = major;
         remoteMinorVer = minor;
         remotePlatform = platform;
 		setFullyJoinedRx(true);
-        initiateBootstrap();
+        bitWrite(flags, FLAG_LIST_PAGING, (capabilities & JOINCAP_LIST_PAGING) != 0);
+        if(joinMode == JOINMODE_QUERY_ONLY) {
+            // neither bootstrap nor stream changes, the remote will ask for what it needs.
+            bitWrite(flags, FLAG_QUERY_ONLY, true);
+        } else {
+            bitWrite(flags, FLAG_LAZY_BOOT, joinMode == JOINMODE_LAZY_BOOT);
+            initiateBootstrap();
+        }
     }
     else {
         serlogF(SER_NETWORK_INFO, "Not authenticated, dropping");
@@ -171,8 +182,19 @@ void TagValueRemoteConnector::close() {
 
 }
 
-void TagValueRemoteConnector::tick() {
-    dealWithHeartbeating();
+void TagValueRemoteConnector::tick(uint16_t elapsedTicks) {
+    // a chunked binary message is being written, nothing else can be written until it completes.
+    if(bitRead(flags, FLAG_BINARY_STREAMING)) {
+        tickBinaryStream(elapsedTicks);
+        return;
+    }
+
+    if(publishOnly) {
+        tickPublishOnly(elapsedTicks);
+        return;
+    }
+
+    dealWithHeartbeating(elapsedTicks);
 
 	if(isConnected() && transport->connected() && isAuthenticated()) {
 		performAnyWrites();
@@ -209,10 +231,88 @@ void TagValueRemoteConnector::tick() {
 	}
 }
 
+void TagValueRemoteConnector::tickBinaryStream(uint16_t elapsedTicks) {
+    // nothing can be read or sent until the stream ends, the writer resets ticksLastSend on every chunk, so reads are
+    // not timed out here, only a transport that has gone away, or a writer that has stopped writing.
+    if(!transport->connected()) {
+        serlogF2(SER_NETWORK_INFO, "Disconnected during binary stream ", remoteNo);
+        setConnected(false);
+        return;
+    }
+
+    ticksLastSend = (ticksLastSend > 0xffff - elapsedTicks) ? 0xffff : ticksLastSend + elapsedTicks;
+    if(ticksLastSend > hbTimeoutTicks) {
+        serlogF2(SER_WARNING, "Binary stream not finished, ending ", remoteNo);
+        abandonBinaryStream(BINSTREAM_TIMED_OUT);
+        transport->writeBinChunk(nullptr, 0);
+        transport->endMsg();
+        ticksLastRead = 0;
+    }
+}
+
+void TagValueRemoteConnector::abandonBinaryStream(BinaryStreamStatus reason) {
+    if(bitRead(flags, FLAG_BINARY_STREAMING)) binaryStreamEnd = reason;
+    bitWrite(flags, FLAG_BINARY_STREAMING, false);
+}
+
+BinaryStreamStatus TagValueRemoteConnector::binaryStreamStatus(uint8_t id) const {
+    // a newer stream can only have started once this one was ended by the connector, the reason has been replaced.
+    if(id != binaryStreamId) return BINSTREAM_TIMED_OUT;
+    return bitRead(flags, FLAG_BINARY_STREAMING) ? BINSTREAM_COMPLETE : binaryStreamEnd;
+}
+
+void TagValueRemoteConnector::binaryStreamFinished() {
+    bitWrite(flags, FLAG_BINARY_STREAMING, false);
+}
+
+void TagValueRemoteConnector::enablePublishOnly(uint16_t keyframeMillis) {
+    publishOnly = true;
+    keyframeTicks = keyframeMillis / TICK_INTERVAL;
+}
+
+void TagValueRemoteConnector::tickPublishOnly(uint16_t elapsedTicks) {
+    // nothing is ever read, so there is no read timeout, the transport alone decides if we are connected.
+    if(!transport->connected()) {
+        if(isConnected()) setConnected(false);
+        return;
+    }
+
+    if(!isConnected()) {
+        serlogF2(SER_NETWORK_INFO, "Publishing on ", remoteNo);
+        setConnected(true);
+        setAuthenticated(true);
+        setFullyJoinedRx(true);
+        setFullyJoinedTx(true);
+    }
+
+    ticksLastSend = (ticksLastSend > 0xffff - elapsedTicks) ? 0xffff : ticksLastSend + elapsedTicks;
+    ticksSinceKeyframe = (ticksSinceKeyframe > 0xffff - elapsedTicks) ? 0xffff : ticksSinceKeyframe + elapsedTicks;
+
+    // a keyframe is a join followed by a bootstrap, so listeners that have just started know which device this is. Any
+    // changes already flagged for this remote are still sent once the bootstrap completes.
+    bool keyframeDue = isBootstrapComplete() ? (keyframeTicks != 0 && ticksSinceKeyframe >= keyframeTicks) : !isBootstrapMode();
+    if(keyframeDue && transport->available()) {
+        encodeJoin();
+        initiateBootstrap();
+        ticksSinceKeyframe = 0;
+    }
+
+    if(ticksLastSend > hbTimeoutTicks && transport->available()) {
+        encodeHeartbeat(HBMODE_NORMAL);
+    }
+
+    performAnyWrites();
+}
+
 void TagValueRemoteConnector::setConnected(bool conn) {
     if(!conn) {
         this->ticksLastRead = this->ticksLastSend = 0xffff;
+        abandonBinaryStream(BINSTREAM_DISCONNECTED);
         flags = 0; // clear all flags on disconnect.
+        formTransfer = nullptr;
+        expandNext = nullptr;
+        expandQueueCount = 0;
+        expandedMenuCount = 0;
     }
     else {
         bitWrite(flags, FLAG_CURRENTLY_CONNECTED, true);
@@ -221,9 +321,10 @@ void TagValueRemoteConnector::setConnected(bool conn) {
     commsNotify(conn ? COMMSERR_CONNECTED : COMMSERR_DISCONNECTED);
 }
 
-void TagValueRemoteConnector::dealWithHeartbeating() {
-	++ticksLastRead;
-	++ticksLastSend;
+void TagValueRemoteConnector::dealWithHeartbeating(uint16_t elapsedTicks) {
+    // a connection that has not been serviced for a long time can report up to 0xffff ticks, which must not wrap.
+    ticksLastRead = (ticksLastRead > 0xffff - elapsedTicks) ? 0xffff : ticksLastRead + elapsedTicks;
+    ticksLastSend = (ticksLastSend > 0xffff - elapsedTicks) ? 0xffff : ticksLastSend + elapsedTicks;
 
     // when pairing the timeout is hardwired to 15 seconds, otherwise we wait a multiplier of the heartbeat frequency
     unsigned int maximumWaitTime = isPairing() ? (PAIRING_TIMEOUT_TICKS) : (hbTimeoutTicks > 10000) ? hbTimeoutTicks * 2U : hbTimeoutTicks * 3U;
@@ -236,6 +337,8 @@ void TagValueRemoteConnector::dealWithHeartbeating() {
 
     if(!isConnected() && transport->connected()) {
         serlogF2(SER_NETWORK_INFO, "Remote connected: ", remoteNo);
+        // the counts are held at their maximum while disconnected, the read timeout starts from the connection.
+        ticksLastRead = 0;
         encodeHeartbeat(HBMODE_STARTCONNECT);
 		setConnected(true);
 	}
@@ -252,25 +355,221 @@ void TagValueRemoteConnector::performAnyWrites() {
 	if(isBootstrapMode()) {
 		nextBootstrap();
 	}
-	else if(isBootstrapComplete()) {
-        MenuItem* item = iterator.nextItem();
-        if(item && MENUTYPE_SUB_VALUE != item->getMenuType()) {
-            item->setSendRemoteNeeded(remoteNo, false);
-            encodeChangeValue(item);
+	else if(isBootstrapComplete() || isQueryOnly()) {
+        // query only remotes are never sent changes or dialogs, they only get what they ask for.
+        if(!isQueryOnly()) {
+            // a lazy remote only knows about the submenus it has expanded, anything else it gets when expanding.
+            MenuItem* item = iterator.nextItem();
+            if(item && MENUTYPE_SUB_VALUE != item->getMenuType()) {
+                item->setSendRemoteNeeded(remoteNo, false);
+                if(isKnownToRemote(iterator.currentParent())) encodeChangeValue(item);
+            }
+
+            BaseDialog* dlg = MenuRenderer::getInstance()->getDialog();
+            if(dlg!=nullptr && dlg->isRemoteUpdateNeeded(remoteNo)) {
+                dlg->encodeMessage(this);
+                dlg->setRemoteUpdateNeeded(remoteNo, false);
+            }
+        }
+
+        if(formTransfer != nullptr && formCredits != 0) {
+            nextFormChunk();
+        }
+
+        if(expandQueueCount != 0) {
+            nextExpansion();
+        }
+    }
+}
+
+void TagValueRemoteConnector::requestSubMenuExpansion(menuid_t subMenuId, uint32_t correlation) {
+    MenuItem* item = getMenuItemById(subMenuId);
+    if(item == nullptr || item->getMenuType() != MENUTYPE_SUB_VALUE || item->isLocalOnly()) {
+        encodeAcknowledgement(correlation, ACK_ID_NOT_FOUND);
+        return;
+    }
+    if(expandQueueCount >= TC_REMOTE_EXPAND_QUEUE_SIZE) {
+        serlogF2(SER_WARNING, "Expand queue full ", subMenuId);
+        encodeAcknowledgement(correlation, ACK_UNKNOWN);
+        return;
+    }
+    expandQueue[expandQueueCount].id = subMenuId;
+    expandQueue[expandQueueCount].correlation = correlation;
+    expandQueueCount++;
+}
+
+void TagValueRemoteConnector::nextExpansion() {
+	if(!transport->available()) return; // skip a turn, no write available.
+
+    if(!bitRead(flags, FLAG_EXPANDING)) {
+        // start on the submenu at the head of the queue
+        auto sub = reinterpret_cast<SubMenuItem*>(getMenuItemById(expandQueue[0].id));
+        expandNext = sub != nullptr ? sub->getChild() : nullptr;
+        bitWrite(flags, FLAG_EXPANDING, true);
+        // from here changes are sent, so that a change to an item that has already been sent is not missed.
+        markExpanded(expandQueue[0].id);
+    }
+
+    MenuItem* item = nextLazyItem();
+    if(item != nullptr) {
+        item->setSendRemoteNeeded(remoteNo, false);
+        encodeBootItem(expandQueue[0].id, item);
+        return;
+    }
+
+    // the submenu is complete, tell the remote and move onto the next in the queue.
+    encodeAcknowledgement(expandQueue[0].correlation, ACK_SUCCESS);
+    bitWrite(flags, FLAG_EXPANDING, false);
+    expandQueueCount--;
+    for(uint8_t i = 0; i < expandQueueCount; i++) expandQueue[i] = expandQueue[i + 1];
+}
+
+void TagValueRemoteConnector::markExpanded(menuid_t subMenuId) {
+    for(uint8_t i = 0; i < expandedMenuCount; i++) {
+        if(expandedMenus[i] == subMenuId) return;
+    }
+    if(expandedMenuCount < TC_REMOTE_EXPANDED_MENUS_SIZE) {
+        expandedMenus[expandedMenuCount++] = subMenuId;
+    } else {
+        serlogF2(SER_WARNING, "Expanded menus full, sending all ", remoteNo);
+        bitWrite(flags, FLAG_EXPANDED_OVERFLOW, true);
+    }
+}
+
+bool TagValueRemoteConnector::isKnownToRemote(MenuItem* parent) {
+    if(parent == nullptr || !bitRead(flags, FLAG_LAZY_BOOT) || bitRead(flags, FLAG_EXPANDED_OVERFLOW)) return true;
+    for(uint8_t i = 0; i < expandedMenuCount; i++) {
+        if(expandedMenus[i] == parent->getId()) return true;
+    }
+    return false;
+}
+
+MenuItem* TagValueRemoteConnector::nextLazyItem() {
+    while(expandNext != nullptr && !bootPredicate.matches(expandNext)) expandNext = expandNext->getNext();
+    MenuItem* item = expandNext;
+    if(item != nullptr) expandNext = item->getNext();
+    return item;
+}
+
+void TagValueRemoteConnector::startFormTransfer(const EmbedControlFlashedForm* form, uint32_t offset, uint8_t credits) {
+    if(offset > form->formDataLen) offset = form->formDataLen;
+    formTransfer = form;
+    formOffset = offset;
+    formCredits = credits;
+    serlogF3(SER_NETWORK_INFO, "Form transfer (offs, credits) ", offset, credits);
+}
+
+void TagValueRemoteConnector::nextFormChunk() {
+	if(!transport->available()) return; // skip a turn, no write available.
+
+    // A form chunk is a binary message as follows:
+    // Offset of this chunk (hi first) - 4 bytes
+    // Total length of form (hi first) - 4 bytes
+    // DATA of the remaining length
+    uint32_t total = formTransfer->formDataLen;
+    uint32_t remaining = total - formOffset;
+    uint16_t chunkLen = remaining > TC_REMOTE_FORM_CHUNK_SIZE ? TC_REMOTE_FORM_CHUNK_SIZE : remaining;
+
+    if(!transport->connected()) {
+        logMessageHeader("Wr ErrB ", remoteNo, MSG_FORM_CHUNK);
+        commsNotify(COMMSERR_WRITE_NOT_CONNECTED);
+        setConnected(false);
+        return;
+    }
+    transport->startBinMsg(MSG_FORM_CHUNK, chunkLen + 8);
+    ticksLastSend = 0;
+    for(int i = 24; i >= 0; i -= 8) transport->writeChar(char((formOffset >> i) & 0xff));
+    for(int i = 24; i >= 0; i -= 8) transport->writeChar(char((total >> i) & 0xff));
+    const uint8_t* data = formTransfer->formDataGzipped + formOffset;
+    for(uint16_t i = 0; i < chunkLen; i++) {
+        transport->writeChar(char(pgm_read_byte(&data[i])));
+    }
+    transport->endMsg();
+
+    formOffset += chunkLen;
+    formCredits--;
+    if(formOffset >= total) {
+        serlogF2(SER_NETWORK_INFO, "Form transfer complete ", total);
+        formTransfer = nullptr;
+        formCredits = 0;
+    }
+}
+
+/**
+ * Copies the value of an item into the buffer in the same format that is used by value change messages.
+ * @return true if the item has a value that can be sent, otherwise false
+ */
+bool copyRemoteValueText(MenuItem* item, char* sz, size_t len) {
+    sz[0] = 0;
+    switch(item->getMenuType()) {
+    case MENUTYPE_ENUM_VALUE:
+    case MENUTYPE_INT_VALUE:
+    case MENUTYPE_BOOLEAN_VALUE:
+        ltoaClrBuff(sz, ((ValueMenuItem*)item)->getCurrentValue(), 5, NOT_PADDED, len);
+        return true;
+    case MENUTYPE_COLOR_VALUE:
+        reinterpret_cast<Rgb32MenuItem*>(item)->getUnderlying()->asHtmlString(sz, len, true);
+        return true;
+    case MENUTYPE_SCROLLER_VALUE:
+        reinterpret_cast<ScrollChoiceMenuItem*>(item)->copyTransportText(sz, len);
+        return true;
+    case MENUTYPE_IPADDRESS:
+    case MENUTYPE_TIME:
+    case MENUTYPE_DATE:
+    case MENUTYPE_LARGENUM_VALUE:
+    case MENUTYPE_TEXT_VALUE:
+        ((RuntimeMenuItem*)item)->copyValue(sz, len);
+        return true;
+    case MENUTYPE_FLOAT_VALUE:
+        fastftoa(sz, ((FloatMenuItem*)item)->getFloatValue(), ((FloatMenuItem*)item)->getDecimalPlaces(), len);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void TagValueRemoteConnector::encodeValueQueryResponse(const menuid_t* ids, uint8_t count, uint32_t correlation) {
+    if(!prepareWriteMsg(MSG_VALUE_RESPONSE)) return;
+    char sz[32];
+    sz[0]=0;
+    intToHexString(sz, sizeof sz, correlation, 8, false);
+    transport->writeField(FIELD_CORRELATION, sz);
+    transport->writeFieldInt(FIELD_NO_CHOICES, count);
+    for(uint8_t i = 0; i < count; i++) {
+        char row = char('A' + i);
+        transport->writeFieldInt(msgFieldToWord(FIELD_PREPEND_QUERY_ID, row), ids[i]);
+        MenuItem* item = getMenuItemById(ids[i]);
+        if(item != nullptr && copyRemoteValueText(item, sz, sizeof sz)) {
+            transport->writeField(msgFieldToWord(FIELD_PREPEND_QUERY_VAL, row), sz);
         }
+    }
+    transport->endMsg();
+}
 
-        BaseDialog* dlg = MenuRenderer::getInstance()->getDialog();
-        if(dlg!=nullptr && dlg->isRemoteUpdateNeeded(remoteNo)) {
-            dlg->encodeMessage(this);
-            dlg->setRemoteUpdateNeeded(remoteNo, false);
+void TagValueRemoteConnector::encodeFormNames() {
+    if(!prepareWriteMsg(MSG_FORM_NAMES)) return;
+    auto forms = CombinedMessageProcessor::getFormTemplatesInFlash();
+    int count = 0;
+    if(forms != nullptr) {
+        char sz[32];
+        while(forms[count] != nullptr && count < 26) {
+            safeProgCpy(sz, forms[count]->formName, sizeof sz);
+            transport->writeField(msgFieldToWord(FIELD_PREPEND_CHOICE, 'A' + count), sz);
+            count++;
         }
     }
+    transport->writeFieldInt(FIELD_NO_CHOICES, count);
+    transport->endMsg();
 }
 
 void TagValueRemoteConnector::initiateBootstrap() {
     serlogF2(SER_NETWORK_INFO, "Starting bootstrap", remoteNo);
     iterator.reset();
     iterator.setPredicate(&bootPredicate);
+    // in lazy mode only the root level is sent, the children of each submenu are sent when the remote asks.
+    expandNext = bitRead(flags, FLAG_LAZY_BOOT) ? menuMgr.getRoot() : nullptr;
+    expandedMenuCount = 0;
+    bitWrite(flags, FLAG_EXPANDED_OVERFLOW, false);
 	encodeBootstrap(false);
 	setBootstrapMode(true);
     setBootstrapComplete(false);
@@ -279,8 +578,9 @@ void TagValueRemoteConnector::initiateBootstrap() {
 void TagValueRemoteConnector::nextBootstrap() {
 	if(!transport->available()) return; // skip a turn, no write available.
 
-    MenuItem* bootItem = iterator.nextItem();
-	MenuItem* parent = iterator.currentParent() ;
+    bool lazy = bitRead(flags, FLAG_LAZY_BOOT);
+    MenuItem* bootItem = lazy ? nextLazyItem() : iterator.nextItem();
+	MenuItem* parent = lazy ? nullptr : iterator.currentParent();
     int parentId = parent == nullptr ? 0 : parent->getId();
 	if(!bootItem) {
         serlogF2(SER_NETWORK_INFO, "Finishing bootstrap", remoteNo);
@@ -294,6 +594,10 @@ void TagValueRemoteConnector::nextBootstrap() {
 	}
 
 	bootItem->setSendRemoteNeeded(remoteNo, false);
+    encodeBootItem(parentId, bootItem);
+}
+
+void TagValueRemoteConnector::encodeBootItem(int parentId, MenuItem* bootItem) {
 	switch(bootItem->getMenuType()) {
 	case MENUTYPE_SUB_VALUE:
 		encodeSubMenu(parentId, (SubMenuItem*)bootItem);
@@ -419,6 +723,73 @@ void TagValueRemoteConnector::encodeCustomBinaryMessage(uint16_t msgType, uint16
     serlogF2(SER_NETWORK_INFO, "Bin write complete", msgType);
 }
 
+bool TagValueRemoteConnector::beginCustomBinaryStream(uint16_t msgType, ChunkedBinaryWriter& writer) {
+    if(!transport->connected() || bitRead(flags, FLAG_BINARY_STREAMING)) {
+        logMessageHeader("Wr ErrB ", remoteNo, msgType);
+        return false;
+    }
+    transport->startChunkedBinMsg(msgType);
+    ticksLastSend = 0;
+    bitWrite(flags, FLAG_BINARY_STREAMING, true);
+    logMessageHeader("Bin Stream ", remoteNo, msgType);
+    binaryStreamId++;
+    writer.begin(this, transport, binaryStreamId);
+    return true;
+}
+
+void ChunkedBinaryWriter::begin(TagValueRemoteConnector* conn, TagValueTransport* tx, uint8_t id) {
+    connector = conn;
+    transport = tx;
+    streamId = id;
+    used = 0;
+}
+
+ChunkedBinaryWriter::~ChunkedBinaryWriter() {
+    // the connector may already be gone, so it is not touched here, an open stream is ended by its timeout.
+    if(transport != nullptr) {
+        serlogF(SER_ERROR, "Binary writer destroyed without finish");
+    }
+}
+
+bool ChunkedBinaryWriter::isStarted() const {
+    return transport != nullptr && connector->isBinaryStreamOpen(streamId);
+}
+
+void ChunkedBinaryWriter::detach() {
+    transport = nullptr;
+    connector = nullptr;
+    used = 0;
+}
+
+size_t ChunkedBinaryWriter::write(const uint8_t* data, size_t len) {
+    if(!isStarted()) return 0;
+    for(size_t i = 0; i < len; i++) {
+        buffer[used++] = data[i];
+        if(used == sizeof(buffer)) flushChunk();
+    }
+    return len;
+}
+
+void ChunkedBinaryWriter::flushChunk() {
+    if(used == 0) return;
+    transport->writeBinChunk(buffer, used);
+    connector->binaryChunkWritten();
+    used = 0;
+}
+
+BinaryStreamStatus ChunkedBinaryWriter::finish() {
+    if(transport == nullptr) return BINSTREAM_NOT_STARTED;
+    auto status = connector->binaryStreamStatus(streamId);
+    if(status == BINSTREAM_COMPLETE) {
+        flushChunk();
+        transport->writeBinChunk(nullptr, 0);
+        transport->endMsg();
+        connector->binaryStreamFinished();
+    }
+    detach();
+    return status;
+}
+
 void TagValueRemoteConnector::encodeBaseMenuFields(int parentId, MenuItem* item) {
     transport->writeFieldInt(FIELD_PARENT, parentId);
     transport->writeFieldInt(FIELD_ID, item->getId());
@@ -522,10 +893,14 @@ void TagValueRemoteConnector::encodeFloatMenu(int parentId, FloatMenuItem* item)
     transport->endMsg();
 }
 
-void runtimeSendList(ListRuntimeMenuItem* item, TagValueTransport* transport) {
+/**
+ * Writes rows from a list onto the transport, rows are rendered one at a time through the list's rendering function
+ * so that memory use does not grow with the size of the list. The choice keys are relative to the first row written.
+ */
+void runtimeSendListRows(ListRuntimeMenuItem* item, TagValueTransport* transport, int start, int count) {
 	char sz[25];
-	for (int i = 0; i < item->getNumberOfParts(); i++) {
-		item->getChildItem(i);
+	for (int i = 0; i < count; i++) {
+		item->getChildItem(start + i);
 		item->copyValue(sz, sizeof(sz));
 		transport->writeField(msgFieldToWord(FIELD_PREPEND_CHOICE, 'A' + i), sz);
 		item->copyNameToBuffer(sz, sizeof(sz));
@@ -534,11 +909,37 @@ void runtimeSendList(ListRuntimeMenuItem* item, TagValueTransport* transport) {
 	item->asParent();
 }
 
+/**
+ * Writes a window of at most one page of rows from a list, the start row is written as a field so the other side
+ * can place the rows correctly. Only used with remotes that support list paging.
+ */
+void runtimeSendListPage(ListRuntimeMenuItem* item, TagValueTransport* transport, int start, int count) {
+	int rows = item->getNumberOfParts();
+	if(start > rows) start = rows;
+	if(count > TC_REMOTE_LIST_PAGE_SIZE) count = TC_REMOTE_LIST_PAGE_SIZE;
+	if((start + count) > rows) count = rows - start;
+
+	transport->writeFieldInt(FIELD_LIST_START, start);
+	runtimeSendListRows(item, transport, start, count);
+}
+
+/**
+ * Writes the first page of a list when the remote supports paging, otherwise every row is written without a start
+ * field, as remotes that predate paging expect.
+ */
+void runtimeSendList(ListRuntimeMenuItem* item, TagValueTransport* transport, bool paging) {
+	if(paging) {
+		runtimeSendListPage(item, transport, 0, TC_REMOTE_LIST_PAGE_SIZE);
+	} else {
+		runtimeSendListRows(item, transport, 0, item->getNumberOfParts());
+	}
+}
+
 void TagValueRemoteConnector::encodeRuntimeMenuItem(int parentId, RuntimeMenuItem * item) {
 	if (!prepareWriteMsg(MSG_BOOT_LIST)) return;
 	transport->writeFieldInt(FIELD_NO_CHOICES, item->getNumberOfParts());
 	if (item->getMenuType() == MENUTYPE_RUNTIME_LIST) {
-		runtimeSendList(reinterpret_cast<ListRuntimeMenuItem*>(item), transport);
+		runtimeSendList(reinterpret_cast<ListRuntimeMenuItem*>(item), transport, isListPaging());
 	}
 	else {
 		char sz[25];
@@ -599,6 +1000,13 @@ void TagValueRemoteConnector::encodeActionMenu(int parentId, ActionMenuItem* ite
 bool TagValueRemoteConnector::beginEncodeChange(MenuItem* item) {
     if(!prepareWriteMsg(MSG_CHANGE_INT)) return false;
     transport->writeFieldInt(FIELD_ID, item->getId());
+#if TC_MENU_CHANGE_TIMESTAMPS != 0
+    // the device millis when the change happened, in the same time base as heartbeat millis. Not sent when the item
+    // has not changed since start up, as the time is unknown.
+    if(item->getLastChangeMillis() != 0) {
+        transport->writeFieldLong(FIELD_TIMESTAMP, (long)item->getLastChangeMillis());
+    }
+#endif
     return true;
 }
 
@@ -647,7 +1055,8 @@ void TagValueRemoteConnector::encodeChangeValue(MenuItem* theItem) {
 	case MENUTYPE_RUNTIME_LIST:
         if(!beginEncodeChange(theItem)) return;
         transport->writeFieldInt(FIELD_CHANGE_TYPE, CHANGE_LIST); // menu host always sends absolute!
-		runtimeSendList(reinterpret_cast<ListRuntimeMenuItem*>(theItem), transport);
+        transport->writeFieldInt(FIELD_NO_CHOICES, reinterpret_cast<ListRuntimeMenuItem*>(theItem)->getNumberOfParts());
+		runtimeSendList(reinterpret_cast<ListRuntimeMenuItem*>(theItem), transport, isListPaging());
         transport->endMsg();
 		break;
 	case MENUTYPE_FLOAT_VALUE:
@@ -663,6 +1072,19 @@ void TagValueRemoteConnector::encodeChangeValue(MenuItem* theItem) {
     }
 }
 
+void TagValueRemoteConnector::encodeListPage(ListRuntimeMenuItem* item, int start, int count, uint32_t correlation) {
+    if(!beginEncodeChange(item)) return;
+    transport->writeFieldInt(FIELD_CHANGE_TYPE, CHANGE_LIST);
+    transport->writeFieldInt(FIELD_NO_CHOICES, item->getNumberOfParts());
+    char sz[10];
+    sz[0]=0;
+    intToHexString(sz, sizeof sz, correlation, 8, false);
+    transport->writeField(FIELD_CORRELATION, sz);
+    runtimeSendListPage(item, transport, start, count);
+    transport->endMsg();
+    serlogF4(SER_NETWORK_DEBUG, "List page sent ", item->getId(), start, count);
+}
+
 //
 // Base transport capabilities
 //
@@ -711,7 +1133,71 @@ void TagValueTransport::startBinMsg(uint16_t msgType, uint16_t byteLen) {
     writeChar(lowByte(byteLen));
 }
 
-void TagValueTransport::writeField(uint16_t field, const char* value) {
+void TagValueTransport::startChunkedBinMsg(uint16_t msgType) {
+    // A chunked binary message is formed as follows:
+    // 0x01 1 byte
+    // 0x03 1 byte
+    // Message Type - 2 bytes
+    // Repeated chunks: Length (hi first) - 2 bytes, then DATA of size Length
+    // A chunk of zero length ends the data, followed by the usual end of message.
+    writeChar(START_OF_MESSAGE);
+    writeChar(BINARY_CHUNKED_PROTOCOL);
+    writeChar(char(msgType >> 8));
+    writeChar(char(msgType & 0xff));
+}
+
+void TagValueTransport::writeBinChunk(const uint8_t* data, uint16_t len) {
+    writeChar(highByte(len));
+    writeChar(lowByte(len));
+    for(uint16_t i = 0; i < len; i++) {
+        writeChar(char(data[i]));
+    }
+}
+
+// the longest decimal that formatDecimal can produce, a sign and twenty digits for a 64 bit long, plus a terminator.
+#define TC_FORMAT_DECIMAL_MAX 22
+
+/**
+ * Formats a number in decimal, with a leading minus sign when negative, much faster than the general purpose functions
+ * as the digits are known to be wanted in base ten without padding.
+ * @param buffer the output buffer, which must have at least TC_FORMAT_DECIMAL_MAX bytes
+ * @param value the value to format
+ * @return the number of characters written, not including the zero terminator
+ */
+static uint8_t formatDecimal(char* buffer, long value) {
+    uint8_t pos = 0;
+    unsigned long magnitude = value;
+    if(value < 0) {
+        buffer[pos++] = '-';
+        magnitude = 0UL - magnitude;
+    }
+
+    char reversed[TC_FORMAT_DECIMAL_MAX];
+    uint8_t digits = 0;
+    do {
+        reversed[digits++] = char('0' + (magnitude % 10U));
+        magnitude /= 10U;
+    } while(magnitude != 0);
+
+    while(digits) buffer[pos++] = reversed[--digits];
+    buffer[pos] = 0;
+    return pos;
+}
+
+void TagValueTransport::writeFieldRaw(uint16_t field, const char* value, size_t len) {
+    // wherever possible the whole field is formatted straight into the transport buffer in one go, otherwise it is
+    // written in parts, for which value must be zero terminated at len.
+    char* out = reserveWrite(len + 4);
+    if(out != nullptr) {
+        out[0] = char(field >> 8);
+        out[1] = char(field & 0xff);
+        out[2] = '=';
+        memcpy(&out[3], value, len);
+        out[len + 3] = '|';
+        commitWrite(len + 4);
+        return;
+    }
+
 	char sz[4];
 	sz[0] = char(field >> 8);
 	sz[1] = char(field & 0xff);
@@ -722,28 +1208,17 @@ void TagValueTransport::writeField(uint16_t field, const char* value) {
 	writeChar('|');
 }
 
+void TagValueTransport::writeField(uint16_t field, const char* value) {
+    writeFieldRaw(field, value, strlen(value));
+}
+
 void TagValueTransport::writeFieldInt(uint16_t field, int value) {
-	char sz[10];
-	sz[0] = char(field >> 8);
-	sz[1] = char(field & 0xff);
-	sz[2] = '=';
-	sz[3] = 0;
-	writeStr(sz);
-	itoa(value, sz, 10);
-	writeStr(sz);
-	writeChar('|');
+    writeFieldLong(field, value);
 }
 
 void TagValueTransport::writeFieldLong(uint16_t field, long value) {
-	char sz[12];
-	sz[0] = char(field >> 8);
-	sz[1] = char(field & 0xff);
-	sz[2] = '=';
-	sz[3] = 0;
-	writeStr(sz);
-	ltoaClrBuff(sz, value, 9,  NOT_PADDED, sizeof sz);
-	writeStr(sz);
-	writeChar('|');
+	char sz[TC_FORMAT_DECIMAL_MAX];
+    writeFieldRaw(field, sz, formatDecimal(sz, value));
 }
 
 void TagValueTransport::endMsg() {
@@ -22,6 +22,7 @@
 
 #define TAG_VAL_PROTOCOL 0x01
 #define BINARY_GZ_PROTOCOL 0x02
+#define BINARY_CHUNKED_PROTOCOL 0x03
 #define START_OF_MESSAGE 0x01
 #define TICK_INTERVAL 1
 
@@ -37,6 +38,13 @@
 #define PAIRING_TIMEOUT_TICKS (15000 / TICK_INTERVAL)
 #endif
 
+// The size of the buffer held by a ChunkedBinaryWriter, each chunk written to the wire is at most this size.
+#ifndef TC_BINARY_STREAM_CHUNK_SIZE
+#define TC_BINARY_STREAM_CHUNK_SIZE 32
+#elif TC_BINARY_STREAM_CHUNK_SIZE < 1 || TC_BINARY_STREAM_CHUNK_SIZE > 65535
+#error "TC_BINARY_STREAM_CHUNK_SIZE must be between 1 and 65535"
+#endif
+
 /**
  * @file RemoteConnector.h
  * 
@@ -131,7 +139,9 @@ enum TagValueTransportType {
     /** a buffered connection that writes to a buffer, and requires a timed check for writing */
     TVAL_BUFFERED,
     /** a buffered and encrypted transport that requires a timed check */
-    TVAL_BUFFERED_DELEGATE_ENCRYPT
+    TVAL_BUFFERED_DELEGATE_ENCRYPT,
+    /** a transport that records the traffic of another transport, see RecordingTransport */
+    TVAL_RECORDING
 };
 
 /**
@@ -148,7 +158,9 @@ public:
 	virtual ~TagValueTransport() = default;
 
 	virtual void startMsg(uint16_t msgType);
-    void startBinMsg(uint16_t msgType, uint16_t byteLen);
+    virtual void startBinMsg(uint16_t msgType, uint16_t byteLen);
+    virtual void startChunkedBinMsg(uint16_t msgType);
+    void writeBinChunk(const uint8_t* data, uint16_t len);
     void writeField(uint16_t field, const char* value);
 	void writeFieldInt(uint16_t field, int value);
     void writeFieldLong(uint16_t field, long value);
@@ -159,6 +171,23 @@ public:
 	virtual void flush() = 0;
 	virtual int writeChar(char data) = 0;
 	virtual int writeStr(const char* data) = 0;
+
+    /**
+     * Reserve space to format data directly into the transport, for transports that buffer their output. When it
+     * returns a non null pointer, up to len bytes may be written there, and then commitWrite must be called with the
+     * number actually used before any other write. The default implementation returns nullptr, in which case the
+     * data must be written using writeChar and writeStr instead.
+     * @param len the number of bytes needed
+     * @return a pointer to the reserved space, or nullptr if not available
+     */
+    virtual char* reserveWrite(size_t len) { return nullptr; }
+
+    /**
+     * Commits data that was formatted into space provided by reserveWrite.
+     * @param len the number of bytes that were written, at most the reserved amount
+     */
+    virtual void commitWrite(size_t len) { }
+
 	virtual uint8_t readByte()=0;
 	virtual bool readAvailable()=0;
 
@@ -167,6 +196,7 @@ public:
 	virtual void close() = 0;
 	virtual void endMsg();
 private:
+    void writeFieldRaw(uint16_t field, const char* value, size_t len);
 	bool findNextMessageStart();
 	bool processMsgKey();
 	bool processValuePart();
@@ -179,6 +209,90 @@ private:
 #define FLAG_PAIRING_MODE 4
 #define FLAG_FULLY_JOINED_RX 5
 #define FLAG_FULLY_JOINED_TX 6
+#define FLAG_BINARY_STREAMING 7
+#define FLAG_QUERY_ONLY 8
+#define FLAG_LAZY_BOOT 9
+#define FLAG_EXPANDING 10
+#define FLAG_EXPANDED_OVERFLOW 11
+#define FLAG_LIST_PAGING 12
+
+class TagValueRemoteConnector;
+
+/**
+ * How a chunked binary stream ended, returned by `ChunkedBinaryWriter::finish`.
+ */
+enum BinaryStreamStatus : uint8_t {
+    /** all the data was written and the message ended normally */
+    BINSTREAM_COMPLETE,
+    /** the writer was never started, or has already been finished */
+    BINSTREAM_NOT_STARTED,
+    /** nothing was written for longer than the heartbeat timeout, the connector ended the message early */
+    BINSTREAM_TIMED_OUT,
+    /** the transport disconnected during the stream, the message was not completed */
+    BINSTREAM_DISCONNECTED
+};
+
+/**
+ * A writer that can send a custom binary message without knowing the length up front, data is appended a piece at a
+ * time and sent onto the wire in chunks, so a large payload such as a log dump or sensor capture can be generated
+ * and sent in constant memory. Obtain one by calling `TagValueRemoteConnector::beginCustomBinaryStream`, append
+ * data using `write`, then call `finish` to end the message.
+ *
+ * On the wire the message uses the chunked binary protocol, after the message type there are any number of chunks,
+ * each being a two byte length (hi first) followed by that many bytes of data, a zero length chunk ends the message.
+ *
+ * While a stream is in progress the connector will not send or read any other messages, so you should finish the
+ * stream before returning control to task manager, or at least as soon as possible. The connector still notices
+ * when the transport disconnects, and if no chunk has been written for longer than the heartbeat timeout, it ends the
+ * stream itself so that the connection does not stay stuck. In either case further writes are not accepted, and
+ * finish reports how the stream ended, so that a truncated message can be dealt with. Always call finish, the
+ * destructor does not touch the connector, it only logs a writer that was never finished.
+ */
+class ChunkedBinaryWriter {
+private:
+    TagValueRemoteConnector* connector;
+    TagValueTransport* transport;
+    uint8_t buffer[TC_BINARY_STREAM_CHUNK_SIZE];
+    uint16_t used;
+    uint8_t streamId;
+public:
+    ChunkedBinaryWriter() : connector(nullptr), transport(nullptr), buffer{}, used(0), streamId(0) {}
+    ChunkedBinaryWriter(const ChunkedBinaryWriter&) = delete;
+    ChunkedBinaryWriter& operator=(const ChunkedBinaryWriter&) = delete;
+    ~ChunkedBinaryWriter();
+
+    /**
+     * @return true if this writer has been started, and the stream has not been finished or ended by the connector
+     */
+    bool isStarted() const;
+
+    /**
+     * Appends a block of data to the message, whenever the buffer is full a chunk is written to the transport.
+     * @param data the data to append
+     * @param len the number of bytes to append
+     * @return the number of bytes accepted, 0 if the writer is not started.
+     */
+    size_t write(const uint8_t* data, size_t len);
+
+    /**
+     * Appends a single byte to the message
+     * @param data the byte to append
+     * @return 1 if accepted, otherwise 0.
+     */
+    size_t write(uint8_t data) { return write(&data, 1); }
+
+    /**
+     * Writes out any partial chunk, and then ends the message, after this the writer can be reused. If the connector
+     * already ended the stream, nothing is written and the reason is returned instead.
+     * @return BINSTREAM_COMPLETE if all the data was sent, otherwise the reason that it was not.
+     */
+    BinaryStreamStatus finish();
+private:
+    friend class TagValueRemoteConnector;
+    void begin(TagValueRemoteConnector* conn, TagValueTransport* tx, uint8_t id);
+    void detach();
+    void flushChunk();
+};
 
 /**
  * The remote connector is what we would normally interact with when dealing with a remote. It provides functionality
@@ -200,11 +314,37 @@ private:
     MenuItemTypePredicate bootPredicate;
     RemoteNoMenuItemPredicate remotePredicate;
 
+    // used to stream a form to the remote a chunk at a time
+    const EmbedControlFlashedForm* formTransfer;
+    uint32_t formOffset;
+    uint8_t formCredits;
+
+    // used by lazy bootstrap to send one level of the menu at a time, the first queued entry is the one in progress
+    MenuItem* expandNext;
+    struct {
+        menuid_t id;
+        uint32_t correlation;
+    } expandQueue[TC_REMOTE_EXPAND_QUEUE_SIZE];
+    uint8_t expandQueueCount;
+    // the submenus that the lazy remote has expanded, only these and the root have their changes sent.
+    menuid_t expandedMenus[TC_REMOTE_EXPANDED_MENUS_SIZE];
+    uint8_t expandedMenuCount;
+
+    // identifies the chunked binary message in progress, see beginCustomBinaryStream, and how the last one ended
+    // if the connector had to end it. The writer checks these, so the connector never refers back to the writer.
+    uint8_t binaryStreamId;
+    BinaryStreamStatus binaryStreamEnd;
+
+    // publish only connections have no remote to talk to, so the whole menu is resent every keyframe interval
+    uint16_t keyframeTicks;
+    uint16_t ticksSinceKeyframe;
+    bool publishOnly;
+
 	// the remote connection details take 16 bytes
 	char remoteName[16];
 	uint8_t remoteMajorVer, remoteMinorVer;
 	ApiPlatform remotePlatform;
-	uint8_t flags;
+	uint16_t flags;
 	uint8_t remoteNo;
 public:
 	/**
@@ -288,6 +428,26 @@ public:
      */
     void encodeCustomBinaryMessage(uint16_t msgType, uint16_t len, void (*msgWriter)(TagValueTransport*, void*, size_t), void* data = nullptr);
 
+    /**
+     * Starts a custom binary message where the length is not known up front, the data is appended through the writer
+     * and sent in chunks, see ChunkedBinaryWriter. No other messages are sent or read by this connector until the
+     * writer is finished, heartbeats are not sent either, but a disconnected transport is still detected, and a
+     * stream that has not been written to for longer than the heartbeat timeout is ended by the connector. The other
+     * end must be able to process such messages.
+     *
+     * ```
+     * ChunkedBinaryWriter writer;
+     * if(myConnector.beginCustomBinaryStream(MSG_CUSTOM, writer)) {
+     *     while(moreData()) writer.write(nextByte());
+     *     if(writer.finish() != BINSTREAM_COMPLETE) dealWithTruncatedMessage();
+     * }
+     * ```
+     * @param msgType the type of message to send
+     * @param writer the writer that will be used to append data
+     * @return true if the message was started, otherwise false.
+     */
+    bool beginCustomBinaryStream(uint16_t msgType, ChunkedBinaryWriter& writer);
+
     /**
      * Encodes a dialog message that the UI can use to render / remove a dialog from the display.
      * @param mode either 'S'how, 'H'ide or 'A'ction
@@ -383,12 +543,53 @@ public:
 
 	/**
 	 * Encodes a value change message to be sent to the remote. The embedded device
-	 * always sends absolute changes out. 
+	 * always sends absolute changes out. When TC_MENU_CHANGE_TIMESTAMPS is enabled, the millis at which the change
+	 * occurred is sent in the timestamp field, as several changes may be sent together some time later.
 	 * @param parentId the parent menu
 	 * @param theItem the item to be bootstrapped.
 	 */
 	void encodeChangeValue(MenuItem* theItem);
 
+    /**
+     * Encodes a window of rows from a runtime list as a list change message, this is sent in response to a list page
+     * request from the remote. Only the rows in the window are rendered, so large lists can be transferred a page
+     * at a time, with the remote requesting (or prefetching) whichever pages it needs to display.
+     * @param item the list item to send rows from
+     * @param start the first row to send
+     * @param count the number of rows to send, limited to TC_REMOTE_LIST_PAGE_SIZE
+     * @param correlation the correlation ID from the request, or 0.
+     */
+    void encodeListPage(ListRuntimeMenuItem* item, int start, int count, uint32_t correlation);
+
+    /**
+     * Encodes the response to a value query, all the requested values are sent in one message. For each requested
+     * item at index i, a field keyed `q` followed by 'A'+i holds the ID, and a field keyed `Q` followed by 'A'+i
+     * holds the current value in the same text format as a value change. The value is left out when the item does
+     * not exist or has no value that can be sent, such as submenus, actions and lists.
+     * @param ids the IDs that were requested
+     * @param count the number of IDs
+     * @param correlation the correlation ID from the request, or 0.
+     */
+    void encodeValueQueryResponse(const menuid_t* ids, uint8_t count, uint32_t correlation);
+
+    /**
+     * Encodes the names of all the forms that are stored on the device, see
+     * `CombinedMessageProcessor::setFormTemplatesInFlash`
+     */
+    void encodeFormNames();
+
+    /**
+     * Starts or continues streaming a form to the remote. Form data is sent as binary chunks of at most
+     * TC_REMOTE_FORM_CHUNK_SIZE bytes, one chunk per tick, between any other messages that need to be sent. The remote
+     * controls the flow by providing credits, one credit allows one chunk to be sent, once the credits are used up
+     * the transfer pauses until the remote requests more. As each chunk contains its offset, a transfer can be resumed
+     * from any offset should the remote need to.
+     * @param form the form to be streamed
+     * @param offset the offset within the form data to start from
+     * @param credits the number of chunks the remote is ready to receive
+     */
+    void startFormTransfer(const EmbedControlFlashedForm* form, uint32_t offset, uint8_t credits);
+
     /**
      * Encodes an acknowledgement back to the other side to indicate the success or failure
      * of an operation.
@@ -414,8 +615,30 @@ public:
     /**
 	 * Called frequently to perform all functions, this is arranged interally by
 	 * registering a taskManager task.
+	 * @param elapsedTicks the number of ticks since the last call, for when the connection is not serviced every tick
 	 */
-	void tick();
+	void tick(uint16_t elapsedTicks = 1);
+
+    /**
+     * Indicates if the connector has writing to do on every tick, such as during bootstrap or when streaming a form,
+     * rather than only when a menu item changes.
+     * @return true if there are writes pending
+     */
+    bool hasPendingWrites() {
+        return isBootstrapMode() || (formTransfer != nullptr && formCredits != 0) || bitRead(flags, FLAG_BINARY_STREAMING)
+                || expandQueueCount != 0;
+    }
+
+    /**
+     * Queues a request from a remote that joined with lazy bootstrap to send the children of a submenu. The children
+     * are sent one per tick using the usual bootstrap messages with the submenu as parent, and once all have been
+     * sent an acknowledgement with the correlation is sent. If the ID is not a submenu, or too many requests are
+     * already waiting, an error acknowledgement is sent straight away. Once a submenu has been expanded, changes to
+     * its items are sent to the remote, before that they are not, see TC_REMOTE_EXPANDED_MENUS_SIZE.
+     * @param subMenuId the ID of the submenu to expand
+     * @param correlation the correlation from the request, or 0
+     */
+    void requestSubMenuExpansion(menuid_t subMenuId, uint32_t correlation);
 
     /**
      * Puts the system into pairing mode, If the system is in pairing mode already the
@@ -471,8 +694,22 @@ public:
 
 	/**
 	 * Sets the remote connection state, again only used by message processor.
+	 * @param joinMode in query only mode there is no bootstrap or change streaming, the remote queries values instead
+	 * @param capabilities the JoinCapabilities flags the remote sent, lists are only paged when JOINCAP_LIST_PAGING is set
 	 */
-	void setRemoteConnected(uint8_t major, uint8_t minor, ApiPlatform platform);
+	void setRemoteConnected(uint8_t major, uint8_t minor, ApiPlatform platform, JoinMode joinMode = JOINMODE_FULL,
+                            uint8_t capabilities = 0);
+
+    /**
+     * Indicates if the remote joined in query only mode, where it neither gets a bootstrap nor value changes, and
+     * instead requests the values it needs using value query messages.
+     */
+    bool isQueryOnly() { return bitRead(flags, FLAG_QUERY_ONLY); }
+
+    /**
+     * @return true if the remote indicated during join that it supports list paging, otherwise lists are sent in full
+     */
+    bool isListPaging() { return bitRead(flags, FLAG_LIST_PAGING); }
 
     /**
      * Notify any listeners of a communication event on this remote, usually used
@@ -489,12 +726,40 @@ public:
     AuthenticationManager* getAuthManager() { return authManager; }
 
     void setHeartbeatTimeout(uint16_t milli) { hbTimeoutTicks = milli / TICK_INTERVAL; }
+
+    /**
+     * Puts this connector into publish only mode, where it streams the menu structure and value changes out of the
+     * transport without ever reading from it. This suits datagram or shared transports such as multicast, where any
+     * number of read only dashboards may be listening and none of them can be tracked. As soon as the transport is
+     * connected the connection is treated as joined, a full bootstrap is sent, and after that value changes are sent
+     * as usual. So that listeners that join later can build up the menu, the bootstrap is repeated every keyframe
+     * interval. There is no authentication, so never publish anything that should not be seen by everyone.
+     * @param keyframeMillis how often the bootstrap is resent, 0 to send it only when first connected.
+     */
+    void enablePublishOnly(uint16_t keyframeMillis);
+
+    /** @return true if this connector is in publish only mode */
+    bool isPublishOnly() const { return publishOnly; }
 private:
+    friend class ChunkedBinaryWriter;
+    bool isBinaryStreamOpen(uint8_t id) const { return id == binaryStreamId && bitRead(flags, FLAG_BINARY_STREAMING); }
+    BinaryStreamStatus binaryStreamStatus(uint8_t id) const;
+    void binaryStreamFinished();
+    void binaryChunkWritten() { ticksLastSend = 0; }
+    void tickBinaryStream(uint16_t elapsedTicks);
+    void abandonBinaryStream(BinaryStreamStatus reason);
+    void tickPublishOnly(uint16_t elapsedTicks);
 	void encodeBaseMenuFields(int parentId, MenuItem* item);
     bool prepareWriteMsg(uint16_t msgType);
 	void nextBootstrap();
+    void encodeBootItem(int parentId, MenuItem* item);
+    MenuItem* nextLazyItem();
+    void markExpanded(menuid_t subMenuId);
+    bool isKnownToRemote(MenuItem* parent);
+    void nextExpansion();
+	void nextFormChunk();
 	void performAnyWrites();
-	void dealWithHeartbeating();
+	void dealWithHeartbeating(uint16_t elapsedTicks);
     /**
      * Sets the connection state for this remote connection. Does not close the underlying transport.
      * Note that is will also notify the callback of the latest state.
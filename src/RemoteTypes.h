@@ -20,13 +20,33 @@
 #error "MAX_VALUE_LEN must be > 40"
 #endif
 
+/**
+ * This defines the maximum number of list rows that will be sent in a single message for a runtime list. When the
+ * remote indicates it supports list paging during join, larger lists are sent a page at a time, the first page with
+ * bootstrap and change messages, and remaining pages as requested by the remote using the list page message. Remotes
+ * that do not support paging always receive the whole list.
+ */
+#ifndef TC_REMOTE_LIST_PAGE_SIZE
+#define TC_REMOTE_LIST_PAGE_SIZE 20
+#elif TC_REMOTE_LIST_PAGE_SIZE > 26
+#error "TC_REMOTE_LIST_PAGE_SIZE must be <= 26"
+#endif
+
+/**
+ * This defines the number of bytes of form data that are sent in each form chunk message. Form data is streamed a
+ * chunk at a time between other messages, so smaller values keep the connection more responsive.
+ */
+#ifndef TC_REMOTE_FORM_CHUNK_SIZE
+#define TC_REMOTE_FORM_CHUNK_SIZE 64
+#endif
+
 enum AckResponseStatus {
     // warnings
     ACK_VALUE_RANGE = -1 , 
     // success
     ACK_SUCCESS = 0, 
     //errors
-    ACK_ID_NOT_FOUND = 1, ACK_CREDENTIALS_INVALID = 2,
+    ACK_ID_NOT_FOUND = 1, ACK_CREDENTIALS_INVALID = 2, ACK_RATE_LIMITED = 3,
     
     // unknown error, always last
     ACK_UNKNOWN = 10000 
@@ -84,6 +104,20 @@ enum AckResponseStatus {
 #define MSG_CHANGE_INT msgFieldToWord('V', 'C')
 /** Message type defintion for a dialog change msg */
 #define MSG_DIALOG msgFieldToWord('D', 'M')
+/** Message type definition for requesting a window of rows from a runtime list */
+#define MSG_LIST_PAGE msgFieldToWord('L', 'P')
+/** Message type definition for requesting, and responding with, the names of forms stored on the device */
+#define MSG_FORM_NAMES msgFieldToWord('F', 'N')
+/** Message type definition for requesting a form be streamed from an offset with a number of chunk credits */
+#define MSG_FORM_REQUEST msgFieldToWord('F', 'R')
+/** Message type definition for a binary chunk of form data sent by the device */
+#define MSG_FORM_CHUNK msgFieldToWord('F', 'C')
+/** Message type definition for a remote requesting the current value of a list of items by ID */
+#define MSG_VALUE_QUERY msgFieldToWord('Q', 'V')
+/** Message type definition for the device responding to a value query with all the requested values */
+#define MSG_VALUE_RESPONSE msgFieldToWord('Q', 'R')
+/** Message type definition for a remote asking for the children of a submenu when using lazy bootstrap */
+#define MSG_SUBMENU_EXPAND msgFieldToWord('S', 'X')
 
 #define FIELD_MSG_NAME    msgFieldToWord('N', 'M')
 #define FIELD_VERSION     msgFieldToWord('V', 'E')
@@ -121,9 +155,36 @@ enum AckResponseStatus {
 #define FIELD_EDIT_MODE   msgFieldToWord('E', 'M')
 #define FIELD_ALPHA       msgFieldToWord('R', 'A')
 #define FIELD_WIDTH       msgFieldToWord('W', 'I')
+#define FIELD_LIST_START  msgFieldToWord('L', 'S')
+#define FIELD_LIST_COUNT  msgFieldToWord('L', 'C')
+#define FIELD_FORM_OFFSET msgFieldToWord('F', 'O')
+#define FIELD_FORM_CREDIT msgFieldToWord('F', 'C')
+#define FIELD_JOIN_MODE   msgFieldToWord('J', 'M')
+#define FIELD_JOIN_CAPS   msgFieldToWord('J', 'C')
+#define FIELD_TIMESTAMP   msgFieldToWord('T', 'S')
 
 #define FIELD_PREPEND_CHOICE 'C'
 #define FIELD_PREPEND_NAMECHOICE 'c'
+#define FIELD_PREPEND_QUERY_ID 'q'
+#define FIELD_PREPEND_QUERY_VAL 'Q'
+
+// The number of submenu expand requests that can be waiting on each connection when using lazy bootstrap.
+#ifndef TC_REMOTE_EXPAND_QUEUE_SIZE
+#define TC_REMOTE_EXPAND_QUEUE_SIZE 3
+#endif
+
+// The number of submenus that each connection using lazy bootstrap remembers as expanded, changes are only sent for
+// items at the root or in an expanded submenu. Should a remote expand more than this, changes are sent for all items.
+#ifndef TC_REMOTE_EXPANDED_MENUS_SIZE
+#define TC_REMOTE_EXPANDED_MENUS_SIZE 8
+#endif
+
+// The maximum number of item IDs that can be requested in a single value query, extra IDs are ignored.
+#ifndef TC_REMOTE_QUERY_MAX_IDS
+#define TC_REMOTE_QUERY_MAX_IDS 8
+#elif TC_REMOTE_QUERY_MAX_IDS > 26
+#error "TC_REMOTE_QUERY_MAX_IDS cannot exceed 26"
+#endif
 
 /**
  * Defines the types of change that can be received / sent in changes messages, either
@@ -143,6 +204,27 @@ enum ApiPlatform : uint8_t {
 	PLATFORM_DOTNET = 3
 };
 
+/**
+ * Defines how a remote wants the connection to behave after joining, sent in the join message.
+ */
+enum JoinMode : uint8_t {
+    /** the device bootstraps the whole menu tree and then streams all changes, the default */
+    JOINMODE_FULL = 0,
+    /** no bootstrap and no change streaming, the remote asks for values using value query messages */
+    JOINMODE_QUERY_ONLY = 1,
+    /** only the root level is bootstrapped, the remote expands submenus as needed using submenu expand messages */
+    JOINMODE_LAZY_BOOT = 2
+};
+
+/**
+ * Defines the optional capabilities a remote can indicate it supports during join, these are bit flags that are
+ * combined together and sent in the join capabilities field. Older remotes do not send the field at all.
+ */
+enum JoinCapabilities : uint8_t {
+    /** the remote understands the list start field and requests further rows using the list page message */
+    JOINCAP_LIST_PAGING = 0x01
+};
+
 /**
  * Defines the type of heartbeat we are dealing with
  */
@@ -15,6 +15,7 @@ void BaseGraphicalRenderer::render() {
 
     uint8_t locRedrawMode = redrawMode;
     redrawMode = MENUDRAW_NO_CHANGE;
+    if(renderStats) renderStats->startFrame(locRedrawMode == MENUDRAW_COMPLETE_REDRAW);
 
     drawingCommand(DRAW_COMMAND_START);
 
@@ -43,6 +44,22 @@ void BaseGraphicalRenderer::render() {
 
     redrawAllWidgets(locRedrawMode != MENUDRAW_NO_CHANGE || forceDrawWidgets);
     drawingCommand(DRAW_COMMAND_ENDED);
+    if(renderStats) renderStats->endFrame();
+}
+
+void BaseGraphicalRenderer::drawAndRecordMenuItem(GridPositionRowCacheEntry *entry, Coord where, Coord areaSize, const DrawingFlags& drawFlags) {
+    if(renderStats == nullptr) {
+        drawMenuItem(entry, where, areaSize, drawFlags);
+        return;
+    }
+    unsigned long started = micros();
+    drawMenuItem(entry, where, areaSize, drawFlags);
+    renderStats->itemDrawn(micros() - started);
+}
+
+RenderStatistics* BaseGraphicalRenderer::enableRenderStatistics(uint8_t historyFrames) {
+    if(renderStats == nullptr) renderStats = new RenderStatistics(historyFrames);
+    return renderStats;
 }
 
 uint8_t BaseGraphicalRenderer::setActiveItem(MenuItem *item) {
@@ -97,7 +114,7 @@ void BaseGraphicalRenderer::subMenuRender(MenuItem* rootItem, uint8_t& locRedraw
 
     if(titleMode == TITLE_ALWAYS && (drawCompleteScreen  || itemOrderByRow.itemAtIndex(0)->getMenuItem()->isChanged(displayNumber))) {
         auto* pEntry = itemOrderByRow.itemAtIndex(0);
-        drawMenuItem(pEntry, Coord(0,0), Coord(int(width), drawingLocation.getStartY()), DrawingFlags(drawCompleteScreen, activeItem == pEntry->getMenuItem(), menuMgr.getCurrentEditor() == pEntry->getMenuItem()));
+        drawAndRecordMenuItem(pEntry, Coord(0,0), Coord(int(width), drawingLocation.getStartY()), DrawingFlags(drawCompleteScreen, activeItem == pEntry->getMenuItem(), menuMgr.getCurrentEditor() == pEntry->getMenuItem()));
         forceDrawWidgets = true;
         setTitleOnDisplay(true);
     } else if(itemOrderByRow.count() > 0){
@@ -204,6 +221,7 @@ bool BaseGraphicalRenderer::drawTheMenuItems(int startRow, int startY, bool draw
             totalHeight = ypos + itemCfg->getHeight();
             auto extentsY = isLastRowExactFit() ? totalHeight : ypos;
             if(extentsY > height) break;
+            if(renderStats) renderStats->itemOnScreen(item);
 
             if (drawEveryLine || item->isChanged(displayNumber)) {
                 serlogF4(SER_TCMENU_DEBUG, "draw item (pos,id,chg)", i, item->getId(), item->isChanged(displayNumber));
@@ -212,15 +230,17 @@ bool BaseGraphicalRenderer::drawTheMenuItems(int startRow, int startY, bool draw
                 if(itemCfg->getPosition().getGridSize() > 1) {
                     int colWidth = int(width) / itemCfg->getPosition().getGridSize();
                     int colOffset = colWidth * (itemCfg->getPosition().getGridPosition() - 1);
-                    drawMenuItem(itemCfg, Coord(colOffset, int(ypos)), Coord(colWidth - 1, int(itemCfg->getHeight())),
+                    drawAndRecordMenuItem(itemCfg, Coord(colOffset, int(ypos)), Coord(colWidth - 1, int(itemCfg->getHeight())),
                                  DrawingFlags(drawEveryLine, item == activeItem, item == menuMgr.getCurrentEditor()));
                 }
                 else {
-                    drawMenuItem(itemCfg, Coord(0, ypos), Coord(int(width), int(itemCfg->getHeight())), DrawingFlags(drawEveryLine, item == activeItem, item == menuMgr.getCurrentEditor()));
+                    drawAndRecordMenuItem(itemCfg, Coord(0, ypos), Coord(int(width), int(itemCfg->getHeight())), DrawingFlags(drawEveryLine, item == activeItem, item == menuMgr.getCurrentEditor()));
                 }
                 if(itemCfg->getPosition().getDrawingMode() == GridPosition::DRAW_TITLE_ITEM && itemCfg->getPosition().getRow() == 0) {
                     didDrawTitle = true;
                 }
+            } else if(renderStats) {
+                renderStats->itemSkipped();
             }
             lastRow = itemCfg->getPosition().getRow();
             addAmount = int(itemCfg->getHeight()) + itemCfg->getDisplayProperties()->getSpaceAfter();
@@ -255,14 +275,14 @@ void BaseGraphicalRenderer::renderList() {
     cachedEntryItem = GridPositionRowCacheEntry(runList->asBackMenu(), GridPosition(GridPosition::DRAW_TITLE_ITEM,
                                                                              titleProps->getDefaultJustification(),
                                                                              0, titleHeight), titleProps);
-    drawMenuItem(&cachedEntryItem, Coord(0, 0), Coord((int)width, titleHeight), DrawingFlags(true, currentActive == 0, false));
+    drawAndRecordMenuItem(&cachedEntryItem, Coord(0, 0), Coord((int)width, titleHeight), DrawingFlags(true, currentActive == 0, false));
 
     for (int i = 0; i <= maxOnScreen; i++) {
         uint8_t current = offset + i;
         if(current >= runList->getNumberOfRows()) break;
         RuntimeMenuItem* toDraw = runList->getChildItem(current);
         cachedEntryItem = GridPositionRowCacheEntry(toDraw, GridPosition(GridPosition::DRAW_TEXTUAL_ITEM, GridPosition::JUSTIFY_TITLE_LEFT_VALUE_RIGHT, current + 1, rowHeight), itemProps);
-        drawMenuItem(&cachedEntryItem, Coord(0, totalTitleHeight), Coord((int)width, rowHeight), DrawingFlags(true, (currentActive-1) == (offset + i), false));
+        drawAndRecordMenuItem(&cachedEntryItem, Coord(0, totalTitleHeight), Coord((int)width, rowHeight), DrawingFlags(true, (currentActive-1) == (offset + i), false));
         taskManager.yieldForMicros(0);
         totalTitleHeight += totalRowHeight;
     }
@@ -14,6 +14,7 @@
 #include <BaseRenderers.h>
 #include "GfxMenuConfig.h"
 #include "RuntimeTitleMenuItem.h"
+#include "RenderStatistics.h"
 
 #define GFX_LAST_ROW_FIT_FLAG 0
 #define GFX_USING_RAW_TOUCH 1
@@ -169,9 +170,11 @@ namespace tcgfx {
         TitleMode titleMode = TITLE_FIRST_ROW;
         uint16_t width, height;
         CachedDrawingLocation drawingLocation;
+        RenderStatistics* renderStats = nullptr;
         uint8_t flags;
     public:
         BaseGraphicalRenderer(int bufferSize, int wid, int hei, bool lastRowExact, const char *appTitle);
+        ~BaseGraphicalRenderer() override { delete renderStats; }
         void initialise() override;
 
         void setTitleMode(TitleMode mode);
@@ -248,6 +251,18 @@ namespace tcgfx {
 
         void render() override;
 
+        /**
+         * Start collecting statistics for every frame, such as the frame time, the items drawn and skipped, and the
+         * time spent drawing items. They are kept for a rolling number of frames, see RenderStatistics. Calling this
+         * again returns the statistics that already exist.
+         * @param historyFrames the number of frames to keep in the history
+         * @return the statistics that will be collected into
+         */
+        RenderStatistics* enableRenderStatistics(uint8_t historyFrames = TC_RENDER_STATS_FRAMES);
+
+        /** @return the render statistics if they have been enabled, otherwise nullptr */
+        RenderStatistics* getRenderStatistics() { return renderStats; }
+
         /**
          * Usually called during the initialisation of the display internally to set the width and height.
          * @param w display width in current rotation
@@ -378,6 +393,12 @@ namespace tcgfx {
          */
         virtual void subMenuRender(MenuItem* rootItem, uint8_t& locRedrawMode, bool& forceDrawWidgets);
         int heightOfRow(int row, bool includeSpace=false);
+
+        /**
+         * Draws a menu item by calling drawMenuItem, recording the time taken in the render statistics if they are
+         * enabled. Use this instead of calling drawMenuItem directly while rendering.
+         */
+        void drawAndRecordMenuItem(GridPositionRowCacheEntry *entry, Coord where, Coord areaSize, const DrawingFlags& drawFlags);
     private:
         bool drawTheMenuItems(int startRow, int startY, bool drawEveryLine);
 
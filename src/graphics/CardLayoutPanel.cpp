@@ -80,6 +80,8 @@ CardLayoutPane::CardLayoutDir CardLayoutPane::prepareAndPaintButtons(GraphicsDev
     leftButton.setButtonDrawingMode(((titleActive && active <= 1) || (!titleActive && active == 0)) ? TcDrawableButton::NOT_SELECTABLE : TcDrawableButton::NORMAL);
     rightButton.setButtonDrawingMode(active >= (countOfItems - 1) ? TcDrawableButton::NOT_SELECTABLE : TcDrawableButton::NORMAL);
 
+    if(leftButton.isDirty()) renderer->markDirty(leftButton.getPosition(), leftButton.getSize());
+    if(rightButton.isDirty()) renderer->markDirty(rightButton.getPosition(), rightButton.getSize());
     leftButton.paintButton(renderer->getDeviceDrawable());
     rightButton.paintButton(renderer->getDeviceDrawable());
 
@@ -11,7 +11,7 @@ void DeviceDrawable::drawText(const Coord& where, const void* font, int mag, con
         handler->setDrawColor(drawColor);
         setTcFontAccordingToMag(handler, font, mag);
         handler->setCursor((int)where.x, (int)where.y + (handler->getYAdvance() - handler->getBaseline()));
-        handler->print(text);
+        printTcUnicode(handler, font, text);
     } else {
         internalDrawText(where, font, mag, text);
     }
@@ -25,17 +25,48 @@ UnicodeFontHandler *DeviceDrawable::getUnicodeHandler(bool enableIfNeeded) {
 }
 
 UnicodeFontHandler *DeviceDrawable::createFontHandler() {
-    return fontHandler = new UnicodeFontHandler(new DrawableTextPlotPipeline(this), ENCMODE_UTF8);
+    if(extentsCache) extentsCache->clear();
+    textPipeline = new DrawableTextPlotPipeline(this);
+    return fontHandler = new UnicodeFontHandler(textPipeline, ENCMODE_UTF8);
+}
+
+void DeviceDrawable::printTcUnicode(UnicodeFontHandler* handler, const void* font, const char* text) {
+    if(glyphCache) {
+        glyphCache->print(handler, textPipeline, font, text);
+    } else {
+        handler->print(text);
+    }
+    if(textPipeline) textPipeline->flush();
+}
+
+bool DeviceDrawable::enableGlyphCache(uint8_t maxGlyphs, uint16_t maxRuns) {
+    if(glyphCache) return true;
+    getUnicodeHandler(true);
+    if(textPipeline == nullptr) {
+        serlogF(SER_WARNING, "Glyph cache needs default pipeline");
+        return false;
+    }
+    glyphCache = new GlyphRunCache(this, maxGlyphs, maxRuns);
+    textPipeline->setGlyphCache(glyphCache);
+    return true;
 }
 
 Coord DeviceDrawable::textExtents(const void *font, int mag, const char *text, int *baseline) {
+    Coord extents;
+    if(extentsCache && extentsCache->find(font, mag, text, extents, baseline)) return extents;
+
+    int bl = 0;
     auto handler = getUnicodeHandler(false);
     if(handler) {
         setTcFontAccordingToMag(handler, font, mag);
-        return handler->textExtents(text, baseline, false);
+        extents = handler->textExtents(text, &bl, false);
     } else {
-        return internalTextExtents(font, mag, text, baseline);
+        extents = internalTextExtents(font, mag, text, &bl);
     }
+
+    if(baseline) *baseline = bl;
+    if(extentsCache) extentsCache->add(font, mag, text, extents, bl);
+    return extents;
 }
 
 void tcgfx::setTcFontAccordingToMag(UnicodeFontHandler* handler, const void* font, int mag) {
@@ -45,3 +76,81 @@ void tcgfx::setTcFontAccordingToMag(UnicodeFontHandler* handler, const void* fon
         handler->setFont((GFXfont*) font);
     }
 }
+
+static long regionArea(const Coord& size) {
+    return long(size.x) * long(size.y);
+}
+
+static bool regionsTouch(const DirtyRegions::Region& r, const Coord& where, const Coord& size) {
+    return where.x <= r.where.x + r.size.x && r.where.x <= where.x + size.x &&
+           where.y <= r.where.y + r.size.y && r.where.y <= where.y + size.y;
+}
+
+static DirtyRegions::Region regionUnion(const DirtyRegions::Region& r, const Coord& where, const Coord& size) {
+    int left = internal_min(r.where.x, where.x);
+    int top = internal_min(r.where.y, where.y);
+    int right = internal_max(r.where.x + r.size.x, where.x + size.x);
+    int bottom = internal_max(r.where.y + r.size.y, where.y + size.y);
+    return DirtyRegions::Region { Coord(left, top), Coord(right - left, bottom - top) };
+}
+
+void DirtyRegions::add(const Coord& where, const Coord& size) {
+    if(size.x <= 0 || size.y <= 0) return;
+
+    for(uint8_t i = 0; i < regionCount; i++) {
+        if(regionsTouch(regions[i], where, size)) {
+            mergeInto(i, where, size);
+            return;
+        }
+    }
+
+    if(regionCount < TC_DIRTY_REGION_COUNT) {
+        regions[regionCount].where = where;
+        regions[regionCount].size = size;
+        regionCount++;
+        return;
+    }
+
+    // no space left, so merge with the area that grows the least by taking this one in.
+    uint8_t best = 0;
+    long bestGrowth = 0;
+    for(uint8_t i = 0; i < regionCount; i++) {
+        long growth = regionArea(regionUnion(regions[i], where, size).size) - regionArea(regions[i].size);
+        if(i == 0 || growth < bestGrowth) {
+            best = i;
+            bestGrowth = growth;
+        }
+    }
+    mergeInto(best, where, size);
+}
+
+void DirtyRegions::mergeInto(uint8_t idx, const Coord& where, const Coord& size) {
+    regions[idx] = regionUnion(regions[idx], where, size);
+    mergeTouching(idx);
+}
+
+void DirtyRegions::mergeTouching(uint8_t idx) {
+    // an area that has grown may now touch others, keep merging until it does not.
+    bool merged = true;
+    while(merged) {
+        merged = false;
+        for(uint8_t i = 0; i < regionCount; i++) {
+            if(i == idx || !regionsTouch(regions[idx], regions[i].where, regions[i].size)) continue;
+            regions[idx] = regionUnion(regions[idx], regions[i].where, regions[i].size);
+            regions[i] = regions[regionCount - 1];
+            regionCount--;
+            if(idx == regionCount) idx = i;
+            merged = true;
+            break;
+        }
+    }
+}
+
+DirtyRegions::Region DirtyRegions::getBounds() const {
+    if(regionCount == 0) return Region { Coord(0, 0), Coord(0, 0) };
+    Region bounds = regions[0];
+    for(uint8_t i = 1; i < regionCount; i++) {
+        bounds = regionUnion(bounds, regions[i].where, regions[i].size);
+    }
+    return bounds;
+}
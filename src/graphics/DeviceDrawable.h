@@ -5,10 +5,62 @@
 #include <PlatformDetermination.h>
 #include "GfxMenuConfig.h"
 #include "DrawingPrimitives.h"
+#include "GlyphRunCache.h"
+#include "TextExtentsCache.h"
 
 class UnicodeFontHandler;
 
+// The number of separate changed areas that are tracked between transactions, when more areas change than this, the
+// nearest areas are merged together.
+#ifndef TC_DIRTY_REGION_COUNT
+#define TC_DIRTY_REGION_COUNT 4
+#endif
+
 namespace tcgfx {
+
+    /**
+     * Keeps a small list of the rectangles on the display that have changed since the last transaction, so that a
+     * driver can send only those areas to the display. Areas that overlap or touch are merged as they are added, and
+     * once the list is full, a new area is merged with whichever existing one grows the least by taking it in.
+     */
+    class DirtyRegions {
+    public:
+        struct Region {
+            Coord where;
+            Coord size;
+        };
+    private:
+        Region regions[TC_DIRTY_REGION_COUNT];
+        uint8_t regionCount = 0;
+    public:
+        /**
+         * Add an area that has changed.
+         * @param where the top left of the area
+         * @param size the size of the area, nothing is added when either dimension is zero or less
+         */
+        void add(const Coord& where, const Coord& size);
+
+        /** remove all areas, usually after they have been sent to the display */
+        void clear() { regionCount = 0; }
+
+        /** @return true if nothing has changed */
+        bool isEmpty() const { return regionCount == 0; }
+
+        /** @return the number of separate areas that changed */
+        uint8_t getCount() const { return regionCount; }
+
+        /**
+         * @param idx the index of the area, from 0 to getCount() - 1
+         * @return the area at that index
+         */
+        const Region& getRegion(uint8_t idx) const { return regions[idx]; }
+
+        /** @return a single area that covers all the areas that have changed, zero sized when empty */
+        Region getBounds() const;
+    private:
+        void mergeInto(uint8_t idx, const Coord& where, const Coord& size);
+        void mergeTouching(uint8_t idx);
+    };
     /**
      * This is the interface that all graphical rendering devices extend from when using GraphicsDeviceRenderer. Instances
      * of this map all the graphics primitives for each display type. You can use it yourself in code to present moderately
@@ -38,6 +90,9 @@ namespace tcgfx {
         };
     protected:
         UnicodeFontHandler *fontHandler = nullptr;
+        DrawableTextPlotPipeline *textPipeline = nullptr;
+        GlyphRunCache *glyphCache = nullptr;
+        TextExtentsCache *extentsCache = nullptr;
         color_t backgroundColor = 0, drawColor = 0;
         SubDeviceType subDeviceType = NO_SUB_DEVICE;
     public:
@@ -137,6 +192,14 @@ namespace tcgfx {
          */
         virtual void transaction(bool isStarting, bool redrawNeeded) = 0;
 
+        /**
+         * Ends a transaction on the root device, providing the areas of the display that changed during it. Drivers
+         * that buffer the display can override this to send only those areas over a slow bus. The default
+         * implementation ends the transaction as usual, redrawing if anything changed.
+         * @param changed the areas that changed since the transaction started
+         */
+        virtual void endTransaction(const DirtyRegions& changed) { transaction(false, !changed.isEmpty()); }
+
         /**
          * This is the internal implementation of textExtents for when TcUnicode is not in use, always prefer the use
          * of textExtents unless you actually need to directly access the library functions.
@@ -167,6 +230,17 @@ namespace tcgfx {
          */
         virtual void drawPixel(uint16_t x, uint16_t y) = 0;
 
+        /**
+         * Draw a horizontal line of pixels in the current draw color, one pixel high. Text and glyphs are drawn as
+         * runs using this method, by default it draws a filled box, but drivers that have a fast line fill should
+         * override it.
+         * @param where the left most position of the span
+         * @param width the number of pixels in the span
+         */
+        virtual void drawHorizontalSpan(const Coord& where, int width) {
+            drawBox(where, Coord(width, 1), true);
+        }
+
         /**
          * Gets the width and height of the text in the font provided, returned in a Coord.
          * @param font the font to measure
@@ -195,6 +269,15 @@ namespace tcgfx {
             transaction(false, needsDrawing);
         }
 
+        /**
+         * Should be called after you've finished drawing, when you've kept track of the areas that changed, so that
+         * only those areas need to be sent to the display. This is a helper method that calls endTransaction()..
+         * @param changed the areas that were drawn
+         */
+        void endDraw(const DirtyRegions& changed) {
+            endTransaction(changed);
+        }
+
         /**
          * set the draw color and background color to be used in subsequent operations
          * @param fg the foreground / draw color
@@ -211,6 +294,13 @@ namespace tcgfx {
          */
         void setDrawColor(color_t fg) { drawColor = getUnderlyingColor(fg); }
 
+        /**
+         * Sets the drawing color to one that has already been mapped with getUnderlyingColor, such as the color that
+         * tcUnicode plots with, so that it is not mapped a second time.
+         * @param underlying the already mapped drawing color.
+         */
+        void setUnderlyingDrawColor(color_t underlying) { drawColor = underlying; }
+
         /**
          * Enables the use of tcUnicode characters, and at this point the drawable assumes all fonts are tcUnicode or
          * Adafruit GFX. This only prevents creation of the handler if called before getting the font handler.
@@ -232,12 +322,61 @@ namespace tcgfx {
          */
         UnicodeFontHandler *getUnicodeHandler(bool enableIfNeeded = true);
 
+        /**
+         * Turns on caching of tcUnicode glyphs, each character is rasterised once and then drawn from the cache as
+         * horizontal runs, which is much faster than plotting each pixel. It only works with the default plot
+         * pipeline, so drawables that override createFontHandler with their own pipeline cannot use it. TcUnicode is
+         * enabled if needed.
+         * @param maxGlyphs the number of glyphs that can be held at once
+         * @param maxRuns the total number of horizontal runs across all glyphs, each takes three bytes
+         * @return true if the cache is now in use, otherwise false.
+         */
+        bool enableGlyphCache(uint8_t maxGlyphs = TC_GLYPH_CACHE_SIZE, uint16_t maxRuns = TC_GLYPH_CACHE_RUNS);
+
+        /**
+         * @return the glyph cache if enabled, useful to check the hit rate, otherwise nullptr.
+         */
+        GlyphRunCache* getGlyphCache() { return glyphCache; }
+
+        /**
+         * Print text with a tcUnicode handler that already has its font, color and cursor set, using the glyph cache
+         * when it is enabled, and making sure that any pixels waiting to be drawn as a span are drawn.
+         * @param handler the font handler
+         * @param font the font that is selected in the handler
+         * @param text the text to print
+         */
+        void printTcUnicode(UnicodeFontHandler* handler, const void* font, const char* text);
+
         /**
          * If a native font handler has already been created, avoid creating a second instance and give the drawable
          * the same instance to save memory.
          * @param handler pointer to the existing handler
          */
-        void setFontHandler(UnicodeFontHandler* handler) {fontHandler = handler;}
+        void setFontHandler(UnicodeFontHandler* handler) {
+            fontHandler = handler;
+            if(extentsCache) extentsCache->clear();
+        }
+
+        /**
+         * Turns on remembering of text measurements, so that text measured with the same font, magnification and
+         * content is not measured again. The cache is cleared whenever the font handler changes.
+         * @param maxEntries the number of measurements to remember
+         */
+        void enableTextExtentsCache(uint8_t maxEntries = TC_TEXT_EXTENTS_CACHE_SIZE) {
+            if(extentsCache == nullptr) extentsCache = new TextExtentsCache(maxEntries);
+        }
+
+        /**
+         * Share a text extents cache with this drawable, normally used to give sub-devices the cache of the root
+         * drawable, as measurements do not depend on where the text is drawn.
+         * @param cache the cache to share, it is not owned by this drawable
+         */
+        void setTextExtentsCache(TextExtentsCache* cache) { extentsCache = cache; }
+
+        /**
+         * @return the text extents cache if enabled, useful to check the hit rate, otherwise nullptr.
+         */
+        TextExtentsCache* getTextExtentsCache() { return extentsCache; }
 
         /**
          * @return the type of sub-device that is supported by this display drawable.
@@ -17,6 +17,7 @@ void DeviceDrawableHelper::reConfigure(color_t *palette, uint8_t paletteSize, co
         if (subDrawable) {
             isSubDevice = true;
             drawable = subDrawable;
+            drawable->setTextExtentsCache(rootDrawable->getTextExtentsCache());
             drawable->startDraw();
             startPos = startPosition;
         } else {
@@ -41,8 +42,7 @@ Coord DeviceDrawableHelper::textExtents(const char* what, int* bl) {
             serlogF(SER_ERROR, "Bad font mode");
             return {0,0};
         }
-        fontMode.setFontTcUnicode(unicodeHandler);
-        return unicodeHandler->textExtents(what, bl);
+        return drawable->textExtents(fontMode.getTcUnicodeFont(), fontMode.getTcUnicodeMag(), what, bl);
     } else {
         auto nativeFont = fontMode.getNativeDesc();
         return drawable->textExtents(nativeFont.getPtr(), nativeFont.getMag(), what, bl);
@@ -57,9 +57,11 @@ void DeviceDrawableHelper::drawText(const Coord& where, color_t drawColor, const
             return;
         }
         fontMode.setFontTcUnicode(unicodeHandler);
+        // cached glyphs are drawn as spans in the drawable's color, so it must be the text color too.
+        drawable->setDrawColor(drawColor);
         unicodeHandler->setDrawColor(drawable->getUnderlyingColor(drawColor));
         unicodeHandler->setCursor(Coord(where.x, where.y + (unicodeHandler->getYAdvance() - unicodeHandler->getBaseline())));
-        unicodeHandler->print(what);
+        drawable->printTcUnicode(unicodeHandler, fontMode.getTcUnicodeFont(), what);
     } else {
         drawable->setDrawColor(drawColor);
         auto font = fontMode.getNativeDesc();
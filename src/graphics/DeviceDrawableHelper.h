@@ -102,6 +102,19 @@ namespace tcgfx {
             }
         }
 
+        /**
+         * @return the font pointer when in either of the tcUnicode modes, otherwise nullptr
+         */
+        const void* getTcUnicodeFont() const {
+            if(mode == ADAFRUIT_FONT) return adaFont;
+            return (mode == TCUNICODE_FONT) ? uniFont : nullptr;
+        }
+
+        /**
+         * @return the magnification to use with the drawable, where tcUnicode fonts are zero and Adafruit fonts one
+         */
+        int getTcUnicodeMag() const { return (mode == ADAFRUIT_FONT) ? 1 : 0; }
+
         const NativeFontDesc& getNativeDesc() const {
             return nativeFont;
         }
@@ -155,6 +168,11 @@ namespace tcgfx {
          */
         DeviceDrawable *getDrawable() { return drawable; }
 
+        /**
+         * @return true if the last reConfigure was able to get a sub device, so drawing is not going to the root
+         */
+        bool isUsingSubDevice() const { return isSubDevice; }
+
         /**
          * If on a sub-device, this call will correct the coordinate to match the area of the screen that the sub-device
          * is drawing to.
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "FrameBufferDrawable.h"
+#include <IoLogging.h>
+#include <string.h>
+
+using namespace tcgfx;
+
+// converts a color_t into 0xRRGGBB regardless of the color depth that color_t is built with.
+static uint32_t colorToRgb(color_t col) {
+#ifdef NEED_32BIT_COLOR_T_ALPHA
+    return col & 0xffffffUL;
+#else
+    uint32_t r = (col >> 11) & 0x1f;
+    uint32_t g = (col >> 5) & 0x3f;
+    uint32_t b = col & 0x1f;
+    return (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+#endif
+}
+
+static uint16_t rgbTo565(uint32_t rgb) {
+    return uint16_t((((rgb >> 19) & 0x1f) << 11) | (((rgb >> 10) & 0x3f) << 5) | ((rgb >> 3) & 0x1f));
+}
+
+FrameBufferDrawable::FrameBufferDrawable(const Coord& size, FrameBufferFormat format, const color_t* pal, int palSize)
+        : SoftwareRasterDrawable(size), buffer(nullptr), parent(nullptr), sprite(nullptr), maxSize(size), offset(0, 0),
+          palette{}, pixelsWritten(0), pixelsThisFrame(0), pixelsLastFrame(0), framesDrawn(0), bytesPerRow(0),
+          paletteSize(0), format(format) {
+    setPalette(pal, palSize);
+    allocate(size);
+}
+
+FrameBufferDrawable::FrameBufferDrawable(FrameBufferDrawable* parent, const Coord& maxSpriteSize)
+        : SoftwareRasterDrawable(maxSpriteSize), buffer(nullptr), parent(parent), sprite(nullptr), maxSize(maxSpriteSize),
+          offset(0, 0), palette{}, pixelsWritten(0), pixelsThisFrame(0), pixelsLastFrame(0), framesDrawn(0),
+          bytesPerRow(0), paletteSize(0), format(FRAMEBUFFER_4BPP) {
+    allocate(maxSpriteSize);
+}
+
+FrameBufferDrawable::~FrameBufferDrawable() {
+    delete sprite;
+    delete[] buffer;
+}
+
+void FrameBufferDrawable::allocate(const Coord& size) {
+    dimensions = size;
+    switch(format) {
+        case FRAMEBUFFER_MONO: bytesPerRow = (size.x + 7) / 8; break;
+        case FRAMEBUFFER_4BPP: bytesPerRow = (size.x + 1) / 2; break;
+        default: bytesPerRow = size.x * 2; break;
+    }
+    if(buffer == nullptr) {
+        size_t len = size_t(bytesPerRow) * size.y;
+        buffer = new uint8_t[len];
+        memset(buffer, 0, len);
+    }
+}
+
+void FrameBufferDrawable::setPalette(const color_t* pal, int palSize) {
+    paletteSize = uint8_t(internal_min(palSize, 16));
+    for(uint8_t i = 0; i < paletteSize; i++) palette[i] = pal[i];
+}
+
+void FrameBufferDrawable::enableSprites(const Coord& maxSpriteSize) {
+    delete sprite;
+    sprite = new FrameBufferDrawable(this, maxSpriteSize);
+    setSubDeviceType(SUB_DEVICE_4BPP);
+}
+
+DeviceDrawable* FrameBufferDrawable::getSubDeviceFor(const Coord& where, const Coord& size, const color_t* pal, int palSize) {
+    if(sprite == nullptr || size.x > sprite->maxSize.x || size.y > sprite->maxSize.y) return nullptr;
+    if(palSize > 16) {
+        serlogF2(SER_WARNING, "Sprite palette too big ", palSize);
+        return nullptr;
+    }
+
+    // the sprite buffer is sized for the largest sprite, each request just uses part of it.
+    sprite->offset = where;
+    sprite->setPalette(pal, palSize);
+    sprite->allocate(size);
+    return sprite;
+}
+
+void FrameBufferDrawable::transaction(bool isStarting, bool redrawNeeded) {
+    if(parent) {
+        if(!isStarting && redrawNeeded) copyToParent();
+        return;
+    }
+
+    if(isStarting) {
+        pixelsThisFrame = 0;
+    } else {
+        pixelsLastFrame = pixelsThisFrame;
+        pixelsThisFrame = 0;
+        framesDrawn++;
+    }
+}
+
+void FrameBufferDrawable::copyToParent() {
+    color_t converted[16];
+    for(uint8_t i = 0; i < 16; i++) {
+        converted[i] = parent->getUnderlyingColor(i < paletteSize ? palette[i] : 0);
+    }
+
+    // runs of the same palette entry are written to the parent as a single span
+    for(int y = 0; y < dimensions.y; y++) {
+        int runStart = 0;
+        uint16_t runIndex = getRawPixel(0, y);
+        for(int x = 1; x <= dimensions.x; x++) {
+            uint16_t index = (x < dimensions.x) ? getRawPixel(x, y) : 0xffff;
+            if(index == runIndex) continue;
+            parent->clippedSpan(offset.x + runStart, offset.y + y, x - runStart, converted[runIndex & 0x0f]);
+            runStart = x;
+            runIndex = index;
+        }
+    }
+}
+
+color_t FrameBufferDrawable::getUnderlyingColor(color_t col) {
+    switch(format) {
+        case FRAMEBUFFER_MONO: return colorToRgb(col) != 0 ? 1 : 0;
+        case FRAMEBUFFER_4BPP: return closestPaletteEntry(col);
+        default: return rgbTo565(colorToRgb(col));
+    }
+}
+
+uint8_t FrameBufferDrawable::closestPaletteEntry(color_t col) const {
+    uint32_t rgb = colorToRgb(col);
+    uint8_t best = 0;
+    uint32_t bestDistance = 0xffffffffUL;
+    for(uint8_t i = 0; i < paletteSize; i++) {
+        if(palette[i] == col) return i;
+        uint32_t entry = colorToRgb(palette[i]);
+        int32_t dr = int32_t((entry >> 16) & 0xff) - int32_t((rgb >> 16) & 0xff);
+        int32_t dg = int32_t((entry >> 8) & 0xff) - int32_t((rgb >> 8) & 0xff);
+        int32_t db = int32_t(entry & 0xff) - int32_t(rgb & 0xff);
+        uint32_t distance = uint32_t(dr * dr + dg * dg + db * db);
+        if(distance < bestDistance) {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return best;
+}
+
+void FrameBufferDrawable::writeSpan(int x, int y, int len, color_t color) {
+    pixelsWritten += len;
+    pixelsThisFrame += len;
+    uint8_t* row = &buffer[y * bytesPerRow];
+    switch(format) {
+        case FRAMEBUFFER_MONO:
+            for(int px = x; px < x + len; px++) {
+                if(color) row[px / 8] |= (0x80 >> (px & 7));
+                else row[px / 8] &= ~(0x80 >> (px & 7));
+            }
+            break;
+        case FRAMEBUFFER_4BPP:
+            for(int px = x; px < x + len; px++) {
+                uint8_t& b = row[px / 2];
+                b = (px & 1) ? (b & 0xf0) | (color & 0x0f) : (b & 0x0f) | ((color & 0x0f) << 4);
+            }
+            break;
+        default:
+            for(int px = x; px < x + len; px++) {
+                row[px * 2] = uint8_t(color >> 8);
+                row[(px * 2) + 1] = uint8_t(color);
+            }
+            break;
+    }
+}
+
+uint16_t FrameBufferDrawable::getRawPixel(int x, int y) const {
+    if(x < 0 || y < 0 || x >= dimensions.x || y >= dimensions.y) return 0;
+    const uint8_t* row = &buffer[y * bytesPerRow];
+    switch(format) {
+        case FRAMEBUFFER_MONO: return (row[x / 8] >> (7 - (x & 7))) & 1;
+        case FRAMEBUFFER_4BPP: return (x & 1) ? row[x / 2] & 0x0f : row[x / 2] >> 4;
+        default: return uint16_t((row[x * 2] << 8) | row[(x * 2) + 1]);
+    }
+}
+
+uint32_t FrameBufferDrawable::getPixelRgb(int x, int y) const {
+    if(x < 0 || y < 0 || x >= dimensions.x || y >= dimensions.y) return 0;
+    uint16_t raw = getRawPixel(x, y);
+    switch(format) {
+        case FRAMEBUFFER_MONO:
+            return raw ? 0xffffffUL : 0;
+        case FRAMEBUFFER_4BPP:
+            return raw < paletteSize ? colorToRgb(palette[raw]) : 0;
+        default: {
+            uint32_t r = (raw >> 11) & 0x1f;
+            uint32_t g = (raw >> 5) & 0x3f;
+            uint32_t b = raw & 0x1f;
+            return (((r << 3) | (r >> 2)) << 16) | (((g << 2) | (g >> 4)) << 8) | ((b << 3) | (b >> 2));
+        }
+    }
+}
+
+#ifdef TC_FRAMEBUFFER_FILE_SUPPORT
+
+bool FrameBufferDrawable::writePpm(FILE* file) const {
+    if(fprintf(file, "P6\n%d %d\n255\n", int(dimensions.x), int(dimensions.y)) < 0) return false;
+    for(int y = 0; y < dimensions.y; y++) {
+        for(int x = 0; x < dimensions.x; x++) {
+            uint32_t rgb = getPixelRgb(x, y);
+            uint8_t px[3] = { uint8_t(rgb >> 16), uint8_t(rgb >> 8), uint8_t(rgb) };
+            if(fwrite(px, 1, 3, file) != 3) return false;
+        }
+    }
+    return true;
+}
+
+bool FrameBufferDrawable::savePpm(const char* path) const {
+    FILE* file = fopen(path, "wb");
+    if(file == nullptr) {
+        serlogF2(SER_ERROR, "PPM file open fail ", path);
+        return false;
+    }
+    bool ok = writePpm(file);
+    return fclose(file) == 0 && ok;
+}
+
+#endif // TC_FRAMEBUFFER_FILE_SUPPORT
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file FrameBufferDrawable.h
+ * @brief a drawable that renders into a framebuffer in memory, so that rendering can be checked and measured on a host.
+ */
+
+#ifndef TCMENU_FRAMEBUFFERDRAWABLE_H
+#define TCMENU_FRAMEBUFFERDRAWABLE_H
+
+#include <PlatformDetermination.h>
+#include "SoftwareRasterDrawable.h"
+
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO)
+#define TC_FRAMEBUFFER_FILE_SUPPORT
+#include <stdio.h>
+#endif
+
+namespace tcgfx {
+
+    /**
+     * A drawable that renders into a framebuffer held in memory, in either mono, 4 bit palette or RGB565 format. It
+     * needs no display, so it can run on a host to check that the renderer draws the right pixels, such as comparing
+     * frames against known good images, and to measure rendering with the number of pixels written each frame. On
+     * hosts, frames can be saved as PPM images.
+     *
+     * In mono format any color other than black is lit. In palette format, colors are mapped to the nearest entry in
+     * the palette. Sub devices can be turned on with enableSprites, they are a 4 bit palette sprite that is copied
+     * onto this framebuffer when its drawing ends, in the same way as display drivers that use sprites. Text must be
+     * drawn using tcUnicode, as there are no native fonts.
+     */
+    class FrameBufferDrawable : public SoftwareRasterDrawable {
+    public:
+        enum FrameBufferFormat : uint8_t {
+            /** one bit per pixel, the leftmost pixel in the highest bit */
+            FRAMEBUFFER_MONO,
+            /** four bits per pixel indexing the palette, the leftmost pixel in the high nibble */
+            FRAMEBUFFER_4BPP,
+            /** sixteen bit RGB565 pixels */
+            FRAMEBUFFER_RGB565
+        };
+    private:
+        uint8_t* buffer;
+        FrameBufferDrawable* parent;
+        FrameBufferDrawable* sprite;
+        Coord maxSize;
+        Coord offset;
+        color_t palette[16];
+        uint32_t pixelsWritten;
+        uint32_t pixelsThisFrame;
+        uint32_t pixelsLastFrame;
+        uint32_t framesDrawn;
+        uint16_t bytesPerRow;
+        uint8_t paletteSize;
+        FrameBufferFormat format;
+    public:
+        /**
+         * Create a framebuffer of the given size and format, it is allocated and cleared to 0 straight away.
+         * @param size the width and height in pixels
+         * @param format the format of each pixel
+         * @param pal the palette for FRAMEBUFFER_4BPP, up to 16 entries, otherwise not needed
+         * @param palSize the number of entries in the palette
+         */
+        FrameBufferDrawable(const Coord& size, FrameBufferFormat format, const color_t* pal = nullptr, int palSize = 0);
+        ~FrameBufferDrawable() override;
+
+        /**
+         * Allows the renderer to draw items onto a 4 bit palette sprite, which is copied onto the framebuffer when the
+         * drawing ends. Requests larger than the maximum size are drawn directly.
+         * @param maxSpriteSize the largest sprite that can be given out
+         */
+        void enableSprites(const Coord& maxSpriteSize);
+
+        DeviceDrawable* getSubDeviceFor(const Coord &where, const Coord &size, const color_t *palette, int paletteSize) override;
+        void transaction(bool isStarting, bool redrawNeeded) override;
+        color_t getUnderlyingColor(color_t col) override;
+
+        /** @return the format of the pixels in the framebuffer */
+        FrameBufferFormat getFormat() const { return format; }
+
+        /** @return the raw framebuffer, rows are packed according to the format and start on a new byte */
+        const uint8_t* getBuffer() const { return buffer; }
+
+        /**
+         * @return the value stored for a pixel, the bit, palette index or RGB565 value depending on format, or 0 when
+         * the position is outside of the framebuffer.
+         */
+        uint16_t getRawPixel(int x, int y) const;
+
+        /**
+         * @return the color of a pixel as 0xRRGGBB, mono pixels are white when lit, 0 when outside of the framebuffer
+         */
+        uint32_t getPixelRgb(int x, int y) const;
+
+        /** @return the pixels written since the statistics were reset, including those copied from sprites */
+        uint32_t getPixelsWritten() const { return pixelsWritten; }
+
+        /** @return the pixels written between the start and end of the last completed transaction */
+        uint32_t getPixelsLastFrame() const { return pixelsLastFrame; }
+
+        /** @return the number of transactions that have been completed since the statistics were reset */
+        uint32_t getFramesDrawn() const { return framesDrawn; }
+
+        /** reset the pixel and frame counts */
+        void resetStatistics() { pixelsWritten = pixelsThisFrame = pixelsLastFrame = framesDrawn = 0; }
+
+#ifdef TC_FRAMEBUFFER_FILE_SUPPORT
+        /**
+         * Writes the framebuffer as a binary PPM image, which nearly every image tool can open.
+         * @param file the file to write to, it is not closed
+         * @return true if written, otherwise false
+         */
+        bool writePpm(FILE* file) const;
+
+        /**
+         * Saves the framebuffer as a binary PPM image, replacing any existing file.
+         * @param path the file to write
+         * @return true if saved, otherwise false
+         */
+        bool savePpm(const char* path) const;
+#endif
+
+    protected:
+        void writeSpan(int x, int y, int len, color_t color) override;
+
+    private:
+        FrameBufferDrawable(FrameBufferDrawable* parent, const Coord& maxSpriteSize);
+        void allocate(const Coord& size);
+        void setPalette(const color_t* pal, int palSize);
+        void copyToParent();
+        uint8_t closestPaletteEntry(color_t col) const;
+    };
+}
+
+#endif //TCMENU_FRAMEBUFFERDRAWABLE_H
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "GlyphRunCache.h"
+#include "DeviceDrawable.h"
+#include "GraphicsDeviceRenderer.h"
+#include <tcUnicodeHelper.h>
+
+using namespace tcgfx;
+
+GlyphRunCache::GlyphRunCache(DeviceDrawable* drawable, uint8_t maxGlyphs, uint16_t maxRuns)
+        : drawable(drawable), maxRuns(maxRuns), runsUsed(0), useCounter(0), captureStart(0), hits(0), misses(0),
+          captureCursor(0, 0), maxGlyphs(maxGlyphs), captureMode(NOT_CAPTURING) {
+    glyphs = new CachedGlyph[maxGlyphs];
+    runs = new GlyphRun[maxRuns];
+    clear();
+}
+
+GlyphRunCache::~GlyphRunCache() {
+    delete[] glyphs;
+    delete[] runs;
+}
+
+void GlyphRunCache::clear() {
+    for(uint8_t i = 0; i < maxGlyphs; i++) {
+        glyphs[i].font = nullptr;
+    }
+    runsUsed = 0;
+}
+
+void GlyphRunCache::print(UnicodeFontHandler* handler, DrawableTextPlotPipeline* pipeline, const void* font, const char* text) {
+    if(font == nullptr) {
+        handler->print(text);
+        return;
+    }
+
+    while(*text) {
+        // the key is the raw UTF-8 bytes of the character packed together, there is no need to decode it.
+        auto lead = (uint8_t)*text;
+        int len = (lead < 0x80) ? 1 : (lead < 0xE0) ? 2 : (lead < 0xF0) ? 3 : 4;
+        char utf8[5];
+        uint32_t character = 0;
+        int i = 0;
+        while(i < len && text[i]) {
+            utf8[i] = text[i];
+            character = (character << 8) | (uint8_t)text[i];
+            i++;
+        }
+        utf8[i] = 0;
+        text += i;
+
+        if(lead < 32) {
+            handler->print(utf8);
+            continue;
+        }
+
+        auto glyph = findGlyph(font, character);
+        if(glyph) {
+            hits++;
+            glyph->lastUsed = ++useCounter;
+            Coord cursor = pipeline->getCursor();
+            drawRuns(glyph->firstRun, glyph->runCount, cursor);
+            pipeline->setCursor(Coord(cursor.x + glyph->advance, cursor.y));
+        } else {
+            misses++;
+            printUncached(handler, pipeline, font, character, utf8);
+        }
+    }
+}
+
+void GlyphRunCache::printUncached(UnicodeFontHandler* handler, DrawableTextPlotPipeline* pipeline, const void* font,
+                                  uint32_t character, const char* utf8) {
+    // the slot is taken before capturing, as removing a glyph moves the runs stored after it.
+    auto slot = freeGlyphSlot();
+    captureCursor = pipeline->getCursor();
+    captureStart = runsUsed;
+    captureMode = CAPTURING;
+    handler->print(utf8);
+    bool captured = captureMode == CAPTURING;
+    captureMode = NOT_CAPTURING;
+    if(!captured) return; // already drawn directly
+
+    Coord after = pipeline->getCursor();
+    drawRuns(captureStart, runsUsed - captureStart, captureCursor);
+    if(after.y != captureCursor.y) {
+        runsUsed = captureStart;
+        return;
+    }
+
+    slot->font = font;
+    slot->character = character;
+    slot->firstRun = captureStart;
+    slot->runCount = runsUsed - captureStart;
+    slot->advance = int16_t(after.x - captureCursor.x);
+    slot->lastUsed = ++useCounter;
+}
+
+void GlyphRunCache::capturePixel(int x, int y) {
+    if(captureMode == CAPTURE_FAILED) {
+        drawable->drawPixel(x, y);
+        return;
+    }
+
+    int relX = x - captureCursor.x;
+    int relY = y - captureCursor.y;
+    if(runsUsed > captureStart) {
+        GlyphRun& last = runs[runsUsed - 1];
+        if(last.y == relY && last.x + last.len == relX && last.len < 255) {
+            last.len++;
+            return;
+        }
+    }
+
+    // make room by removing the oldest glyphs, they are always stored before the glyph being captured.
+    while(runsUsed == maxRuns && runsUsed != captureStart) {
+        CachedGlyph* oldest = nullptr;
+        for(uint8_t i = 0; i < maxGlyphs; i++) {
+            if(glyphs[i].font && (oldest == nullptr || uint16_t(useCounter - glyphs[i].lastUsed) > uint16_t(useCounter - oldest->lastUsed))) {
+                oldest = &glyphs[i];
+            }
+        }
+        if(oldest == nullptr) break;
+        evictGlyph(oldest);
+    }
+
+    if(runsUsed == maxRuns || relX < -128 || relX > 127 || relY < -128 || relY > 127) {
+        // this glyph cannot be cached, draw what has been captured so far and draw the rest directly.
+        drawRuns(captureStart, runsUsed - captureStart, captureCursor);
+        runsUsed = captureStart;
+        captureMode = CAPTURE_FAILED;
+        drawable->drawPixel(x, y);
+        return;
+    }
+
+    GlyphRun& run = runs[runsUsed++];
+    run.x = int8_t(relX);
+    run.y = int8_t(relY);
+    run.len = 1;
+}
+
+GlyphRunCache::CachedGlyph* GlyphRunCache::findGlyph(const void* font, uint32_t character) {
+    for(uint8_t i = 0; i < maxGlyphs; i++) {
+        if(glyphs[i].character == character && glyphs[i].font == font) return &glyphs[i];
+    }
+    return nullptr;
+}
+
+GlyphRunCache::CachedGlyph* GlyphRunCache::freeGlyphSlot() {
+    CachedGlyph* oldest = &glyphs[0];
+    for(uint8_t i = 0; i < maxGlyphs; i++) {
+        if(glyphs[i].font == nullptr) return &glyphs[i];
+        if(uint16_t(useCounter - glyphs[i].lastUsed) > uint16_t(useCounter - oldest->lastUsed)) oldest = &glyphs[i];
+    }
+    evictGlyph(oldest);
+    return oldest;
+}
+
+void GlyphRunCache::evictGlyph(CachedGlyph* glyph) {
+    // runs are kept packed together, so the runs after the glyph are moved down into the space it leaves.
+    uint16_t end = glyph->firstRun + glyph->runCount;
+    memmove(&runs[glyph->firstRun], &runs[end], (runsUsed - end) * sizeof(GlyphRun));
+    for(uint8_t i = 0; i < maxGlyphs; i++) {
+        if(glyphs[i].font && glyphs[i].firstRun >= end) glyphs[i].firstRun -= glyph->runCount;
+    }
+    if(captureStart >= end) captureStart -= glyph->runCount;
+    runsUsed -= glyph->runCount;
+    glyph->font = nullptr;
+}
+
+void GlyphRunCache::drawRuns(uint16_t first, uint16_t count, const Coord& where) {
+    for(uint16_t i = first; i < first + count; i++) {
+        const GlyphRun& run = runs[i];
+        drawable->drawHorizontalSpan(Coord(where.x + run.x, where.y + run.y), run.len);
+    }
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file GlyphRunCache.h
+ * @brief a bounded cache of rasterised tcUnicode glyphs, stored as horizontal runs so they can be drawn quickly.
+ */
+
+#ifndef TCMENU_GLYPHRUNCACHE_H
+#define TCMENU_GLYPHRUNCACHE_H
+
+#include <PlatformDetermination.h>
+#include "DrawingPrimitives.h"
+
+class UnicodeFontHandler;
+
+// The number of glyphs that can be held in the cache at once.
+#ifndef TC_GLYPH_CACHE_SIZE
+#define TC_GLYPH_CACHE_SIZE 32
+#endif
+
+// The total number of horizontal runs that can be stored across all cached glyphs, each takes three bytes.
+#ifndef TC_GLYPH_CACHE_RUNS
+#define TC_GLYPH_CACHE_RUNS 512
+#endif
+
+namespace tcgfx {
+
+    class DeviceDrawable;
+    class DrawableTextPlotPipeline;
+
+    /**
+     * A horizontal run of lit pixels within a glyph, relative to the cursor position that the glyph was drawn at.
+     */
+    struct GlyphRun {
+        int8_t x;
+        int8_t y;
+        uint8_t len;
+    };
+
+    /**
+     * Caches the pixels that tcUnicode draws for each character, keyed by the font and the UTF-8 bytes of that
+     * character. The first time a character is drawn, the pixels sent to the plot pipeline are captured as
+     * horizontal runs instead of being drawn. From then on the character is drawn from the cache as one horizontal
+     * span per run, so there is no per pixel decoding, color setting or virtual drawPixel call. When there is no room
+     * left, the least recently used glyphs are removed. Glyphs more than 127 pixels from the cursor, and control
+     * characters, are never cached and are always drawn by tcUnicode.
+     */
+    class GlyphRunCache {
+    public:
+        struct CachedGlyph {
+            const void* font;
+            uint32_t character;
+            uint16_t firstRun;
+            uint16_t runCount;
+            int16_t advance;
+            uint16_t lastUsed;
+        };
+    private:
+        enum CaptureMode : uint8_t { NOT_CAPTURING, CAPTURING, CAPTURE_FAILED };
+
+        CachedGlyph* glyphs;
+        GlyphRun* runs;
+        DeviceDrawable* drawable;
+        uint16_t maxRuns;
+        uint16_t runsUsed;
+        uint16_t useCounter;
+        uint16_t captureStart;
+        uint32_t hits;
+        uint32_t misses;
+        Coord captureCursor;
+        uint8_t maxGlyphs;
+        CaptureMode captureMode;
+    public:
+        /**
+         * Create a glyph cache for a drawable, it is normally created by calling enableGlyphCache on the drawable.
+         * @param drawable the drawable that cached glyphs are drawn onto
+         * @param maxGlyphs the number of glyphs that can be held
+         * @param maxRuns the total number of runs that can be held across all glyphs
+         */
+        GlyphRunCache(DeviceDrawable* drawable, uint8_t maxGlyphs, uint16_t maxRuns);
+        ~GlyphRunCache();
+
+        /**
+         * Prints the text at the handler's current cursor position in the drawable's current draw color, using the
+         * cache for every character that it holds, and adding those it does not.
+         * @param handler the font handler, already set up with the right font and cursor
+         * @param pipeline the plot pipeline that the handler draws through
+         * @param font the font that is selected in the handler, used as part of the key
+         * @param text the UTF-8 text to print
+         */
+        void print(UnicodeFontHandler* handler, DrawableTextPlotPipeline* pipeline, const void* font, const char* text);
+
+        /**
+         * Called by the plot pipeline for each pixel while a glyph is being captured.
+         * @param x the x position of the pixel
+         * @param y the y position of the pixel
+         */
+        void capturePixel(int x, int y);
+
+        /** @return true when pixels from tcUnicode should be given to capturePixel rather than drawn */
+        bool isCapturing() const { return captureMode != NOT_CAPTURING; }
+
+        /** remove all glyphs from the cache, for example after fonts have been changed */
+        void clear();
+
+        /** @return the number of characters drawn from the cache */
+        uint32_t getHits() const { return hits; }
+
+        /** @return the number of characters that had to be drawn by tcUnicode */
+        uint32_t getMisses() const { return misses; }
+
+        /** @return the number of runs currently stored */
+        uint16_t getRunsUsed() const { return runsUsed; }
+
+    private:
+        CachedGlyph* findGlyph(const void* font, uint32_t character);
+        CachedGlyph* freeGlyphSlot();
+        void evictGlyph(CachedGlyph* glyph);
+        void drawRuns(uint16_t first, uint16_t count, const Coord& where);
+        void printUncached(UnicodeFontHandler* handler, DrawableTextPlotPipeline* pipeline, const void* font,
+                           uint32_t character, const char* utf8);
+    };
+}
+
+#endif //TCMENU_GLYPHRUNCACHE_H
@@ -18,6 +18,19 @@ namespace tcgfx {
     static unsigned char rendererUpArrowXbm[] = { 0x03, 0x07, 0x0f, 0x1f, 0x3f, 0x7f, 0x3f, 0x1f, 0x0f, 0x07, 0x03 };
     static unsigned char rendererDownArrowXbm[] = { 0xc0, 0xe0, 0xf0, 0xf8, 0xfc, 0xfe, 0xfc, 0xf8, 0xf0, 0xe0, 0xc0 };
 
+    static uint32_t hashName(const char* name) {
+        uint32_t hash = 2166136261UL;
+        while(*name) {
+            hash ^= (uint8_t)*name++;
+            hash *= 16777619UL;
+        }
+        return hash;
+    }
+
+    static bool sameCoord(const Coord& a, const Coord& b) {
+        return a.x == b.x && a.y == b.y;
+    }
+
     bool GraphicsDeviceRenderer::isActiveOrEditing(MenuItem* pItem, const DrawingFlags& drawingFlags) {
         auto mt = pItem->getMenuType();
         return (drawingFlags.isEditing() || drawingFlags.isActive()) && mt != MENUTYPE_TITLE_ITEM && mt != MENUTYPE_BACK_VALUE;
@@ -38,25 +51,36 @@ namespace tcgfx {
                 auto* cfg = propertiesFactory.configFor(nullptr, ItemDisplayProperties::COMPTYPE_ITEM);
                 helper.getDrawable()->setDrawColor(cfg->getColor(ItemDisplayProperties::BACKGROUND));
                 helper.getDrawable()->drawBox(Coord(0, 0), Coord(width, height), true);
+                markDirty(Coord(0, 0), Coord(width, height));
+                for(auto& layout : rowLayouts) layout.item = nullptr;
                 break;
             }
             case DRAW_COMMAND_START:
+                helper.getDrawable()->transaction(true, !dirtyRegions.isEmpty());
+                break;
             case DRAW_COMMAND_ENDED:
-                helper.getDrawable()->transaction(command == DRAW_COMMAND_START, redrawNeeded);
-                redrawNeeded = false;
+                // the driver is given the areas that changed, so it can send just those parts of the display.
+                helper.getDrawable()->endTransaction(dirtyRegions);
+                dirtyRegions.clear();
+                if(renderStats) recordCacheHitRates();
                 break;
         }
     }
 
     void GraphicsDeviceRenderer::drawWidget(Coord where, TitleWidget *widget, color_t colorFg, color_t colorBg) {
-        redrawNeeded = true;
+        markDirty(where, Coord(widget->getWidth(), widget->getHeight()));
         helper.getDrawable()->setColors(colorFg, colorBg);
         helper.getDrawable()->drawXBitmap(where, Coord(widget->getWidth(), widget->getHeight()), widget->getCurrentIcon());
     }
 
     void GraphicsDeviceRenderer::drawMenuItem(GridPositionRowCacheEntry *entry, Coord where, Coord areaSize, const DrawingFlags& drawingFlags) {
-        redrawNeeded = true;
+        if(drawValueOnly(entry, where, areaSize, drawingFlags)) return;
+
+        markDirty(where, areaSize);
         entry->getMenuItem()->setChanged(displayNumber, false);
+        Coord rowWhere = where;
+        Coord rowSize = areaSize;
+        drawnLayoutValid = false;
 
         // if it's in a multi grid layout, put a small gap at the start of each one.
         if(entry->getPosition().getGridSize() > 1) {
@@ -72,6 +96,7 @@ namespace tcgfx {
             auto* bgConfig = propertiesFactory.configFor(menuMgr.getCurrentSubMenu(), ItemDisplayProperties::COMPTYPE_ITEM);
             helper.getDrawable()->setDrawColor(bgConfig->getColor(ItemDisplayProperties::BACKGROUND));
             helper.getDrawable()->drawBox(Coord(where.x, where.y + areaSize.y), Coord(areaSize.x, entry->getDisplayProperties()->getSpaceAfter()), true);
+            markDirty(Coord(where.x, where.y + areaSize.y), Coord(areaSize.x, entry->getDisplayProperties()->getSpaceAfter()));
         }
 
         // icons never use double buffer drawing because they may use a lot of BPP and don't change often in the main
@@ -82,15 +107,12 @@ namespace tcgfx {
         }
 
         color_t palette[4];
-        bool selected = isActiveOrEditing(entry->getMenuItem(), drawingFlags);
-        palette[ItemDisplayProperties::TEXT] = (selected) ? propertiesFactory.getSelectedColor(ItemDisplayProperties::TEXT) : entry->getDisplayProperties()->getPalette()[ItemDisplayProperties::TEXT];
-        palette[ItemDisplayProperties::BACKGROUND] = (selected) ? propertiesFactory.getSelectedColor(ItemDisplayProperties::BACKGROUND) : entry->getDisplayProperties()->getPalette()[ItemDisplayProperties::BACKGROUND];
-        palette[ItemDisplayProperties::HIGHLIGHT1] = entry->getDisplayProperties()->getPalette()[ItemDisplayProperties::HIGHLIGHT1];
-        palette[ItemDisplayProperties::HIGHLIGHT2] = entry->getDisplayProperties()->getPalette()[ItemDisplayProperties::HIGHLIGHT2];
+        prepareItemPalette(entry, isActiveOrEditing(entry->getMenuItem(), drawingFlags), palette);
         helper.reConfigure(palette, 4, where, areaSize);
+        if(renderStats && helper.isUsingSubDevice()) renderStats->subDeviceUsed();
 
         Coord wh = helper.offsetLocation(where);
-
+        drawOffset = Coord(where.x - wh.x, where.y - wh.y);
 
         switch(drawingMode) {
             case GridPosition::DRAW_TEXTUAL_ITEM:
@@ -108,6 +130,7 @@ namespace tcgfx {
         }
 
         helper.endDraw();
+        rememberRowLayout(entry, rowWhere, rowSize, drawingFlags);
 
 #ifdef TC_TOUCH_DEBUG
         // This is for debugging of touch coordinates
@@ -119,6 +142,90 @@ namespace tcgfx {
 #endif
     }
 
+    void GraphicsDeviceRenderer::prepareItemPalette(GridPositionRowCacheEntry *entry, bool selected, color_t* palette) {
+        palette[ItemDisplayProperties::TEXT] = (selected) ? propertiesFactory.getSelectedColor(ItemDisplayProperties::TEXT) : entry->getDisplayProperties()->getPalette()[ItemDisplayProperties::TEXT];
+        palette[ItemDisplayProperties::BACKGROUND] = (selected) ? propertiesFactory.getSelectedColor(ItemDisplayProperties::BACKGROUND) : entry->getDisplayProperties()->getPalette()[ItemDisplayProperties::BACKGROUND];
+        palette[ItemDisplayProperties::HIGHLIGHT1] = entry->getDisplayProperties()->getPalette()[ItemDisplayProperties::HIGHLIGHT1];
+        palette[ItemDisplayProperties::HIGHLIGHT2] = entry->getDisplayProperties()->getPalette()[ItemDisplayProperties::HIGHLIGHT2];
+    }
+
+    RowValueLayout* GraphicsDeviceRenderer::findRowLayout(MenuItem* item) {
+        for(auto& layout : rowLayouts) {
+            if(layout.item == item) return &layout;
+        }
+        return nullptr;
+    }
+
+    void GraphicsDeviceRenderer::rememberRowLayout(GridPositionRowCacheEntry *entry, const Coord& where, const Coord& areaSize, const DrawingFlags& drawingFlags) {
+        auto* layout = findRowLayout(entry->getMenuItem());
+        // only plain text rows that were drawn with the value clear of the name can be partly redrawn later.
+        if(!drawnLayoutValid || drawingFlags.isEditing() || entry->getPosition().getDrawingMode() != GridPosition::DRAW_TEXTUAL_ITEM) {
+            if(layout) layout->item = nullptr;
+            return;
+        }
+
+        if(layout == nullptr) layout = findRowLayout(nullptr);
+        if(layout == nullptr) {
+            layout = &rowLayouts[nextRowLayout];
+            nextRowLayout = (nextRowLayout + 1) % TC_VALUE_REDRAW_ROWS;
+        }
+        *layout = drawnLayout;
+        layout->item = entry->getMenuItem();
+        layout->props = entry->getDisplayProperties();
+        layout->where = where;
+        layout->size = areaSize;
+        layout->active = drawingFlags.isActive();
+    }
+
+    bool GraphicsDeviceRenderer::drawValueOnly(GridPositionRowCacheEntry *entry, const Coord& where, const Coord& areaSize, const DrawingFlags& drawingFlags) {
+        if(drawingFlags.isDrawingAll() || drawingFlags.isEditing()) return false;
+        auto* item = entry->getMenuItem();
+        auto* layout = findRowLayout(item);
+        if(layout == nullptr || layout->props != entry->getDisplayProperties() || layout->active != drawingFlags.isActive() ||
+                !sameCoord(layout->where, where) || !sameCoord(layout->size, areaSize)) {
+            return false;
+        }
+
+        item->copyNameToBuffer(buffer, bufferSize);
+        if(hashName(buffer) != layout->nameHash) return false;
+
+        // the value is right aligned, if it now reaches the name, the whole row must be drawn again.
+        ItemDisplayProperties *props = entry->getDisplayProperties();
+        helper.setFontFromParameters(props->getFont(), props->getFontMagnification());
+        copyMenuItemValue(item, buffer, bufferSize, drawingFlags.isActive());
+        int bl;
+        int valueLeft = layout->valueRight - helper.textExtents(buffer, &bl).x;
+        if(valueLeft <= layout->nameRight) return false;
+
+        // paint over both the old and new value, so nothing of a longer old value is left behind.
+        int clearLeft = internal_min(valueLeft, int(layout->valueLeft));
+        Coord clearWhere(clearLeft, layout->areaTop);
+        Coord clearSize(layout->areaRight - clearLeft, layout->areaHeight);
+        color_t palette[4];
+        prepareItemPalette(entry, isActiveOrEditing(item, drawingFlags), palette);
+        helper.reConfigure(palette, 4, clearWhere, clearSize);
+        if(renderStats && helper.isUsingSubDevice()) renderStats->subDeviceUsed();
+        helper.getDrawable()->setDrawColor(palette[ItemDisplayProperties::BACKGROUND]);
+        helper.getDrawable()->drawBox(helper.offsetLocation(clearWhere), clearSize, true);
+        helper.drawText(helper.offsetLocation(Coord(valueLeft, layout->textTop)), palette[ItemDisplayProperties::TEXT], buffer);
+        helper.endDraw();
+
+        markDirty(clearWhere, clearSize);
+        item->setChanged(displayNumber, false);
+        layout->valueLeft = int16_t(valueLeft);
+        valueOnlyRedraws++;
+        if(renderStats) renderStats->valueOnlyRedraw();
+        return true;
+    }
+
+    void GraphicsDeviceRenderer::recordCacheHitRates() {
+        auto* extents = rootDrawable->getTextExtentsCache();
+        auto* glyphs = rootDrawable->getGlyphCache();
+        uint32_t glyphLookups = glyphs ? glyphs->getHits() + glyphs->getMisses() : 0;
+        renderStats->setCacheHitRates(extents ? uint8_t(extents->getHitRatePercent()) : 0,
+                                      glyphLookups ? uint8_t((uint64_t(glyphs->getHits()) * 100) / glyphLookups) : 0);
+    }
+
     int GraphicsDeviceRenderer::calculateSpaceBetween(const void* font, uint8_t mag, const char* buffer, int start, int end) {
         int bufferLen = (int)strlen(buffer);
         int pos = start;
@@ -166,13 +273,27 @@ namespace tcgfx {
             serlogF4(SER_TCMENU_DEBUG, "item: ", buffer, size.y, where.y);
             helper.getDrawable()->setDrawColor(fg);
             helper.drawText(wh, fg, buffer);
+            int bl;
+            if(valueNeeded && !weAreEditingWithCursor) {
+                drawnLayout.nameHash = hashName(buffer);
+                drawnLayout.nameRight = int16_t(wh.x + helper.textExtents(buffer, &bl).x + drawOffset.x);
+            }
 
             if(valueNeeded) {
                 copyMenuItemValue(pEntry->getMenuItem(), buffer, bufferSize, drawingFlags.isActive());
             } else buffer[0] = 0;
-            int bl;
             int16_t right = where.x + size.x - (helper.textExtents(buffer, &bl).x + padding.right);
             wh.x = right;
+            if(valueNeeded && !weAreEditingWithCursor) {
+                // record where everything was drawn in screen coordinates, so the value can be redrawn on its own.
+                drawnLayout.valueLeft = int16_t(right + drawOffset.x);
+                drawnLayout.valueRight = int16_t(where.x + size.x - padding.right + drawOffset.x);
+                drawnLayout.areaRight = int16_t(where.x + size.x + drawOffset.x);
+                drawnLayout.areaTop = int16_t(where.y + drawOffset.y);
+                drawnLayout.areaHeight = int16_t(size.y);
+                drawnLayout.textTop = int16_t(where.y + padding.top + drawOffset.y);
+                drawnLayoutValid = drawnLayout.valueLeft > drawnLayout.nameRight;
+            }
             if(weAreEditingWithCursor) {
                 helper.getDrawable()->setDrawColor(propertiesFactory.getSelectedColor(ItemDisplayProperties::BACKGROUND, true));
                 auto& hints = menuMgr.getEditorHints();
@@ -454,6 +575,7 @@ namespace tcgfx {
         auto* bgConfig = propertiesFactory.configFor(nullptr, ItemDisplayProperties::COMPTYPE_ITEM);
         helper.getDrawable()->setDrawColor(bgConfig->getColor(ItemDisplayProperties::BACKGROUND));
         helper.getDrawable()->drawBox(Coord(0, endPoint), Coord(width, height-endPoint), true);
+        markDirty(Coord(0, endPoint), Coord(width, height-endPoint));
     }
 
     void GraphicsDeviceRenderer::subMenuRender(MenuItem* rootItem, uint8_t& locRedrawMode, bool& forceDrawWidgets) {
@@ -469,7 +591,7 @@ namespace tcgfx {
             }
             if (titleNeeded && (locRedrawMode == MENUDRAW_COMPLETE_REDRAW || titleEntry->getMenuItem()->isChanged(displayNumber))) {
                 bool active = activeItem == titleEntry->getMenuItem();
-                drawMenuItem(titleEntry, Coord(0, 0), cardLayoutPane->getTitleSize(), DrawingFlags(true, active, menuMgr.getCurrentEditor() == titleEntry->getMenuItem()));
+                drawAndRecordMenuItem(titleEntry, Coord(0, 0), cardLayoutPane->getTitleSize(), DrawingFlags(true, active, menuMgr.getCurrentEditor() == titleEntry->getMenuItem()));
                 forceDrawWidgets = true;
             } else {
                 forceDrawWidgets = true; // we always need to draw the titleWidgets if there is no title item
@@ -477,11 +599,15 @@ namespace tcgfx {
             if (entry->getMenuItem()->isChanged(displayNumber) || locRedrawMode == MENUDRAW_COMPLETE_REDRAW) {
                 getDeviceDrawable()->setDrawColor(entry->getDisplayProperties()->getColor(ItemDisplayProperties::BACKGROUND));
                 getDeviceDrawable()->drawBox(cardLayoutPane->getMenuLocation(), cardLayoutPane->getMenuSize(), true);
+                markDirty(cardLayoutPane->getMenuLocation(), cardLayoutPane->getMenuSize());
+                // the pane has just been cleared, so the item must be drawn in full rather than only its value.
+                auto* layout = findRowLayout(entry->getMenuItem());
+                if(layout) layout->item = nullptr;
                 int offsetY = (cardLayoutPane->getMenuSize().y - int(entry->getHeight())) / 2;
                 Coord menuStart(cardLayoutPane->getMenuLocation().x, cardLayoutPane->getMenuLocation().y + offsetY);
                 Coord menuSize(cardLayoutPane->getMenuSize().x, int(entry->getHeight()));
                 bool active = activeItem == entry->getMenuItem();
-                drawMenuItem(entry, menuStart, menuSize, DrawingFlags(false, active, menuMgr.getCurrentEditor() == entry->getMenuItem()));
+                drawAndRecordMenuItem(entry, menuStart, menuSize, DrawingFlags(false, active, menuMgr.getCurrentEditor() == entry->getMenuItem()));
             }
             cardLayoutPane->prepareAndPaintButtons(this, activeIndex, itemOrderByRow.count(), titleMode != NO_TITLE);
             setTitleOnDisplay(true);
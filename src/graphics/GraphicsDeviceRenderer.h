@@ -19,32 +19,103 @@
 #include "DeviceDrawableHelper.h"
 #include "TcDrawableButton.h"
 #include "MenuTouchScreenEncoder.h"
+#include "GlyphRunCache.h"
 
 #ifndef MINIMUM_CURSOR_SIZE
 #define MINIMUM_CURSOR_SIZE 6
 #endif // MINIMUM_CURSOR_SIZE
 
+// The number of rows whose layout is remembered, so that when only the value changes just the value is redrawn.
+#ifndef TC_VALUE_REDRAW_ROWS
+#define TC_VALUE_REDRAW_ROWS 12
+#endif // TC_VALUE_REDRAW_ROWS
+
 namespace tcgfx {
 
     class CardLayoutPane;
 
     /**
      * This class implements TcUnicode's plot pipeline for tcMenu renderers, as a last resort way of drawing when we
-     * don't have a direct implementation for the hardware.
+     * don't have a direct implementation for the hardware. Pixels next to each other on a row in the same color are
+     * joined together and drawn as a single horizontal span, the span is drawn when the next pixel does not join on,
+     * or when the cursor is used, which tcUnicode does for every glyph.
      */
     class DrawableTextPlotPipeline : public TextPlotPipeline {
     private:
         DeviceDrawable *drawable;
+        GlyphRunCache *glyphCache = nullptr;
         Coord cursor;
+        Coord spanStart;
+        uint32_t spanColor = 0;
+        int spanLength = 0;
     public:
         explicit DrawableTextPlotPipeline(DeviceDrawable *drawable) : drawable(drawable) {}
         void drawPixel(uint16_t x, uint16_t y, uint32_t color) override {
-            drawable->setDrawColor(color);
-            drawable->drawPixel(x, y);
+            if(glyphCache && glyphCache->isCapturing()) {
+                glyphCache->capturePixel(int16_t(x), int16_t(y));
+                return;
+            }
+            if(spanLength && int16_t(y) == spanStart.y && int16_t(x) == spanStart.x + spanLength && color == spanColor) {
+                spanLength++;
+                return;
+            }
+            flush();
+            spanStart = Coord(int16_t(x), int16_t(y));
+            spanColor = color;
+            spanLength = 1;
+        }
+        void setCursor(const Coord& where) override {
+            flush();
+            cursor = where;
+        }
+        Coord getCursor() override {
+            flush();
+            return cursor;
+        }
+
+        /**
+         * Draw any span that is waiting for more pixels to join it.
+         */
+        void flush() {
+            if(spanLength == 0) return;
+            // the font handler is always given colors that are already mapped for the drawable.
+            drawable->setUnderlyingDrawColor(color_t(spanColor));
+            drawable->drawHorizontalSpan(spanStart, spanLength);
+            spanLength = 0;
+        }
+        Coord getDimensions() override {
+            // while capturing, the whole glyph is needed even if it is partly off the display.
+            if(glyphCache && glyphCache->isCapturing()) return Coord(0x7fff, 0x7fff);
+            return drawable->getDisplayDimensions();
         }
-        void setCursor(const Coord& where) override { cursor = where; }
-        Coord getCursor() override { return cursor; }
-        Coord getDimensions() override { return drawable->getDisplayDimensions(); }
+
+        /**
+         * Set the glyph cache that captures pixels when a character is not yet cached.
+         * @param cache the glyph cache
+         */
+        void setGlyphCache(GlyphRunCache* cache) { glyphCache = cache; }
+        GlyphRunCache* getGlyphCache() { return glyphCache; }
+    };
+
+    /**
+     * Remembers where the name and value of a row with the title on the left and value on the right were last drawn,
+     * in screen coordinates. When the row is next drawn with the same position, properties, name and selection, only
+     * the area covered by the old and new values needs to be painted.
+     */
+    struct RowValueLayout {
+        MenuItem* item;
+        ItemDisplayProperties* props;
+        Coord where;
+        Coord size;
+        uint32_t nameHash;
+        int16_t nameRight;
+        int16_t valueLeft;
+        int16_t valueRight;
+        int16_t areaRight;
+        int16_t areaTop;
+        int16_t areaHeight;
+        int16_t textTop;
+        bool active;
     };
 
     /**
@@ -62,7 +133,13 @@ namespace tcgfx {
         DeviceDrawableHelper helper;
         ConfigurableItemDisplayPropertiesFactory propertiesFactory;
         CardLayoutPane* cardLayoutPane = nullptr;
-        bool redrawNeeded = false;
+        DirtyRegions dirtyRegions;
+        RowValueLayout rowLayouts[TC_VALUE_REDRAW_ROWS] = {};
+        RowValueLayout drawnLayout = {};
+        Coord drawOffset;
+        uint32_t valueOnlyRedraws = 0;
+        uint8_t nextRowLayout = 0;
+        bool drawnLayoutValid = false;
     public:
         GraphicsDeviceRenderer(int bufferSize, const char *appTitle, DeviceDrawable *drawable);
 
@@ -156,6 +233,21 @@ namespace tcgfx {
          */
         void setDrawable(DeviceDrawable* drawable);
 
+        /**
+         * Marks an area of the display as changed during this frame, so that drivers which send only the changed areas
+         * to the display include it. Menu items, widgets and the background are marked automatically, call this if you
+         * draw onto the root drawable yourself during rendering.
+         * @param where the top left of the area
+         * @param size the size of the area
+         */
+        void markDirty(const Coord& where, const Coord& size) { dirtyRegions.add(where, size); }
+
+        /** @return the areas that have changed so far in the current frame */
+        const DirtyRegions& getDirtyRegions() const { return dirtyRegions; }
+
+        /** @return the number of times that only the value of a row needed to be redrawn */
+        uint32_t getValueOnlyRedraws() const { return valueOnlyRedraws; }
+
     protected:
         /**
          * Overrides the default implementation to allow for card based layouts, if this is not enabled for the submenu
@@ -177,6 +269,11 @@ namespace tcgfx {
         void drawUpDownItem(GridPositionRowCacheEntry* entry, Coord& where, Coord& size, const DrawingFlags& drawingFlags);
         void drawIconItem(GridPositionRowCacheEntry *pEntry, Coord& where, Coord& size, const DrawingFlags& drawingFlags);
         void drawBorderAndAdjustSize(Coord &where, Coord &size, MenuBorder &border);
+        void prepareItemPalette(GridPositionRowCacheEntry *entry, bool selected, color_t* palette);
+        bool drawValueOnly(GridPositionRowCacheEntry *entry, const Coord& where, const Coord& areaSize, const DrawingFlags& drawingFlags);
+        void rememberRowLayout(GridPositionRowCacheEntry *entry, const Coord& where, const Coord& areaSize, const DrawingFlags& drawingFlags);
+        RowValueLayout* findRowLayout(MenuItem* item);
+        void recordCacheHitRates();
 
         DrawableIcon *getStateIndicatorIcon(GridPositionRowCacheEntry *entry);
     };
@@ -32,6 +32,7 @@ void MenuTouchScreenManager::sendEvent(float locationX, float locationY, float t
         return;
     }
 
+    renderer->menuAltered();
     lastCoord = Coord((int)(float(renderer->getWidth()) * locationX), (int)(float(renderer->getHeight()) * locationY));
     if(touched == TOUCHED) {
         currentlySelected = renderer->findMenuEntryAndDimensions(lastCoord, localStart, localSize);
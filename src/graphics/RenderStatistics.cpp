@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "RenderStatistics.h"
+
+using namespace tcgfx;
+
+RenderStatistics::RenderStatistics(uint8_t maxFrames) : current{}, displayItem(nullptr), frameStart(0), totalFrames(0),
+        completeRedraws(0), lastDisplayMillis(0), maxFrames(maxFrames ? maxFrames : 1), framesStored(0), nextFrame(0),
+        textExtentsHitPercent(0), glyphCacheHitPercent(0), displayItemOnScreen(false) {
+    frames = new FrameStatistics[this->maxFrames];
+}
+
+RenderStatistics::~RenderStatistics() {
+    delete[] frames;
+}
+
+void RenderStatistics::startFrame(bool completeRedraw) {
+    current = FrameStatistics{};
+    current.completeRedraw = completeRedraw;
+    displayItemOnScreen = false;
+    frameStart = micros();
+}
+
+void RenderStatistics::endFrame() {
+    current.frameMicros = micros() - frameStart;
+    frames[nextFrame] = current;
+    nextFrame = (nextFrame + 1) % maxFrames;
+    if(framesStored < maxFrames) framesStored++;
+    totalFrames++;
+    if(current.completeRedraw) completeRedraws++;
+
+    if(displayItemOnScreen && millis() - lastDisplayMillis >= 1000) {
+        lastDisplayMillis = millis();
+        displayItem->setChanged(true);
+    }
+}
+
+const FrameStatistics& RenderStatistics::getFrame(uint8_t age) const {
+    if(age >= framesStored) age = framesStored ? framesStored - 1 : 0;
+    return frames[(nextFrame + maxFrames - 1 - age) % maxFrames];
+}
+
+uint32_t RenderStatistics::getMetric(const FrameStatistics& frame, RenderMetric metric) {
+    switch(metric) {
+        case METRIC_FRAME_MICROS: return frame.frameMicros;
+        case METRIC_DRAW_ITEM_MICROS: return frame.drawItemMicros;
+        case METRIC_ITEMS_DRAWN: return frame.itemsDrawn;
+        case METRIC_ITEMS_SKIPPED: return frame.itemsSkipped;
+        case METRIC_SUB_DEVICES: return frame.subDevices;
+        case METRIC_VALUE_ONLY_REDRAWS: return frame.valueOnlyRedraws;
+        default: return 0;
+    }
+}
+
+uint32_t RenderStatistics::getAverage(RenderMetric metric) const {
+    if(framesStored == 0) return 0;
+    uint64_t total = 0;
+    for(uint8_t i = 0; i < framesStored; i++) {
+        total += getMetric(frames[i], metric);
+    }
+    return uint32_t(total / framesStored);
+}
+
+uint32_t RenderStatistics::getMaximum(RenderMetric metric) const {
+    uint32_t largest = 0;
+    for(uint8_t i = 0; i < framesStored; i++) {
+        largest = internal_max(largest, getMetric(frames[i], metric));
+    }
+    return largest;
+}
+
+void RenderStatistics::histogram(RenderMetric metric, const uint32_t* upperLimits, uint16_t* counts, uint8_t buckets) const {
+    if(buckets == 0) return;
+    for(uint8_t b = 0; b < buckets; b++) counts[b] = 0;
+
+    for(uint8_t i = 0; i < framesStored; i++) {
+        uint32_t value = getMetric(frames[i], metric);
+        uint8_t b = 0;
+        while(b < buckets - 1 && value >= upperLimits[b]) b++;
+        counts[b]++;
+    }
+}
+
+void RenderStatistics::reset() {
+    framesStored = 0;
+    nextFrame = 0;
+    totalFrames = 0;
+    completeRedraws = 0;
+}
+
+namespace tcgfx {
+
+    const char renderStatsNamePgm[] PROGMEM = "Render Stats";
+
+    // writes micros as milliseconds to one decimal place, followed by "ms"
+    static void appendMillis(char* buffer, uint32_t micros, int bufferSize) {
+        fastltoa(buffer, long(micros / 1000), 5, NOT_PADDED, bufferSize);
+        appendChar(buffer, '.', bufferSize);
+        fastltoa(buffer, long((micros % 1000) / 100), 1, NOT_PADDED, bufferSize);
+        appendChar(buffer, 'm', bufferSize);
+        appendChar(buffer, 's', bufferSize);
+    }
+
+    int renderStatisticsRenderingFn(RuntimeMenuItem *item, uint8_t row, RenderFnMode mode, char *buffer, int bufferSize) {
+        auto* statsItem = reinterpret_cast<RenderStatisticsMenuItem*>(item);
+        switch (mode) {
+            case RENDERFN_NAME:
+                safeProgCpy(buffer, renderStatsNamePgm, bufferSize);
+                return true;
+            case RENDERFN_VALUE: {
+                buffer[0] = 0;
+                auto* stats = statsItem->getStatistics();
+                if(stats == nullptr) return true;
+                appendMillis(buffer, stats->getAverage(METRIC_FRAME_MICROS), bufferSize);
+                appendChar(buffer, ' ', bufferSize);
+                appendMillis(buffer, stats->getMaximum(METRIC_FRAME_MICROS), bufferSize);
+                appendChar(buffer, ' ', bufferSize);
+                auto drawn = stats->getAverage(METRIC_ITEMS_DRAWN);
+                fastltoa(buffer, long(drawn), 3, NOT_PADDED, bufferSize);
+                appendChar(buffer, '/', bufferSize);
+                fastltoa(buffer, long(drawn + stats->getAverage(METRIC_ITEMS_SKIPPED)), 3, NOT_PADDED, bufferSize);
+                return true;
+            }
+            case RENDERFN_EEPROM_POS:
+                return -1;
+            default:
+                return false;
+        }
+    }
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file RenderStatistics.h
+ * @brief per frame rendering statistics with a rolling history, and a menu item that can show them.
+ */
+
+#ifndef TCMENU_RENDERSTATISTICS_H
+#define TCMENU_RENDERSTATISTICS_H
+
+#include <PlatformDetermination.h>
+#include <RuntimeMenuItem.h>
+
+// The number of frames that are kept in the rolling history.
+#ifndef TC_RENDER_STATS_FRAMES
+#define TC_RENDER_STATS_FRAMES 32
+#endif
+
+namespace tcgfx {
+
+    /**
+     * The statistics recorded for a single frame. Counts stop at 255 rather than wrapping.
+     */
+    struct FrameStatistics {
+        /** the wall time taken by the whole frame in microseconds */
+        uint32_t frameMicros;
+        /** the time spent drawing menu items in microseconds */
+        uint32_t drawItemMicros;
+        /** the number of menu items that were drawn */
+        uint8_t itemsDrawn;
+        /** the number of visible menu items that were not drawn because they had not changed */
+        uint8_t itemsSkipped;
+        /** the number of times a sub device, such as a sprite or canvas, was used to draw */
+        uint8_t subDevices;
+        /** the number of items where only the value needed to be drawn */
+        uint8_t valueOnlyRedraws;
+        /** true when the frame was a complete redraw */
+        bool completeRedraw;
+    };
+
+    /**
+     * The values in FrameStatistics that can be averaged and put into histograms.
+     */
+    enum RenderMetric : uint8_t {
+        METRIC_FRAME_MICROS, METRIC_DRAW_ITEM_MICROS, METRIC_ITEMS_DRAWN, METRIC_ITEMS_SKIPPED, METRIC_SUB_DEVICES,
+        METRIC_VALUE_ONLY_REDRAWS
+    };
+
+    /**
+     * Collects statistics about each frame that a graphical renderer draws, keeping the most recent frames in a rolling
+     * history that can be averaged, or split into a histogram, to compare the cost of themes and display drivers on
+     * the device. Create it by calling enableRenderStatistics on the renderer, there is no cost when it is not
+     * enabled. The renderer also passes on the hit rates of any text caches that the drawable has.
+     */
+    class RenderStatistics {
+    private:
+        FrameStatistics* frames;
+        FrameStatistics current;
+        MenuItem* displayItem;
+        uint32_t frameStart;
+        uint32_t totalFrames;
+        uint32_t completeRedraws;
+        uint32_t lastDisplayMillis;
+        uint8_t maxFrames;
+        uint8_t framesStored;
+        uint8_t nextFrame;
+        uint8_t textExtentsHitPercent;
+        uint8_t glyphCacheHitPercent;
+        bool displayItemOnScreen;
+    public:
+        /**
+         * Create the statistics with a history of a given number of frames.
+         * @param maxFrames the number of frames to keep in the history
+         */
+        explicit RenderStatistics(uint8_t maxFrames = TC_RENDER_STATS_FRAMES);
+        ~RenderStatistics();
+
+        /** called by the renderer as a frame starts, @param completeRedraw true if everything is being drawn */
+        void startFrame(bool completeRedraw);
+
+        /** called by the renderer once the frame has finished, it is then added to the history */
+        void endFrame();
+
+        /** called by the renderer each time an item is drawn, @param micros the time taken to draw it */
+        void itemDrawn(uint32_t micros) {
+            if(current.itemsDrawn != 0xff) current.itemsDrawn++;
+            current.drawItemMicros += micros;
+        }
+
+        /** called by the renderer for each item that is within the drawn area, whether it is drawn or not */
+        void itemOnScreen(MenuItem* item) { if(item == displayItem) displayItemOnScreen = true; }
+
+        /** called by the renderer for each visible item that did not need drawing */
+        void itemSkipped() { if(current.itemsSkipped != 0xff) current.itemsSkipped++; }
+
+        /** called by the renderer each time it draws onto a sub device */
+        void subDeviceUsed() { if(current.subDevices != 0xff) current.subDevices++; }
+
+        /** called by the renderer when only the value of an item was drawn */
+        void valueOnlyRedraw() { if(current.valueOnlyRedraws != 0xff) current.valueOnlyRedraws++; }
+
+        /**
+         * Called by the renderer with the latest hit rates of the text caches, 0 is given when a cache is not in use.
+         * @param textExtents the text extents cache hit rate as a percentage
+         * @param glyphs the glyph cache hit rate as a percentage
+         */
+        void setCacheHitRates(uint8_t textExtents, uint8_t glyphs) {
+            textExtentsHitPercent = textExtents;
+            glyphCacheHitPercent = glyphs;
+        }
+
+        /**
+         * Gets a frame from the history.
+         * @param age 0 for the most recent frame, 1 for the one before it, and so on up to getFramesStored() - 1
+         * @return the statistics for that frame
+         */
+        const FrameStatistics& getFrame(uint8_t age) const;
+
+        /** @return the number of frames in the history, at most the size it was created with */
+        uint8_t getFramesStored() const { return framesStored; }
+
+        /**
+         * Gets one of the values from a frame
+         * @param frame the frame statistics
+         * @param metric the value to get
+         * @return the value
+         */
+        static uint32_t getMetric(const FrameStatistics& frame, RenderMetric metric);
+
+        /** @return the average of a metric over the frames in the history, 0 if there are none */
+        uint32_t getAverage(RenderMetric metric) const;
+
+        /** @return the largest value of a metric over the frames in the history, 0 if there are none */
+        uint32_t getMaximum(RenderMetric metric) const;
+
+        /**
+         * Counts the frames in the history by the value of a metric. Bucket i counts values below upperLimits[i] that
+         * are not in an earlier bucket, and the final bucket counts everything else.
+         * @param metric the value to split into buckets
+         * @param upperLimits the ascending limits of each bucket apart from the last, so buckets - 1 entries
+         * @param counts filled in with the number of frames in each bucket, so buckets entries
+         * @param buckets the number of buckets
+         */
+        void histogram(RenderMetric metric, const uint32_t* upperLimits, uint16_t* counts, uint8_t buckets) const;
+
+        /** @return the number of frames drawn since the statistics were reset */
+        uint32_t getTotalFrames() const { return totalFrames; }
+
+        /** @return the number of complete redraws since the statistics were reset */
+        uint32_t getCompleteRedraws() const { return completeRedraws; }
+
+        /** @return the latest text extents cache hit rate as a percentage */
+        uint8_t getTextExtentsHitPercent() const { return textExtentsHitPercent; }
+
+        /** @return the latest glyph cache hit rate as a percentage */
+        uint8_t getGlyphCacheHitPercent() const { return glyphCacheHitPercent; }
+
+        /**
+         * Sets a menu item that shows these statistics. While the item is on screen it is marked as changed once a
+         * second, so a renderer that is event driven draws a frame every second rather than going idle, and that
+         * frame includes the time taken to draw the item itself. When the item is not on screen it is left alone.
+         * @param item the item that shows the statistics, or nullptr for none
+         */
+        void setDisplayItem(MenuItem* item) { displayItem = item; }
+
+        /** clear the history and all totals */
+        void reset();
+    };
+
+    /**
+     * The rendering function for RenderStatisticsMenuItem, the value is the average and maximum frame time and the
+     * average items drawn out of the visible items.
+     */
+    int renderStatisticsRenderingFn(RuntimeMenuItem *item, uint8_t row, RenderFnMode mode, char *buffer, int bufferSize);
+
+    /**
+     * A read only menu item that shows a summary of the render statistics, add it to a diagnostics menu to see render
+     * cost on the device. The value is in the form "4.2ms 9.1ms 3/15", being the average frame time, the maximum
+     * frame time, and the average items drawn out of the visible items.
+     */
+    class RenderStatisticsMenuItem : public RuntimeMenuItem {
+    private:
+        RenderStatistics* statistics;
+    public:
+        /**
+         * Create the menu item for a set of statistics, usually those from getRenderStatistics on the renderer.
+         * @param statistics the statistics to show
+         * @param id the menu item id
+         * @param next the next menu item
+         */
+        RenderStatisticsMenuItem(RenderStatistics* statistics, menuid_t id, MenuItem* next = nullptr)
+                : RuntimeMenuItem(MENUTYPE_RUNTIME_VALUE, id, renderStatisticsRenderingFn, 0, 1, next), statistics(statistics) {
+            setReadOnly(true);
+            setLocalOnly(true);
+            if(statistics) statistics->setDisplayItem(this);
+        }
+
+        RenderStatistics* getStatistics() { return statistics; }
+    };
+}
+
+#endif //TCMENU_RENDERSTATISTICS_H
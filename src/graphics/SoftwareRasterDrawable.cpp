@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "SoftwareRasterDrawable.h"
+
+using namespace tcgfx;
+
+// the most edges of a filled polygon that can cross a single row
+#define MAX_POLYGON_CROSSINGS 16
+
+void SoftwareRasterDrawable::clippedSpan(int x, int y, int len, color_t color) {
+    if(y < 0 || y >= dimensions.y) return;
+    if(x < 0) {
+        len += x;
+        x = 0;
+    }
+    if(x + len > dimensions.x) len = dimensions.x - x;
+    if(len > 0) writeSpan(x, y, len, color);
+}
+
+void SoftwareRasterDrawable::drawPixel(uint16_t x, uint16_t y) {
+    if(x < uint16_t(dimensions.x) && y < uint16_t(dimensions.y)) writeSpan(x, y, 1, drawColor);
+}
+
+void SoftwareRasterDrawable::drawBox(const Coord &where, const Coord &size, bool filled) {
+    if(size.x <= 0 || size.y <= 0) return;
+    if(filled) {
+        for(int y = where.y; y < where.y + size.y; y++) {
+            clippedSpan(where.x, y, size.x, drawColor);
+        }
+        return;
+    }
+
+    clippedSpan(where.x, where.y, size.x, drawColor);
+    clippedSpan(where.x, where.y + size.y - 1, size.x, drawColor);
+    for(int y = where.y + 1; y < where.y + size.y - 1; y++) {
+        clippedSpan(where.x, y, 1, drawColor);
+        clippedSpan(where.x + size.x - 1, y, 1, drawColor);
+    }
+}
+
+void SoftwareRasterDrawable::drawCircle(const Coord &where, int radius, bool filled) {
+    // midpoint circle, each step gives the points in all eight octants.
+    int x = radius;
+    int y = 0;
+    int err = 1 - radius;
+    while(x >= y) {
+        if(filled) {
+            clippedSpan(where.x - x, where.y + y, x * 2 + 1, drawColor);
+            clippedSpan(where.x - x, where.y - y, x * 2 + 1, drawColor);
+            clippedSpan(where.x - y, where.y + x, y * 2 + 1, drawColor);
+            clippedSpan(where.x - y, where.y - x, y * 2 + 1, drawColor);
+        } else {
+            clippedSpan(where.x + x, where.y + y, 1, drawColor);
+            clippedSpan(where.x - x, where.y + y, 1, drawColor);
+            clippedSpan(where.x + x, where.y - y, 1, drawColor);
+            clippedSpan(where.x - x, where.y - y, 1, drawColor);
+            clippedSpan(where.x + y, where.y + x, 1, drawColor);
+            clippedSpan(where.x - y, where.y + x, 1, drawColor);
+            clippedSpan(where.x + y, where.y - x, 1, drawColor);
+            clippedSpan(where.x - y, where.y - x, 1, drawColor);
+        }
+        y++;
+        if(err < 0) {
+            err += 2 * y + 1;
+        } else {
+            x--;
+            err += 2 * (y - x) + 1;
+        }
+    }
+}
+
+void SoftwareRasterDrawable::drawLine(int x0, int y0, int x1, int y1) {
+    if(y0 == y1) {
+        clippedSpan(internal_min(x0, x1), y0, abs(x1 - x0) + 1, drawColor);
+        return;
+    }
+
+    int dx = abs(x1 - x0);
+    int dy = -abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    while(true) {
+        clippedSpan(x0, y0, 1, drawColor);
+        if(x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if(e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if(e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void SoftwareRasterDrawable::fillPolygon(const Coord points[], int numPoints) {
+    int minY = points[0].y, maxY = points[0].y;
+    for(int i = 1; i < numPoints; i++) {
+        minY = internal_min(minY, int(points[i].y));
+        maxY = internal_max(maxY, int(points[i].y));
+    }
+    minY = internal_max(minY, 0);
+    maxY = internal_min(maxY, dimensions.y - 1);
+
+    // even odd scan line fill, the edges themselves are drawn afterwards so that the outline is always complete.
+    int crossings[MAX_POLYGON_CROSSINGS];
+    for(int y = minY; y <= maxY; y++) {
+        int count = 0;
+        for(int i = 0; i < numPoints && count < MAX_POLYGON_CROSSINGS; i++) {
+            const Coord& a = points[i];
+            const Coord& b = points[(i + 1) % numPoints];
+            if(a.y == b.y) continue;
+            int top = internal_min(a.y, b.y);
+            int bottom = internal_max(a.y, b.y);
+            if(y < top || y >= bottom) continue;
+            crossings[count++] = a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y);
+        }
+
+        // insertion sort, there are very few crossings on any row
+        for(int i = 1; i < count; i++) {
+            int v = crossings[i];
+            int j = i - 1;
+            while(j >= 0 && crossings[j] > v) {
+                crossings[j + 1] = crossings[j];
+                j--;
+            }
+            crossings[j + 1] = v;
+        }
+
+        for(int i = 0; i + 1 < count; i += 2) {
+            clippedSpan(crossings[i], y, crossings[i + 1] - crossings[i] + 1, drawColor);
+        }
+    }
+}
+
+void SoftwareRasterDrawable::drawPolygon(const Coord points[], int numPoints, bool filled) {
+    if(numPoints < 2) return;
+    if(filled && numPoints > 2) fillPolygon(points, numPoints);
+
+    for(int i = 0; i < numPoints; i++) {
+        const Coord& next = points[(i + 1) % numPoints];
+        drawLine(points[i].x, points[i].y, next.x, next.y);
+        if(numPoints == 2) break;
+    }
+}
+
+void SoftwareRasterDrawable::drawMonoBitmap(const Coord &where, const Coord &size, const uint8_t *data, bool lsbFirst) {
+    int bytesPerRow = (size.x + 7) / 8;
+    for(int y = 0; y < size.y; y++) {
+        const uint8_t* row = &data[y * bytesPerRow];
+        int runStart = 0;
+        bool runSet = false;
+        for(int x = 0; x <= size.x; x++) {
+            bool set = false;
+            if(x < size.x) {
+                uint8_t b = pgm_read_byte(&row[x / 8]);
+                set = lsbFirst ? (b >> (x & 7)) & 1 : (b >> (7 - (x & 7))) & 1;
+            }
+            // pixels of the same value are written together as a single span
+            if(x == size.x || (x != 0 && set != runSet)) {
+                clippedSpan(where.x + runStart, where.y + y, x - runStart, runSet ? drawColor : backgroundColor);
+                runStart = x;
+            }
+            runSet = set;
+        }
+    }
+}
+
+void SoftwareRasterDrawable::drawXBitmap(const Coord &where, const Coord &size, const uint8_t *data) {
+    drawMonoBitmap(where, size, data, true);
+}
+
+void SoftwareRasterDrawable::drawPaletteBitmap(const Coord &where, const Coord &size, const uint8_t *data, const color_t* palette, int bpp) {
+    int pixelsPerByte = 8 / bpp;
+    int bytesPerRow = (size.x + pixelsPerByte - 1) / pixelsPerByte;
+    uint8_t mask = (1 << bpp) - 1;
+    for(int y = 0; y < size.y; y++) {
+        const uint8_t* row = &data[y * bytesPerRow];
+        for(int x = 0; x < size.x; x++) {
+            uint8_t b = pgm_read_byte(&row[x / pixelsPerByte]);
+            int shift = 8 - bpp - ((x % pixelsPerByte) * bpp);
+            clippedSpan(where.x + x, where.y + y, 1, getUnderlyingColor(palette[(b >> shift) & mask]));
+        }
+    }
+}
+
+void SoftwareRasterDrawable::drawBitmap(const Coord &where, const DrawableIcon *icon, bool selected) {
+    auto data = icon->getIcon(selected);
+    auto size = icon->getDimensions();
+    switch(icon->getIconType()) {
+        case DrawableIcon::ICON_XBITMAP:
+            drawMonoBitmap(where, size, data, true);
+            break;
+        case DrawableIcon::ICON_MONO:
+            drawMonoBitmap(where, size, data, false);
+            break;
+        case DrawableIcon::ICON_PALLETE_2BPP:
+            drawPaletteBitmap(where, size, data, icon->getPalette(), 2);
+            break;
+        case DrawableIcon::ICON_PALLETE_4BPP:
+            drawPaletteBitmap(where, size, data, icon->getPalette(), 4);
+            break;
+        case DrawableIcon::ICON_NATIVE: {
+            auto pixels = reinterpret_cast<const color_t*>(data);
+            for(int y = 0; y < size.y; y++) {
+                for(int x = 0; x < size.x; x++) {
+                    color_t col;
+                    memcpy_P(&col, &pixels[y * size.x + x], sizeof col);
+                    clippedSpan(where.x + x, where.y + y, 1, col);
+                }
+            }
+            break;
+        }
+    }
+}
+
+Coord SoftwareRasterDrawable::internalTextExtents(const void *font, int mag, const char *text, int *baseline) {
+    if(baseline) *baseline = 0;
+    return Coord(0, 0);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file SoftwareRasterDrawable.h
+ * @brief a device drawable that rasterises all drawing primitives in software onto horizontal spans of pixels.
+ */
+
+#ifndef TCMENU_SOFTWARERASTERDRAWABLE_H
+#define TCMENU_SOFTWARERASTERDRAWABLE_H
+
+#include <PlatformDetermination.h>
+#include "DeviceDrawable.h"
+
+namespace tcgfx {
+
+    /**
+     * A device drawable that implements all the drawing primitives in software, turning each of them into horizontal
+     * spans of pixels that are already clipped to the display. Extend it and implement `writeSpan` to write the
+     * pixels into whatever storage you have, such as a framebuffer in memory. Text is only supported by tcUnicode,
+     * enable it on the drawable before use, as there are no native fonts.
+     *
+     * Palette and XBM icons are supported, palette images are packed with the leftmost pixel in the highest bits of
+     * each byte, and each row starts on a new byte. Native icons are an array of color_t values.
+     */
+    class SoftwareRasterDrawable : public DeviceDrawable {
+    protected:
+        Coord dimensions;
+    public:
+        explicit SoftwareRasterDrawable(const Coord& dimensions) : dimensions(dimensions) {}
+
+        Coord getDisplayDimensions() override { return dimensions; }
+
+        void drawPixel(uint16_t x, uint16_t y) override;
+        void drawBox(const Coord &where, const Coord &size, bool filled) override;
+        void drawCircle(const Coord &where, int radius, bool filled) override;
+        void drawPolygon(const Coord points[], int numPoints, bool filled) override;
+        void drawXBitmap(const Coord &where, const Coord &size, const uint8_t *data) override;
+        void drawBitmap(const Coord &where, const DrawableIcon *icon, bool selected) override;
+        void drawHorizontalSpan(const Coord& where, int width) override { clippedSpan(where.x, where.y, width, drawColor); }
+
+        /** there are no native fonts, so nothing is drawn, use tcUnicode instead */
+        void internalDrawText(const Coord &where, const void *font, int mag, const char *text) override {}
+        Coord internalTextExtents(const void *font, int mag, const char *text, int *baseline) override;
+
+    protected:
+        /**
+         * Write a horizontal run of pixels in a single color, the run is always entirely within the display.
+         * @param x the starting x position
+         * @param y the y position
+         * @param len the number of pixels, at least 1
+         * @param color the color of the pixels, as returned by getUnderlyingColor
+         */
+        virtual void writeSpan(int x, int y, int len, color_t color) = 0;
+
+        /**
+         * Clips a horizontal run of pixels to the display and then writes it if anything remains.
+         * @param x the starting x position, which may be off the display
+         * @param y the y position, which may be off the display
+         * @param len the number of pixels
+         * @param color the color of the pixels
+         */
+        void clippedSpan(int x, int y, int len, color_t color);
+
+        /**
+         * Draws a bitmap that is stored one bit per pixel, with set bits in the draw color and clear bits in the
+         * background color.
+         * @param where the top left position
+         * @param size the size of the bitmap
+         * @param data the bitmap data
+         * @param lsbFirst true for XBM where the leftmost pixel is the lowest bit, false when it is the highest
+         */
+        void drawMonoBitmap(const Coord &where, const Coord &size, const uint8_t *data, bool lsbFirst);
+
+    private:
+        void drawLine(int x0, int y0, int x1, int y1);
+        void fillPolygon(const Coord points[], int numPoints);
+        void drawPaletteBitmap(const Coord &where, const Coord &size, const uint8_t *data, const color_t* palette, int bpp);
+    };
+}
+
+#endif //TCMENU_SOFTWARERASTERDRAWABLE_H
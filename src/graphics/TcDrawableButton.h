@@ -124,6 +124,12 @@ namespace tcgfx {
          */
         bool isDirty() const { return bitRead(flags, DRAW_BUTTON_FLAG_IS_DIRTY); }
 
+        /** @return the top left of the button */
+        const Coord& getPosition() const { return where; }
+
+        /** @return the size of the button */
+        const Coord& getSize() const { return size; }
+
         /**
          * If the button is an icon button
          * @return true if icon, false if text
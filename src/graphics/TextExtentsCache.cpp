@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "TextExtentsCache.h"
+
+using namespace tcgfx;
+
+TextExtentsCache::TextExtentsCache(uint8_t maxEntries) : hits(0), misses(0), useCounter(0), maxEntries(maxEntries) {
+    entries = new CachedExtents[maxEntries];
+    clear();
+}
+
+TextExtentsCache::~TextExtentsCache() {
+    delete[] entries;
+}
+
+void TextExtentsCache::clear() {
+    for(uint8_t i = 0; i < maxEntries; i++) {
+        entries[i].font = nullptr;
+    }
+}
+
+uint32_t TextExtentsCache::hashText(const char* text, uint16_t& length) {
+    // FNV-1a, the length is kept alongside to make a false match even less likely.
+    uint32_t hash = 2166136261UL;
+    length = 0;
+    while(*text) {
+        hash ^= (uint8_t)*text++;
+        hash *= 16777619UL;
+        length++;
+    }
+    return hash;
+}
+
+bool TextExtentsCache::find(const void* font, int mag, const char* text, Coord& extents, int* baseline) {
+    uint16_t length;
+    uint32_t hash = hashText(text, length);
+    for(uint8_t i = 0; i < maxEntries; i++) {
+        CachedExtents& entry = entries[i];
+        if(entry.font == font && entry.hash == hash && entry.length == length && entry.mag == uint8_t(mag)) {
+            entry.lastUsed = ++useCounter;
+            extents = entry.extents;
+            if(baseline) *baseline = entry.baseline;
+            hits++;
+            return true;
+        }
+    }
+    misses++;
+    return false;
+}
+
+void TextExtentsCache::add(const void* font, int mag, const char* text, const Coord& extents, int baseline) {
+    if(font == nullptr) return;
+    CachedExtents* slot = &entries[0];
+    for(uint8_t i = 0; i < maxEntries; i++) {
+        if(entries[i].font == nullptr) {
+            slot = &entries[i];
+            break;
+        }
+        if(uint16_t(useCounter - entries[i].lastUsed) > uint16_t(useCounter - slot->lastUsed)) slot = &entries[i];
+    }
+    slot->font = font;
+    slot->hash = hashText(text, slot->length);
+    slot->mag = uint8_t(mag);
+    slot->extents = extents;
+    slot->baseline = int16_t(baseline);
+    slot->lastUsed = ++useCounter;
+}
+
+uint8_t TextExtentsCache::getHitRatePercent() const {
+    uint32_t total = hits + misses;
+    return total ? uint8_t((float(hits) * 100.0F) / float(total)) : 0;
+}
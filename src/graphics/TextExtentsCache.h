@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file TextExtentsCache.h
+ * @brief a small least recently used cache of text measurements, to avoid measuring the same text on every frame.
+ */
+
+#ifndef TCMENU_TEXTEXTENTSCACHE_H
+#define TCMENU_TEXTEXTENTSCACHE_H
+
+#include <PlatformDetermination.h>
+#include "DrawingPrimitives.h"
+
+// The number of text measurements that are remembered by default.
+#ifndef TC_TEXT_EXTENTS_CACHE_SIZE
+#define TC_TEXT_EXTENTS_CACHE_SIZE 16
+#endif
+
+namespace tcgfx {
+
+    /**
+     * Remembers the extents and baseline of recently measured text, keyed by the font, magnification and a hash of
+     * the text along with its length. Menu items are usually measured every time they are drawn, and mostly with the
+     * same text, so this saves walking every glyph a second time. When full, the least recently used entry is
+     * replaced. The cache must be cleared when the meaning of a font pointer changes, for example when the font
+     * handler is replaced, the drawable does this for you.
+     */
+    class TextExtentsCache {
+    public:
+        struct CachedExtents {
+            const void* font;
+            uint32_t hash;
+            Coord extents;
+            int16_t baseline;
+            uint16_t length;
+            uint16_t lastUsed;
+            uint8_t mag;
+        };
+    private:
+        CachedExtents* entries;
+        uint32_t hits;
+        uint32_t misses;
+        uint16_t useCounter;
+        uint8_t maxEntries;
+    public:
+        /**
+         * Create a cache that can hold the given number of measurements
+         * @param maxEntries the number of entries
+         */
+        explicit TextExtentsCache(uint8_t maxEntries = TC_TEXT_EXTENTS_CACHE_SIZE);
+        ~TextExtentsCache();
+
+        /**
+         * Look up a measurement, counting it as a hit or a miss.
+         * @param font the font
+         * @param mag the font magnification
+         * @param text the text that was measured
+         * @param extents filled in with the extents when found
+         * @param baseline if not null, filled in with the baseline when found
+         * @return true if found, otherwise false
+         */
+        bool find(const void* font, int mag, const char* text, Coord& extents, int* baseline);
+
+        /**
+         * Add a measurement, replacing the least recently used entry if there is no space.
+         * @param font the font
+         * @param mag the font magnification
+         * @param text the text that was measured
+         * @param extents the extents of the text
+         * @param baseline the baseline of the text
+         */
+        void add(const void* font, int mag, const char* text, const Coord& extents, int baseline);
+
+        /** remove all measurements, for example after the fonts have changed */
+        void clear();
+
+        /** @return the number of measurements that were found in the cache */
+        uint32_t getHits() const { return hits; }
+
+        /** @return the number of measurements that were not in the cache */
+        uint32_t getMisses() const { return misses; }
+
+        /** @return the percentage of lookups that were found in the cache */
+        uint8_t getHitRatePercent() const;
+
+        /** reset the hit and miss counts */
+        void resetStatistics() { hits = misses = 0; }
+
+    private:
+        static uint32_t hashText(const char* text, uint16_t& length);
+    };
+}
+
+#endif //TCMENU_TEXTEXTENTSCACHE_H
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "TileHashingDrawable.h"
+
+using namespace tcgfx;
+
+#define TILE_STATE_SENT 0x01
+#define TILE_STATE_CHECKED 0x02
+
+TileHashingDrawable::TileHashingDrawable(DeviceDrawable* underlying, uint8_t tileSize)
+        : SoftwareRasterDrawable(underlying->getDisplayDimensions()), underlying(underlying), pixelsPushed(0),
+          tilesPushed(0), tilesChecked(0), tileSize(tileSize) {
+    tilesAcross = (dimensions.x + tileSize - 1) / tileSize;
+    tilesDown = (dimensions.y + tileSize - 1) / tileSize;
+    frame = new color_t[long(dimensions.x) * dimensions.y];
+    memset(frame, 0, sizeof(color_t) * dimensions.x * dimensions.y);
+    tileHashes = new uint32_t[tilesAcross * tilesDown];
+    tileState = new uint8_t[tilesAcross * tilesDown];
+    invalidate();
+}
+
+TileHashingDrawable::~TileHashingDrawable() {
+    delete[] frame;
+    delete[] tileHashes;
+    delete[] tileState;
+}
+
+void TileHashingDrawable::invalidate() {
+    memset(tileState, 0, tilesAcross * tilesDown);
+}
+
+void TileHashingDrawable::writeSpan(int x, int y, int len, color_t color) {
+    color_t* pixel = &frame[y * dimensions.x + x];
+    while(len--) *pixel++ = color;
+}
+
+void TileHashingDrawable::transaction(bool isStarting, bool redrawNeeded) {
+    // nothing reaches the underlying display until a transaction ends with tiles that have actually changed.
+    if(isStarting || !redrawNeeded) return;
+    DirtyRegions everything;
+    everything.add(Coord(0, 0), dimensions);
+    endTransaction(everything);
+}
+
+void TileHashingDrawable::endTransaction(const DirtyRegions& changed) {
+    DirtyRegions pushed;
+    bool started = false;
+    for(uint8_t i = 0; i < changed.getCount(); i++) {
+        checkTiles(changed.getRegion(i).where, changed.getRegion(i).size, pushed, started);
+    }
+
+    for(int i = 0; i < tilesAcross * tilesDown; i++) {
+        tileState[i] &= ~TILE_STATE_CHECKED;
+    }
+
+    if(started) underlying->endDraw(pushed);
+}
+
+void TileHashingDrawable::checkTiles(const Coord& where, const Coord& size, DirtyRegions& pushed, bool& started) {
+    int firstX = internal_max(0, int(where.x)) / tileSize;
+    int firstY = internal_max(0, int(where.y)) / tileSize;
+    int lastX = internal_min(int(tilesAcross) - 1, (where.x + size.x - 1) / tileSize);
+    int lastY = internal_min(int(tilesDown) - 1, (where.y + size.y - 1) / tileSize);
+
+    for(int ty = firstY; ty <= lastY; ty++) {
+        for(int tx = firstX; tx <= lastX; tx++) {
+            // a tile can be covered by more than one region, it only needs checking once.
+            uint8_t& state = tileState[ty * tilesAcross + tx];
+            if(state & TILE_STATE_CHECKED) continue;
+            state |= TILE_STATE_CHECKED;
+            tilesChecked++;
+
+            uint32_t hash = hashTile(tx, ty);
+            if((state & TILE_STATE_SENT) && tileHashes[ty * tilesAcross + tx] == hash) continue;
+
+            if(!started) {
+                underlying->startDraw();
+                started = true;
+            }
+            pushTile(tx, ty);
+            tileHashes[ty * tilesAcross + tx] = hash;
+            state |= TILE_STATE_SENT;
+            // tiles at the right and bottom edges can be partial, the region must not go past the display.
+            int tileX = tx * tileSize;
+            int tileY = ty * tileSize;
+            pushed.add(Coord(tileX, tileY), Coord(internal_min(int(tileSize), dimensions.x - tileX),
+                                                  internal_min(int(tileSize), dimensions.y - tileY)));
+        }
+    }
+}
+
+uint32_t TileHashingDrawable::hashTile(int tileX, int tileY) {
+    // FNV-1a over the color of each pixel, it is quick and spreads small differences well.
+    uint32_t hash = 2166136261UL;
+    int startX = tileX * tileSize;
+    int endX = internal_min(int(dimensions.x), startX + tileSize);
+    int endY = internal_min(int(dimensions.y), (tileY + 1) * tileSize);
+    for(int y = tileY * tileSize; y < endY; y++) {
+        const color_t* pixel = &frame[y * dimensions.x + startX];
+        for(int x = startX; x < endX; x++) {
+            hash ^= uint32_t(*pixel++);
+            hash *= 16777619UL;
+        }
+    }
+    return hash;
+}
+
+void TileHashingDrawable::pushTile(int tileX, int tileY) {
+    int startX = tileX * tileSize;
+    int endX = internal_min(int(dimensions.x), startX + tileSize);
+    int endY = internal_min(int(dimensions.y), (tileY + 1) * tileSize);
+    for(int y = tileY * tileSize; y < endY; y++) {
+        const color_t* row = &frame[y * dimensions.x];
+        int runStart = startX;
+        for(int x = startX + 1; x <= endX; x++) {
+            // each run of a single color is sent as one span
+            if(x == endX || row[x] != row[runStart]) {
+                underlying->setDrawColor(row[runStart]);
+                underlying->drawHorizontalSpan(Coord(runStart, y), x - runStart);
+                runStart = x;
+            }
+        }
+    }
+    tilesPushed++;
+    pixelsPushed += (endX - startX) * (endY - tileY * tileSize);
+}
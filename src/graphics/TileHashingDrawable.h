@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file TileHashingDrawable.h
+ * @brief a drawable that keeps a shadow framebuffer and only sends the tiles that actually changed to the display.
+ */
+
+#ifndef TCMENU_TILEHASHINGDRAWABLE_H
+#define TCMENU_TILEHASHINGDRAWABLE_H
+
+#include <PlatformDetermination.h>
+#include "SoftwareRasterDrawable.h"
+
+// The default width and height of each tile in pixels.
+#ifndef TC_TILE_SIZE
+#define TC_TILE_SIZE 16
+#endif
+
+namespace tcgfx {
+
+    /**
+     * Wraps another drawable, keeping a shadow framebuffer in memory that all drawing goes to, the shadow is split into
+     * square tiles, each of which has a hash of its content. When a transaction ends, the hash of each tile that could
+     * have been drawn on is recalculated, and only tiles whose hash differs from the last time they were sent are
+     * pushed to the underlying drawable. The renderer often repaints items that end up with identical pixels, such as
+     * a value that renders to the same text, and with this those repaints never reach the display bus.
+     *
+     * Changed tiles are sent as horizontal runs of a single color using drawHorizontalSpan, and the underlying transaction is
+     * ended with the pushed tiles as its dirty regions. The shadow holds a color_t for every pixel, so this is only
+     * suitable for boards with plenty of memory. Text must be drawn using tcUnicode.
+     */
+    class TileHashingDrawable : public SoftwareRasterDrawable {
+    private:
+        DeviceDrawable* underlying;
+        color_t* frame;
+        uint32_t* tileHashes;
+        uint8_t* tileState;
+        uint32_t pixelsPushed;
+        uint32_t tilesPushed;
+        uint32_t tilesChecked;
+        uint16_t tilesAcross;
+        uint16_t tilesDown;
+        uint8_t tileSize;
+    public:
+        /**
+         * Create the tile hashing wrapper around a drawable, the shadow framebuffer is allocated straight away.
+         * @param underlying the drawable that changed tiles are sent to
+         * @param tileSize the width and height of each tile in pixels
+         */
+        explicit TileHashingDrawable(DeviceDrawable* underlying, uint8_t tileSize = TC_TILE_SIZE);
+        ~TileHashingDrawable() override;
+
+        DeviceDrawable* getSubDeviceFor(const Coord &where, const Coord &size, const color_t *palette, int paletteSize) override { return nullptr; }
+        void transaction(bool isStarting, bool redrawNeeded) override;
+        void endTransaction(const DirtyRegions& changed) override;
+
+        /**
+         * Forget what has been sent, so that every tile is pushed at the end of the next transaction, for example
+         * after something else has drawn directly onto the underlying display.
+         */
+        void invalidate();
+
+        /** @return the number of pixels sent to the underlying drawable since the statistics were reset */
+        uint32_t getPixelsPushed() const { return pixelsPushed; }
+
+        /** @return the number of tiles sent to the underlying drawable since the statistics were reset */
+        uint32_t getTilesPushed() const { return tilesPushed; }
+
+        /** @return the number of tiles that were hashed to check for changes since the statistics were reset */
+        uint32_t getTilesChecked() const { return tilesChecked; }
+
+        /** reset the pushed and checked statistics */
+        void resetStatistics() { pixelsPushed = tilesPushed = tilesChecked = 0; }
+
+    protected:
+        void writeSpan(int x, int y, int len, color_t color) override;
+
+    private:
+        void checkTiles(const Coord& where, const Coord& size, DirtyRegions& pushed, bool& started);
+        uint32_t hashTile(int tileX, int tileY);
+        void pushTile(int tileX, int tileY);
+    };
+}
+
+#endif //TCMENU_TILEHASHINGDRAWABLE_H
@@ -7,8 +7,8 @@
 
 namespace tcremote {
 
-    BaseBufferedRemoteTransport::BaseBufferedRemoteTransport(BufferingMode bufferMode, uint8_t readBufferSize,
-                                                             uint8_t writeBufferSize, EncryptionHandler* encHandler)
+    BaseBufferedRemoteTransport::BaseBufferedRemoteTransport(BufferingMode bufferMode, uint16_t readBufferSize,
+                                                             uint16_t writeBufferSize, EncryptionHandler* encHandler)
             : TagValueTransport(TVAL_BUFFERED), writeBufferSize(writeBufferSize),
               readBufferSize(readBufferSize), writeBufferPos(0), readBufferPos(0), encryptionBufferPos(0), readBufferAvail(0),
               encryptionHandler(encHandler), mode(bufferMode),
@@ -84,19 +84,40 @@ namespace tcremote {
         // only uncomment below for worst case debugging..
         //	serlogF2(SER_NETWORK_DEBUG, "writing ", data);
 
+        // copy as much as will fit in each step, flushing in between exactly where writeChar would have.
         size_t len = strlen(data);
-        for (size_t i = 0; i < len; ++i) {
-            if (writeChar(data[i]) == 0) {
-                return 0;
+        size_t done = 0;
+        while (done < len) {
+            if (writeBufferPos >= writeBufferSize) {
+                flushInternal();
+                if (writeBufferPos >= writeBufferSize) return 0;
             }
+            size_t amount = internal_min(len - done, size_t(writeBufferSize - writeBufferPos));
+            memcpy(&writeBuffer[writeBufferPos], &data[done], amount);
+            writeBufferPos += amount;
+            done += amount;
         }
+        ticksSinceWrite = 0;
         return (int) len;
     }
 
-    void BaseBufferedRemoteTransport::flushIfRequired() {
+    char* BaseBufferedRemoteTransport::reserveWrite(size_t len) {
+        // we never flush to make space, so that messages are split across flushes in the same place as with writeChar.
+        if (size_t(writeBufferSize - writeBufferPos) < len) return nullptr;
+        return reinterpret_cast<char*>(&writeBuffer[writeBufferPos]);
+    }
+
+    void BaseBufferedRemoteTransport::commitWrite(size_t len) {
+        writeBufferPos += len;
+        ticksSinceWrite = 0;
+    }
+
+    void BaseBufferedRemoteTransport::flushIfRequired(uint16_t ticks) {
         if (!connected() || writeBufferPos == 0 || mode == BUFFER_ONE_MESSAGE) return;
 
-        if (ticksSinceWrite < TICKS_TO_FLUSH_WRITE) ++ticksSinceWrite;
+        if (ticksSinceWrite < TICKS_TO_FLUSH_WRITE) {
+            ticksSinceWrite = (ticks >= (TICKS_TO_FLUSH_WRITE - ticksSinceWrite)) ? TICKS_TO_FLUSH_WRITE : ticksSinceWrite + ticks;
+        }
         if (ticksSinceWrite == TICKS_TO_FLUSH_WRITE) {
             ticksSinceWrite = 0xff;
             flush();
@@ -68,7 +68,7 @@ namespace tcremote {
         BufferingMode mode;
         uint8_t ticksSinceWrite;
     public:
-        BaseBufferedRemoteTransport(BufferingMode bufferMode, uint8_t readBufferSize, uint8_t writeBufferSize,
+        BaseBufferedRemoteTransport(BufferingMode bufferMode, uint16_t readBufferSize, uint16_t writeBufferSize,
                                     EncryptionHandler* encHandler = nullptr);
 
         ~BaseBufferedRemoteTransport() override;
@@ -79,13 +79,31 @@ namespace tcremote {
 
         int writeStr(const char *data) override;
 
+        char* reserveWrite(size_t len) override;
+
+        void commitWrite(size_t len) override;
+
         uint8_t readByte() override;
 
         bool readAvailable() override;
 
         void close() override;
 
-        void flushIfRequired();
+        /**
+         * Called frequently to flush the write buffer once it has not been written to for TICKS_TO_FLUSH_WRITE ticks.
+         * @param ticks the number of ticks that have passed since the last call, defaults to 1
+         */
+        void flushIfRequired(uint16_t ticks = 1);
+
+        /**
+         * @return true if there is data in the write buffer that has not yet been flushed
+         */
+        bool hasUnflushedData() const { return writeBufferPos != 0; }
+
+        /**
+         * @return true if data has been read from the device into the read buffer, but not yet consumed
+         */
+        bool hasUnreadData() const { return readBufferPos < readBufferAvail; }
 
         void flushInternal();
 
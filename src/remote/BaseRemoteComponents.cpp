@@ -5,10 +5,29 @@
 
 #include "BaseRemoteComponents.h"
 #include "BaseBufferedRemoteTransport.h"
+#include "SessionRecording.h"
 
 using namespace tcremote;
 
+/**
+ * Finds the buffered transport that needs flushing, looking through a recording transport if there is one.
+ * @return the buffered transport or nullptr if the transport is not buffered
+ */
+BaseBufferedRemoteTransport* bufferedTransportOf(TagValueTransport* transport) {
+    if(transport->getTransportType() == TVAL_RECORDING) {
+        transport = reinterpret_cast<RecordingTransport*>(transport)->getUnderlying();
+    }
+    return transport->getTransportType() == TVAL_BUFFERED ? reinterpret_cast<BaseBufferedRemoteTransport*>(transport) : nullptr;
+}
+
 void BaseRemoteServerConnection::runLoop() {
+    // work out how many ticks have passed since we were last serviced, connections that signal readiness are not
+    // serviced every tick, so heartbeats and flushing need to account for the skipped ticks.
+    unsigned long now = millis();
+    unsigned long elapsed = (now - lastServiced) / TICK_INTERVAL;
+    ticksSinceService = elapsed == 0 ? 1 : (elapsed > 0xffffUL ? 0xffff : (uint16_t)elapsed);
+    lastServiced = now;
+
     if(!initialisation.isInitialised()) {
         initialisation.attemptInitialisation();
     }
@@ -26,20 +45,34 @@ TagValueRemoteServerConnection::TagValueRemoteServerConnection(TagValueTransport
 }
 
 void TagValueRemoteServerConnection::tick() {
-    remoteConnector.tick();
+    remoteConnector.tick(ticksSinceService);
 
     // if this is a buffered transport, we must give it chance to flush the buffer from time to time.
-    if(remoteTransport.getTransportType() == TVAL_BUFFERED) {
-        reinterpret_cast<BaseBufferedRemoteTransport&>(remoteTransport).flushIfRequired();
+    auto buffered = bufferedTransportOf(&remoteTransport);
+    if(buffered != nullptr) {
+        buffered->flushIfRequired(ticksSinceService);
     }
 }
 
+bool TagValueRemoteServerConnection::hasPendingWork() {
+    if(remoteConnector.hasPendingWrites()) return true;
+    // the device will not signal again for data that is already in the read buffer, and only one field is processed
+    // per tick, so a buffer holding several fields must keep the connection serviced until it is used up.
+    auto buffered = bufferedTransportOf(&remoteTransport);
+    return buffered != nullptr && (buffered->hasUnflushedData() || buffered->hasUnreadData());
+}
+
 void TagValueRemoteServerConnection::init(int remoteNumber, const ConnectorLocalInfo& info) {
     // first we setup the remote number and initialise the connector
     messageProcessor.initialise();
     connector()->initialise(transport(), messageProcessors(), &info, remoteNumber);
 }
 
+void TagValueBroadcastConnection::init(int remoteNumber, const ConnectorLocalInfo& info) {
+    TagValueRemoteServerConnection::init(remoteNumber, info);
+    connector()->enablePublishOnly(keyframeMillis);
+}
+
 void TagValueRemoteServerConnection::copyConnectionStatus(char *buffer, int bufferSize) {
     strncpy(buffer, connector()->getRemoteName(), bufferSize);
     buffer[bufferSize - 1] = 0; // make sure it's zero terminated
@@ -63,23 +96,43 @@ void TagValueRemoteServerConnection::notifyRemoteHasClosed() {
 uint8_t tcremote::TcMenuRemoteServer::addConnection(tcremote::BaseRemoteServerConnection *toAdd) {
     if(remotesAdded >= ALLOWED_CONNECTIONS) return 0xff;
 
-    if(remotesAdded == 0) {
-        serlogF(SER_NETWORK_INFO, "Starting remote server tick handler");
-        taskManager.scheduleFixedRate(TICK_INTERVAL, this, TIME_MILLIS);
-    }
-
     serlogF2(SER_NETWORK_INFO, "Adding connection #", remotesAdded);
 
     // and then add it to our array.
     connections[remotesAdded] = toAdd;
+    toAdd->setReadinessNotifier(this);
     toAdd->init(remotesAdded, appInfo);
 
+    if(remotesAdded == 0) {
+        serlogF(SER_NETWORK_INFO, "Starting remote server event handler");
+        taskManager.registerEvent(this);
+    }
+
     return remotesAdded++;
 }
 
+uint32_t TcMenuRemoteServer::timeOfNextCheck() {
+    // we are always triggered when the time elapses, either to poll or for housekeeping. Should any connection not
+    // support readiness, or have work pending, then we must continue to run every tick.
+    setTriggered(true);
+    for (int i = 0; i < remotesAdded; i++) {
+        if(!connections[i]->isReadinessSignalling() || connections[i]->hasPendingWork()) {
+            return millisToMicros(TICK_INTERVAL);
+        }
+    }
+    return millisToMicros(TC_REMOTE_HOUSEKEEPING_MILLIS);
+}
+
 void TcMenuRemoteServer::exec() {
+    unsigned long now = millis();
     for (int i = 0; i < remotesAdded; i++) {
-        connections[i]->runLoop();
+        auto conn = connections[i];
+        if(conn->isReadinessSignalling()) {
+            bool ready = conn->takeReadiness() != READY_NONE;
+            bool housekeeping = (now - conn->getLastServiced()) >= TC_REMOTE_HOUSEKEEPING_MILLIS;
+            if(!ready && !housekeeping && !conn->hasPendingWork()) continue;
+        }
+        conn->runLoop();
         taskManager.yieldForMicros(0);
     }
 }
@@ -21,6 +21,17 @@
 #define ALLOWED_CONNECTIONS 4
 #endif
 
+// When connections signal their readiness, idle connections are only serviced at this interval, so that heartbeats,
+// menu item changes and new connections are still dealt with. You can define this to a different value as a build flag.
+#ifndef TC_REMOTE_HOUSEKEEPING_MILLIS
+#define TC_REMOTE_HOUSEKEEPING_MILLIS 10
+#endif
+
+// The default interval at which broadcast connections resend the whole menu, so that listeners joining later catch up.
+#ifndef TC_BROADCAST_KEYFRAME_MILLIS
+#define TC_BROADCAST_KEYFRAME_MILLIS 5000
+#endif
+
 namespace tcremote {
 
     class BaseRemoteServerConnection;
@@ -61,10 +72,41 @@ namespace tcremote {
         TAG_VAL_REMOTE_SERVER, SIMHUB_CONNECTOR, TAG_VAL_WEB_SOCKET
     };
 
+    /**
+     * The readiness states that a connection can signal to the server, they can be combined together.
+     */
+    enum ConnectionReadiness : uint8_t {
+        /** nothing has happened on the connection */
+        READY_NONE = 0x00,
+        /** there is data available to be read */
+        READY_TO_READ = 0x01,
+        /** the connection can now accept more data for writing */
+        READY_TO_WRITE = 0x02,
+        /** the connection has been established or closed */
+        READY_STATE_CHANGED = 0x04
+    };
+
+    /**
+     * Implemented by the server to be told when a connection has work to do, this may be called from an interrupt,
+     * so implementations must only do interrupt safe work such as triggering an event.
+     */
+    class ReadinessNotifier {
+    public:
+        virtual void connectionReady(BaseRemoteServerConnection* connection) = 0;
+    };
+
     class BaseRemoteServerConnection {
     protected:
         DeviceInitialisation &initialisation;
         RemoteServerType remoteServerType;
+        ReadinessNotifier* readinessNotifier = nullptr;
+        // one entry per ConnectionReadiness bit, they are only ever set by markReady and cleared by takeReadiness, so
+        // each is a single byte store that cannot be lost to a read, modify, write race with an interrupt.
+        static const uint8_t READINESS_FLAG_COUNT = 3;
+        volatile bool readiness[READINESS_FLAG_COUNT] = {};
+        bool readinessSignalling = false;
+        uint16_t ticksSinceService = 1;
+        unsigned long lastServiced = 0;
     public:
         BaseRemoteServerConnection(DeviceInitialisation &initialisation, RemoteServerType remoteServerType)
                 : initialisation(initialisation), remoteServerType(remoteServerType) {}
@@ -73,6 +115,60 @@ namespace tcremote {
 
         DeviceInitialisation& getDeviceInitialisation() const { return initialisation; }
         void runLoop();
+
+        /**
+         * Call this before adding the connection to the server to indicate that the transport will signal its
+         * readiness using `markReady`, the server will then only service this connection when it is ready, when it
+         * has pending work, or every TC_REMOTE_HOUSEKEEPING_MILLIS. Connections that do not call this are polled
+         * on every tick as before.
+         */
+        void enableReadinessSignalling() { readinessSignalling = true; }
+        bool isReadinessSignalling() const { return readinessSignalling; }
+
+        /**
+         * Called by a transport (or its device callbacks) to indicate that the connection is ready, this is safe to
+         * call from an interrupt as it just records the state and notifies the server. It must not be called from
+         * another thread, unless your platform guarantees that byte stores are seen by the task manager thread.
+         * @param flags one or more of the ConnectionReadiness values
+         */
+        void markReady(uint8_t flags) {
+            for(uint8_t i = 0; i < READINESS_FLAG_COUNT; i++) {
+                if(flags & (1U << i)) readiness[i] = true;
+            }
+            if(readinessNotifier) readinessNotifier->connectionReady(this);
+        }
+
+        /**
+         * Gets the readiness flags that have been signalled since the last call, and clears them. A flag that is
+         * signalled while this runs is either returned now or on the next call, it is never lost.
+         * @return the readiness flags that were set
+         */
+        uint8_t takeReadiness() {
+            uint8_t r = READY_NONE;
+            for(uint8_t i = 0; i < READINESS_FLAG_COUNT; i++) {
+                if(readiness[i]) {
+                    readiness[i] = false;
+                    r |= uint8_t(1U << i);
+                }
+            }
+            return r;
+        }
+
+        void setReadinessNotifier(ReadinessNotifier* notifier) { readinessNotifier = notifier; }
+
+        /**
+         * @return the time in millis at which this connection was last serviced by runLoop
+         */
+        unsigned long getLastServiced() const { return lastServiced; }
+
+        /**
+         * Indicates if this connection has work that needs to be done on every tick regardless of readiness, for
+         * example during bootstrap, when there is unflushed data, or when data has been read from the device but not
+         * yet processed.
+         * @return true if there is work pending, otherwise false.
+         */
+        virtual bool hasPendingWork() { return false; }
+
         virtual void init(int remoteNumber, const ConnectorLocalInfo& info) = 0;
         virtual void tick() = 0;
         virtual bool connected() = 0;
@@ -103,18 +199,46 @@ namespace tcremote {
 
         void tick() override;
         bool connected() override { return remoteTransport.connected(); }
+        bool hasPendingWork() override;
 
         void copyConnectionStatus(char *buffer, int bufferSize) override;
 
         void notifyRemoteHasClosed() override;
     };
 
+    /**
+     * A tag value server connection that only ever publishes, it puts the connector into publish only mode so that the
+     * menu structure and all value changes are streamed out of the transport with a keyframe bootstrap at regular
+     * intervals, and nothing is ever read back. Use it with a datagram or shared transport, for example a multicast
+     * socket, to feed any number of read only dashboards without keeping any state for each of them.
+     */
+    class TagValueBroadcastConnection : public TagValueRemoteServerConnection {
+    private:
+        uint16_t keyframeMillis;
+    public:
+        /**
+         * Create a broadcast connection
+         * @param transport the transport to publish on, it should be buffered one message at a time for datagrams
+         * @param initialisation the initialisation that opens the transport
+         * @param keyframeMillis how often the full menu is resent for listeners that have just joined
+         */
+        TagValueBroadcastConnection(TagValueTransport &transport, DeviceInitialisation& initialisation,
+                                    uint16_t keyframeMillis = TC_BROADCAST_KEYFRAME_MILLIS)
+                : TagValueRemoteServerConnection(transport, initialisation), keyframeMillis(keyframeMillis) {}
+
+        void init(int remoteNumber, const ConnectorLocalInfo& info) override;
+    };
+
     /**
      * This is the component that allows us to manage as many connections as needed using a single instance, it
      * holds on to instances of RemoteServerConnection and services them all, it also provides the getter functions
      * for acquiring the transport or connector for a given item.
+     *
+     * It is registered as an event with task manager, connections that do not signal readiness are polled every
+     * tick. When all connections signal their readiness, the server only runs when a connection becomes ready, when
+     * a connection has pending work, or for housekeeping every TC_REMOTE_HOUSEKEEPING_MILLIS.
      */
-    class TcMenuRemoteServer : public Executable {
+    class TcMenuRemoteServer : public BaseEvent, public ReadinessNotifier {
         BaseRemoteServerConnection* connections[ALLOWED_CONNECTIONS];
         const ConnectorLocalInfo& appInfo;
         uint8_t remotesAdded;
@@ -136,6 +260,8 @@ namespace tcremote {
         }
 
         void exec() override;
+        uint32_t timeOfNextCheck() override;
+        void connectionReady(BaseRemoteServerConnection* connection) override { markTriggeredAndNotify(); }
 
         /**
          * Adds a connection to the managed connections, this class will ensure that it is properly initialised,
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "CobsFramedTransport.h"
+
+using namespace tcremote;
+
+uint16_t tcremote::tcCrc16(const uint8_t* data, size_t len, uint16_t crc) {
+    for(size_t i = 0; i < len; i++) {
+        crc ^= uint16_t(data[i]) << 8;
+        for(int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? uint16_t((crc << 1) ^ 0x1021) : uint16_t(crc << 1);
+        }
+    }
+    return crc;
+}
+
+int tcremote::cobsDecodeInPlace(uint8_t* data, int len) {
+    int readPos = 0;
+    int writePos = 0;
+    while(readPos < len) {
+        uint8_t code = data[readPos++];
+        if(code == 0 || (readPos + code - 1) > len) return -1;
+        for(int i = 1; i < code; i++) {
+            data[writePos++] = data[readPos++];
+        }
+        // a code of 0xff means a full block with no zero following, and the last block never has a zero following.
+        if(code != 0xff && readPos < len) data[writePos++] = 0;
+    }
+    return writePos;
+}
+
+CobsFramedTransport::CobsFramedTransport(uint8_t bufferSize)
+        : BaseBufferedRemoteTransport(BUFFER_ONE_MESSAGE, bufferSize, bufferSize), rawBuffer{}, rawPos(0), rawAvail(0),
+          discardingFrame(false), framesReceived(0), framesRejected(0) {
+    // room for the message, the CRC, and the COBS overhead of one byte in every 254.
+    frameBufferSize = bufferSize + 2 + ((bufferSize + 2) / 254) + 1;
+    frameBuffer = new uint8_t[frameBufferSize];
+    framePos = 0;
+}
+
+CobsFramedTransport::~CobsFramedTransport() {
+    delete[] frameBuffer;
+}
+
+void CobsFramedTransport::close() {
+    BaseBufferedRemoteTransport::close();
+    framePos = 0;
+    rawPos = rawAvail = 0;
+    discardingFrame = false;
+}
+
+int CobsFramedTransport::fillReadBuffer(uint8_t* data, int maxSize) {
+    while(true) {
+        if(rawPos >= rawAvail) {
+            int amt = readRawBytes(rawBuffer, sizeof rawBuffer);
+            if(amt <= 0) return 0;
+            rawAvail = amt;
+            rawPos = 0;
+        }
+
+        while(rawPos < rawAvail) {
+            uint8_t ch = rawBuffer[rawPos++];
+            if(ch == 0) {
+                int len = completeFrame(data, maxSize);
+                // either a good frame, or a bad frame that has reset the message state, in both cases return now.
+                if(len != 0) return len < 0 ? 0 : len;
+            }
+            else if(framePos < frameBufferSize) {
+                frameBuffer[framePos++] = ch;
+            }
+            else {
+                // too large for our buffer, drop everything until the next frame boundary.
+                discardingFrame = true;
+            }
+        }
+    }
+}
+
+int CobsFramedTransport::completeFrame(uint8_t* data, int maxSize) {
+    int encodedLen = framePos;
+    bool discard = discardingFrame;
+    framePos = 0;
+    discardingFrame = false;
+    if(encodedLen == 0 && !discard) return 0; // empty frame, can be used as a keep alive.
+
+    int len = discard ? -1 : cobsDecodeInPlace(frameBuffer, encodedLen);
+    if(len < 3 || (len - 2) > maxSize || tcCrc16(frameBuffer, len) != 0) {
+        // the frame is corrupt, any message in progress cannot be trusted so we reset processing.
+        framesRejected++;
+        serlogF2(SER_NETWORK_INFO, "Frame rejected ", framesRejected);
+        clearFieldStatus(FVAL_PROCESSING_AWAITINGMSG);
+        return -1;
+    }
+
+    framesReceived++;
+    memcpy(data, frameBuffer, len - 2);
+    return len - 2;
+}
+
+void CobsFramedTransport::flush() {
+    if(writeBufferPos == 0) return;
+
+    uint16_t crc = tcCrc16(writeBuffer, writeBufferPos);
+    uint8_t crcBytes[2] = { highByte(crc), lowByte(crc) };
+    int total = writeBufferPos + 2;
+
+    // encode in blocks straight to the device, each block is a code byte followed by up to 254 non zero bytes.
+    uint8_t block[TC_COBS_RAW_READ_SIZE];
+    int pos = 0;
+    while(pos <= total) {
+        int start = pos;
+        while(pos < total && (pos - start) < 254) {
+            uint8_t ch = pos < writeBufferPos ? writeBuffer[pos] : crcBytes[pos - writeBufferPos];
+            if(ch == 0) break;
+            pos++;
+        }
+        uint8_t code = uint8_t(pos - start + 1);
+        writeRawBytes(&code, 1);
+        int blockPos = 0;
+        for(int i = start; i < pos; i++) {
+            block[blockPos++] = i < writeBufferPos ? writeBuffer[i] : crcBytes[i - writeBufferPos];
+            if(blockPos == sizeof block) {
+                writeRawBytes(block, blockPos);
+                blockPos = 0;
+            }
+        }
+        if(blockPos) writeRawBytes(block, blockPos);
+
+        // skip over the zero we stopped at, a full block has no zero to skip.
+        if(code != 0xff) pos++;
+        else if(pos == total) break;
+    }
+    uint8_t delimiter = 0;
+    writeRawBytes(&delimiter, 1);
+    writeBufferPos = 0;
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file CobsFramedTransport.h
+ * @brief a buffered transport that frames each message using COBS encoding with a CRC, for noisy serial links.
+ */
+
+#ifndef TCMENU_COBSFRAMEDTRANSPORT_H
+#define TCMENU_COBSFRAMEDTRANSPORT_H
+
+#include <PlatformDetermination.h>
+#include "BaseBufferedRemoteTransport.h"
+
+// The number of raw bytes that are read from the device in one go, they are held until processed.
+#ifndef TC_COBS_RAW_READ_SIZE
+#define TC_COBS_RAW_READ_SIZE 32
+#endif
+
+namespace tcremote {
+
+    /**
+     * Calculates a CRC-16/CCITT-FALSE over the data provided, the crc parameter allows it to be calculated in parts.
+     * @param data the data to calculate over
+     * @param len the length of the data
+     * @param crc the starting value, defaults to the standard initial value
+     * @return the CRC of the data
+     */
+    uint16_t tcCrc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+    /**
+     * Decodes a COBS encoded frame (without the zero delimiter) in place.
+     * @param data the encoded frame, the decoded data is written over it
+     * @param len the length of the encoded frame
+     * @return the decoded length, or -1 if the frame is invalid.
+     */
+    int cobsDecodeInPlace(uint8_t* data, int len);
+
+    /**
+     * A transport that wraps each message written in a frame, the message has a CRC-16 appended, is then COBS encoded
+     * so that it contains no zero bytes, and is followed by a zero byte delimiter. On reading, frames are collected
+     * until the delimiter, decoded and the CRC is checked. Corrupted frames are dropped along with any partially
+     * processed message, and reading resumes at the next frame boundary rather than searching for a message start.
+     *
+     * Messages longer than the buffer are split into several frames, so for best results the buffer should be large
+     * enough to hold the largest message. Extend this class providing the raw read and write functions for the device.
+     */
+    class CobsFramedTransport : public BaseBufferedRemoteTransport {
+    private:
+        uint8_t* frameBuffer;
+        uint16_t frameBufferSize;
+        uint16_t framePos;
+        uint8_t rawBuffer[TC_COBS_RAW_READ_SIZE];
+        uint8_t rawPos;
+        uint8_t rawAvail;
+        bool discardingFrame;
+        uint16_t framesReceived;
+        uint16_t framesRejected;
+    public:
+        /**
+         * Create a framed transport, with a buffer size that should be big enough for the largest message.
+         * @param bufferSize the size of the read and write buffers
+         */
+        explicit CobsFramedTransport(uint8_t bufferSize);
+        ~CobsFramedTransport() override;
+
+        int fillReadBuffer(uint8_t* data, int maxSize) override;
+        void flush() override;
+        void close() override;
+
+        /** @return the number of frames that were received and passed the CRC check */
+        uint16_t getFramesReceived() const { return framesReceived; }
+        /** @return the number of frames that were dropped because they were corrupt or too large */
+        uint16_t getFramesRejected() const { return framesRejected; }
+
+        /**
+         * Read raw bytes from the underlying device without blocking.
+         * @param data the buffer to read into
+         * @param maxSize the maximum number of bytes to read
+         * @return the number of bytes read, 0 if none available.
+         */
+        virtual int readRawBytes(uint8_t* data, int maxSize) = 0;
+
+        /**
+         * Write raw bytes to the underlying device.
+         * @param data the bytes to write
+         * @param len the number of bytes to write
+         * @return the number of bytes written.
+         */
+        virtual int writeRawBytes(const uint8_t* data, int len) = 0;
+    private:
+        int completeFrame(uint8_t* data, int maxSize);
+    };
+}
+
+#ifndef TC_MANUAL_NAMESPACING
+using namespace tcremote;
+#endif // TC_MANUAL_NAMESPACING
+
+#endif //TCMENU_COBSFRAMEDTRANSPORT_H
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "PosixSerialTransport.h"
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <termios.h>
+
+using namespace tcremote;
+
+// how long a write waits for the device to drain before giving up.
+#ifndef TC_POSIX_SERIAL_WRITE_WAIT_MILLIS
+#define TC_POSIX_SERIAL_WRITE_WAIT_MILLIS 100
+#endif
+
+PosixSerialCobsTransport::~PosixSerialCobsTransport() {
+    if(fd >= 0) ::close(fd);
+}
+
+static bool baudToSpeed(long baud, speed_t& speed) {
+    switch(baud) {
+        case 9600: speed = B9600; return true;
+        case 19200: speed = B19200; return true;
+        case 38400: speed = B38400; return true;
+        case 57600: speed = B57600; return true;
+        case 115200: speed = B115200; return true;
+        case 230400: speed = B230400; return true;
+#ifdef B460800
+        case 460800: speed = B460800; return true;
+#endif
+#ifdef B921600
+        case 921600: speed = B921600; return true;
+#endif
+        default: return false;
+    }
+}
+
+bool PosixSerialCobsTransport::openDevice(const char* device, long baud) {
+    speed_t speed;
+    if(!baudToSpeed(baud, speed)) {
+        serlogF2(SER_ERROR, "Serial baud not supported ", baud);
+        return false;
+    }
+
+    int newFd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(newFd < 0) {
+        serlogF2(SER_ERROR, "Serial open failed ", device);
+        return false;
+    }
+
+    termios tty = {};
+    if(tcgetattr(newFd, &tty) != 0) {
+        serlogF2(SER_ERROR, "Not a serial device ", device);
+        ::close(newFd);
+        return false;
+    }
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    tty.c_cflag |= (CLOCAL | CREAD);
+    if(tcsetattr(newFd, TCSANOW, &tty) != 0) {
+        serlogF2(SER_ERROR, "Serial setup failed ", errno);
+        ::close(newFd);
+        return false;
+    }
+    setFileDescriptor(newFd);
+    return true;
+}
+
+void PosixSerialCobsTransport::setFileDescriptor(int newFd) {
+    if(fd >= 0) ::close(fd);
+    int flags = fcntl(newFd, F_GETFL, 0);
+    if(flags >= 0) fcntl(newFd, F_SETFL, flags | O_NONBLOCK);
+    fd = newFd;
+}
+
+int PosixSerialCobsTransport::readRawBytes(uint8_t* data, int maxSize) {
+    if(fd < 0) return 0;
+    auto amt = read(fd, data, maxSize);
+    return amt > 0 ? (int)amt : 0;
+}
+
+int PosixSerialCobsTransport::writeRawBytes(const uint8_t* data, int len) {
+    int written = 0;
+    while(fd >= 0 && written < len) {
+        auto amt = write(fd, &data[written], len - written);
+        if(amt > 0) {
+            written += (int)amt;
+        }
+        else if(amt < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            // the device is full, wait for it to drain rather than losing part of a frame.
+            pollfd pfd = { fd, POLLOUT, 0 };
+            if(poll(&pfd, 1, TC_POSIX_SERIAL_WRITE_WAIT_MILLIS) <= 0) break;
+        }
+        else {
+            break;
+        }
+    }
+    return written;
+}
+
+#endif // TC_POSIX_REMOTE_SUPPORT
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file PosixSerialTransport.h
+ * @brief a COBS framed serial transport for POSIX hosts, that works with serial devices and pseudo terminals.
+ */
+
+#ifndef TCMENU_POSIXSERIALTRANSPORT_H
+#define TCMENU_POSIXSERIALTRANSPORT_H
+
+#include <PlatformDetermination.h>
+#include "PosixSocketTransport.h"
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+
+#include "CobsFramedTransport.h"
+
+#ifndef TC_POSIX_SERIAL_BUFFER_SIZE
+#define TC_POSIX_SERIAL_BUFFER_SIZE 255
+#endif
+
+namespace tcremote {
+
+    /**
+     * A COBS framed transport that reads and writes a POSIX file descriptor, either a serial device that is opened
+     * with `openDevice`, or any other descriptor such as one side of a pseudo terminal pair, which makes it possible
+     * to test the framing on a development machine.
+     */
+    class PosixSerialCobsTransport : public CobsFramedTransport {
+    private:
+        int fd;
+    public:
+        PosixSerialCobsTransport() : CobsFramedTransport(TC_POSIX_SERIAL_BUFFER_SIZE), fd(-1) {}
+        ~PosixSerialCobsTransport() override;
+
+        /**
+         * Opens a serial device in raw mode at the baud rate provided.
+         * @param device the path to the device, EG /dev/ttyUSB0
+         * @param baud the baud rate as a number, EG 115200, it must be one of the standard rates from 9600 upwards
+         * @return true if opened and set up, otherwise false, including when the baud rate is not supported.
+         */
+        bool openDevice(const char* device, long baud);
+
+        /**
+         * Use a descriptor that is already open, it is put into non-blocking mode and the transport will close it.
+         * @param fd the file descriptor to use
+         */
+        void setFileDescriptor(int fd);
+
+        int readRawBytes(uint8_t* data, int maxSize) override;
+        int writeRawBytes(const uint8_t* data, int len) override;
+        bool available() override { return fd >= 0; }
+        bool connected() override { return fd >= 0; }
+    };
+}
+
+#endif // TC_POSIX_REMOTE_SUPPORT
+
+#endif //TCMENU_POSIXSERIALTRANSPORT_H
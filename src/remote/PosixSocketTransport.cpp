@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "PosixSocketTransport.h"
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+
+#ifdef MSG_NOSIGNAL
+#define TC_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define TC_SEND_FLAGS 0
+#endif
+
+using namespace tcremote;
+
+static bool makeNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+PosixSocketTransport::~PosixSocketTransport() {
+    if(socketFd >= 0) ::close(socketFd);
+}
+
+void PosixSocketTransport::setSocket(int fd) {
+    if(socketFd >= 0) ::close(socketFd);
+    makeNonBlocking(fd);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+#ifdef SO_NOSIGPIPE
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof one);
+#endif
+    socketFd = fd;
+}
+
+bool PosixSocketTransport::available() {
+    return socketFd >= 0 && writeBufferPos < writeBufferSize;
+}
+
+int PosixSocketTransport::fillReadBuffer(uint8_t* data, int maxSize) {
+    if(socketFd < 0) return 0;
+    auto amt = recv(socketFd, data, maxSize, 0);
+    if(amt > 0) {
+        bytesRead += amt;
+        return (int)amt;
+    }
+    if(amt == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        serlogF2(SER_NETWORK_INFO, "Socket read closed ", errno);
+        close();
+    }
+    return 0;
+}
+
+void PosixSocketTransport::flush() {
+    if(socketFd < 0 || writeBufferPos == 0) return;
+
+    auto amt = send(socketFd, writeBuffer, writeBufferPos, TC_SEND_FLAGS);
+    if(amt < 0) {
+        if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            serlogF2(SER_NETWORK_INFO, "Socket write failed ", errno);
+            close();
+        }
+        return;
+    }
+
+    // a partial write leaves the remainder at the start of the buffer for the next flush.
+    bytesWritten += amt;
+    if(amt < writeBufferPos) {
+        memmove(writeBuffer, &writeBuffer[amt], writeBufferPos - amt);
+    }
+    writeBufferPos -= amt;
+}
+
+void PosixSocketTransport::close() {
+    BaseBufferedRemoteTransport::close();
+    if(socketFd >= 0) {
+        serlogF2(SER_NETWORK_INFO, "Socket close ", socketFd);
+        ::close(socketFd);
+        socketFd = -1;
+    }
+}
+
+PosixSocketInitialisation::~PosixSocketInitialisation() {
+    if(listenFd >= 0) ::close(listenFd);
+}
+
+bool PosixSocketInitialisation::attemptInitialisation() {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(fd < 0) return false;
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if(inet_pton(AF_INET, bindAddress, &addr.sin_addr) != 1 || bind(fd, (sockaddr*)&addr, sizeof addr) != 0
+            || listen(fd, ALLOWED_CONNECTIONS) != 0 || !makeNonBlocking(fd)) {
+        serlogF2(SER_ERROR, "Socket listen failed ", errno);
+        ::close(fd);
+        return false;
+    }
+
+    socklen_t len = sizeof addr;
+    if(getsockname(fd, (sockaddr*)&addr, &len) == 0) port = ntohs(addr.sin_port);
+
+    serlogF3(SER_NETWORK_INFO, "Listening on ", bindAddress, port);
+    listenFd = fd;
+    initialised = true;
+    return true;
+}
+
+bool PosixSocketInitialisation::attemptNewConnection(BaseRemoteServerConnection* remoteConnection) {
+    if(listenFd < 0) return false;
+    int fd = accept(listenFd, nullptr, nullptr);
+    if(fd < 0) return false;
+
+    serlogF2(SER_NETWORK_INFO, "Accepted socket ", fd);
+    auto* tvCon = reinterpret_cast<TagValueRemoteServerConnection*>(remoteConnection);
+    reinterpret_cast<PosixSocketTransport*>(tvCon->transport())->setSocket(fd);
+    return true;
+}
+
+PosixDatagramTransport::~PosixDatagramTransport() {
+    if(socketFd >= 0) ::close(socketFd);
+}
+
+void PosixDatagramTransport::setSocket(int fd) {
+    if(socketFd >= 0) ::close(socketFd);
+    makeNonBlocking(fd);
+    socketFd = fd;
+}
+
+void PosixDatagramTransport::flush() {
+    if(socketFd < 0 || writeBufferPos == 0) return;
+
+    // a datagram that cannot be sent is dropped, listeners recover at the next keyframe.
+    if(send(socketFd, writeBuffer, writeBufferPos, TC_SEND_FLAGS) < 0) {
+        sendFailures++;
+        if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNREFUSED) {
+            serlogF2(SER_NETWORK_INFO, "Datagram send failed ", errno);
+            close();
+        }
+    }
+    else {
+        datagramsSent++;
+    }
+    writeBufferPos = 0;
+}
+
+void PosixDatagramTransport::close() {
+    BaseBufferedRemoteTransport::close();
+    if(socketFd >= 0) {
+        serlogF2(SER_NETWORK_INFO, "Datagram close ", socketFd);
+        ::close(socketFd);
+        socketFd = -1;
+    }
+}
+
+bool PosixDatagramInitialisation::attemptInitialisation() {
+    in_addr addr = {};
+    if(inet_pton(AF_INET, address, &addr) != 1 || (interfaceAddress && inet_pton(AF_INET, interfaceAddress, &addr) != 1)) {
+        serlogF3(SER_ERROR, "Invalid datagram address ", address, interfaceAddress ? interfaceAddress : "");
+        return false;
+    }
+    initialised = true;
+    return true;
+}
+
+bool PosixDatagramInitialisation::attemptNewConnection(BaseRemoteServerConnection* remoteConnection) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if(fd < 0) return false;
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, address, &addr.sin_addr);
+    if(IN_MULTICAST(ntohl(addr.sin_addr.s_addr))) {
+        unsigned char ttl = multicastTtl, loop = 1;
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof ttl);
+        setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof loop);
+        if(interfaceAddress) {
+            in_addr outgoing = {};
+            inet_pton(AF_INET, interfaceAddress, &outgoing);
+            setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &outgoing, sizeof outgoing);
+        }
+    }
+    if(connect(fd, (sockaddr*)&addr, sizeof addr) != 0) {
+        serlogF2(SER_ERROR, "Datagram connect failed ", errno);
+        ::close(fd);
+        return false;
+    }
+
+    serlogF3(SER_NETWORK_INFO, "Publishing to ", address, port);
+    auto* tvCon = reinterpret_cast<TagValueRemoteServerConnection*>(remoteConnection);
+    reinterpret_cast<PosixDatagramTransport*>(tvCon->transport())->setSocket(fd);
+    return true;
+}
+
+bool PosixSocketPoller::addConnection(TagValueRemoteServerConnection* connection) {
+    if(connectionCount >= ALLOWED_CONNECTIONS) return false;
+    connection->enableReadinessSignalling();
+    connections[connectionCount++] = connection;
+    return true;
+}
+
+int PosixSocketPoller::pollOnce(int timeoutMillis) {
+    pollfd fds[ALLOWED_CONNECTIONS + 1];
+    int8_t fdToConnection[ALLOWED_CONNECTIONS + 1];
+    int numFds = 0;
+
+    if(initialisation->getListenSocket() >= 0) {
+        fds[numFds].fd = initialisation->getListenSocket();
+        fds[numFds].events = POLLIN;
+        fdToConnection[numFds++] = -1;
+    }
+
+    for(int i = 0; i < connectionCount; i++) {
+        auto transport = reinterpret_cast<PosixSocketTransport*>(connections[i]->transport());
+        if(transport->getSocket() < 0) continue;
+        fds[numFds].fd = transport->getSocket();
+        fds[numFds].events = short(POLLIN | (transport->hasUnflushedData() ? POLLOUT : 0));
+        fdToConnection[numFds++] = int8_t(i);
+    }
+
+    int ready = poll(fds, numFds, timeoutMillis);
+    if(ready <= 0) return ready;
+
+    for(int i = 0; i < numFds; i++) {
+        if(fds[i].revents == 0) continue;
+        if(fdToConnection[i] == -1) {
+            // a new client is waiting, any connection that is not connected can accept it.
+            for(int c = 0; c < connectionCount; c++) {
+                if(!connections[c]->connected()) connections[c]->markReady(READY_STATE_CHANGED);
+            }
+            continue;
+        }
+        uint8_t flags = READY_NONE;
+        if(fds[i].revents & POLLIN) flags |= READY_TO_READ;
+        if(fds[i].revents & POLLOUT) flags |= READY_TO_WRITE;
+        if(fds[i].revents & (POLLHUP | POLLERR | POLLNVAL)) flags |= READY_STATE_CHANGED;
+        connections[fdToConnection[i]]->markReady(flags);
+    }
+    return ready;
+}
+
+#endif // TC_POSIX_REMOTE_SUPPORT
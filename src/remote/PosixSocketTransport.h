@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file PosixSocketTransport.h
+ * @brief a non-blocking TCP socket transport for the remote server on POSIX hosts such as Linux.
+ */
+
+#ifndef TCMENU_POSIXSOCKETTRANSPORT_H
+#define TCMENU_POSIXSOCKETTRANSPORT_H
+
+#include <PlatformDetermination.h>
+
+#if (defined(__linux__) || defined(__APPLE__)) && !defined(ARDUINO)
+#define TC_POSIX_REMOTE_SUPPORT
+
+#include "BaseBufferedRemoteTransport.h"
+#include "BaseRemoteComponents.h"
+
+#ifndef TC_POSIX_SOCKET_BUFFER_SIZE
+#define TC_POSIX_SOCKET_BUFFER_SIZE 128
+#endif
+
+// The largest datagram sent by PosixDatagramTransport, messages larger than this continue in the next datagram.
+#ifndef TC_POSIX_DATAGRAM_SIZE
+#define TC_POSIX_DATAGRAM_SIZE 255
+#endif
+
+namespace tcremote {
+
+    /**
+     * A buffered transport that reads and writes using a non-blocking POSIX TCP socket, it is intended for running
+     * the remote stack on a development machine, for example to test or measure it against local clients. It never
+     * blocks, reads return whatever is available, and writes that cannot be completed are kept in the buffer until
+     * the socket is writable again.
+     */
+    class PosixSocketTransport : public BaseBufferedRemoteTransport {
+    private:
+        int socketFd;
+        uint32_t bytesRead;
+        uint32_t bytesWritten;
+    public:
+        PosixSocketTransport() : BaseBufferedRemoteTransport(BUFFER_MESSAGES_TILL_FULL, TC_POSIX_SOCKET_BUFFER_SIZE, TC_POSIX_SOCKET_BUFFER_SIZE),
+                                 socketFd(-1), bytesRead(0), bytesWritten(0) {}
+        ~PosixSocketTransport() override;
+
+        /**
+         * Sets the socket that this transport will use, it is put into non-blocking mode, and from this point the
+         * transport owns the socket and will close it.
+         * @param fd the socket file descriptor
+         */
+        void setSocket(int fd);
+
+        /** @return the socket in use or -1 if not connected */
+        int getSocket() const { return socketFd; }
+
+        /** @return the total number of bytes read from the socket */
+        uint32_t getBytesRead() const { return bytesRead; }
+
+        /** @return the total number of bytes written to the socket */
+        uint32_t getBytesWritten() const { return bytesWritten; }
+
+        int fillReadBuffer(uint8_t* data, int maxSize) override;
+        void flush() override;
+        bool available() override;
+        bool connected() override { return socketFd >= 0; }
+        void close() override;
+    };
+
+    /**
+     * Initialises a listening TCP socket and accepts new connections for any number of TagValueRemoteServerConnection
+     * objects that each have a PosixSocketTransport. By default, it binds to localhost only.
+     */
+    class PosixSocketInitialisation : public DeviceInitialisation {
+    private:
+        const char* bindAddress;
+        uint16_t port;
+        int listenFd;
+    public:
+        /**
+         * Create the initialisation for a given port and address
+         * @param port the port to listen on, or 0 to have one allocated, see getBoundPort
+         * @param bindAddress the IPv4 address to bind to, defaults to localhost
+         */
+        explicit PosixSocketInitialisation(uint16_t port, const char* bindAddress = "127.0.0.1")
+                : bindAddress(bindAddress), port(port), listenFd(-1) {}
+        ~PosixSocketInitialisation();
+
+        bool attemptInitialisation() override;
+        bool attemptNewConnection(BaseRemoteServerConnection* remoteConnection) override;
+
+        /** @return the listening socket, or -1 if not yet initialised */
+        int getListenSocket() const { return listenFd; }
+
+        /** @return the port that is actually bound, useful when the port was given as 0 */
+        uint16_t getBoundPort() const { return port; }
+    };
+
+    /**
+     * A send only UDP transport for use with TagValueBroadcastConnection, each message is sent as its own datagram
+     * to a multicast group or any other address, so any number of listeners can follow the menu without the device
+     * knowing about them. Anything received on the socket is ignored. Datagrams can be lost, and the keyframes sent
+     * by the broadcast connection are what allow listeners to recover.
+     */
+    class PosixDatagramTransport : public BaseBufferedRemoteTransport {
+    private:
+        int socketFd;
+        uint32_t datagramsSent;
+        uint32_t sendFailures;
+    public:
+        PosixDatagramTransport() : BaseBufferedRemoteTransport(BUFFER_ONE_MESSAGE, 16, TC_POSIX_DATAGRAM_SIZE),
+                                   socketFd(-1), datagramsSent(0), sendFailures(0) {}
+        ~PosixDatagramTransport() override;
+
+        /**
+         * Sets the socket that this transport will send on, it must already be connected to its destination, and
+         * from this point the transport owns the socket and will close it.
+         * @param fd the socket file descriptor
+         */
+        void setSocket(int fd);
+
+        /** @return the number of datagrams sent */
+        uint32_t getDatagramsSent() const { return datagramsSent; }
+
+        /** @return the number of datagrams that could not be sent, they are dropped rather than retried */
+        uint32_t getSendFailures() const { return sendFailures; }
+
+        int fillReadBuffer(uint8_t* data, int maxSize) override { return 0; }
+        void flush() override;
+        bool available() override { return socketFd >= 0; }
+        bool connected() override { return socketFd >= 0; }
+        void close() override;
+    };
+
+    /**
+     * Creates the UDP socket for a PosixDatagramTransport, aimed at an address and port. For a multicast group such as
+     * 239.0.0.1, the packets are also looped back to listeners on the same host, which is convenient for testing
+     * dashboards locally. Multicast goes out of the interface chosen by the routing table unless an interface address
+     * is given, listeners must join the group on that same interface, for example 127.0.0.1 to stay on this host.
+     */
+    class PosixDatagramInitialisation : public DeviceInitialisation {
+    private:
+        const char* address;
+        const char* interfaceAddress;
+        uint16_t port;
+        uint8_t multicastTtl;
+    public:
+        /**
+         * Create the initialisation for a destination address and port
+         * @param address the IPv4 address to send to, usually a multicast group
+         * @param port the port to send to
+         * @param multicastTtl how many routers multicast packets may cross, 0 keeps them on this host
+         * @param interfaceAddress optionally the IPv4 address of the interface to send multicast from
+         */
+        PosixDatagramInitialisation(const char* address, uint16_t port, uint8_t multicastTtl = 1, const char* interfaceAddress = nullptr)
+                : address(address), interfaceAddress(interfaceAddress), port(port), multicastTtl(multicastTtl) {}
+
+        bool attemptInitialisation() override;
+        bool attemptNewConnection(BaseRemoteServerConnection* remoteConnection) override;
+    };
+
+    /**
+     * Uses poll() to wait on the listening socket and all connection sockets, marking each connection as ready when
+     * its socket has data, can be written to, or changes state. Connections added here have readiness signalling
+     * enabled, so the remote server only services them when there is work to do. Call `pollOnce` from the same thread
+     * as task manager, for example from your loop or a scheduled task, it reads the state of the transports, which
+     * the remote server changes, so it must not be called from another thread. Use a zero or short timeout so that
+     * task manager is not held up. Data that has already been read into a transport buffer is not seen by poll, the
+     * server keeps servicing such connections as pending work until their buffer has been processed.
+     */
+    class PosixSocketPoller {
+    private:
+        TagValueRemoteServerConnection* connections[ALLOWED_CONNECTIONS];
+        PosixSocketInitialisation* initialisation;
+        uint8_t connectionCount;
+    public:
+        explicit PosixSocketPoller(PosixSocketInitialisation* initialisation)
+                : connections{}, initialisation(initialisation), connectionCount(0) {}
+
+        /**
+         * Add a connection whose transport is a PosixSocketTransport, readiness signalling is enabled on it.
+         * @param connection the connection to add
+         * @return true if added, false if there is no space.
+         */
+        bool addConnection(TagValueRemoteServerConnection* connection);
+
+        /**
+         * Wait up to timeout for any socket to become ready and mark the associated connections ready, this must be
+         * called on the task manager thread.
+         * @param timeoutMillis the maximum time to wait, 0 to return immediately, -1 to wait indefinitely, which
+         *                      should only be used when nothing else is scheduled.
+         * @return the number of sockets that were ready, or -1 on error.
+         */
+        int pollOnce(int timeoutMillis);
+    };
+}
+
+#ifndef TC_MANUAL_NAMESPACING
+using namespace tcremote;
+#endif // TC_MANUAL_NAMESPACING
+
+#endif // POSIX check
+
+#endif //TCMENU_POSIXSOCKETTRANSPORT_H
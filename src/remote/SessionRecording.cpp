@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "SessionRecording.h"
+
+using namespace tcremote;
+
+const uint8_t sessionFileHeader[] = { 'T', 'C', 'S', 'R', TC_SESSION_FILE_VERSION };
+
+void SessionRecorder::record(SessionDirection dir, const uint8_t* data, size_t len, unsigned long now) {
+    // a change in direction or time starts a new record
+    if(bufferUsed != 0 && (dir != bufferDirection || now != bufferMillis)) flush();
+    bufferDirection = dir;
+    bufferMillis = now;
+
+    for(size_t i = 0; i < len; i++) {
+        if(bufferUsed == sizeof buffer) flush();
+        buffer[bufferUsed++] = data[i];
+    }
+}
+
+void SessionRecorder::flush() {
+    if(bufferUsed == 0) return;
+
+    if(!headerWritten) {
+        sink->writeRecordData(sessionFileHeader, sizeof sessionFileHeader);
+        lastRecordMillis = bufferMillis;
+        headerWritten = true;
+    }
+
+    writeVarInt(bufferMillis - lastRecordMillis);
+    writeVarInt((uint32_t(bufferUsed) << 1U) | bufferDirection);
+    if(!sink->writeRecordData(buffer, bufferUsed)) {
+        serlogF(SER_ERROR, "Session record write fail");
+    }
+    lastRecordMillis = bufferMillis;
+    recordsWritten++;
+    bufferUsed = 0;
+}
+
+void SessionRecorder::writeVarInt(uint32_t value) {
+    uint8_t encoded[5];
+    uint8_t len = 0;
+    do {
+        uint8_t b = value & 0x7f;
+        value >>= 7;
+        encoded[len++] = value ? (b | 0x80) : b;
+    } while(value != 0);
+    sink->writeRecordData(encoded, len);
+}
+
+int RecordingTransport::writeChar(char data) {
+    int written = underlying->writeChar(data);
+    if(written) recorder->record(SESSION_OUTBOUND, reinterpret_cast<const uint8_t*>(&data), 1, millis());
+    return written;
+}
+
+int RecordingTransport::writeStr(const char* data) {
+    int written = underlying->writeStr(data);
+    if(written > 0) recorder->record(SESSION_OUTBOUND, reinterpret_cast<const uint8_t*>(data), written, millis());
+    return written;
+}
+
+void RecordingTransport::commitWrite(size_t len) {
+    recorder->record(SESSION_OUTBOUND, reinterpret_cast<const uint8_t*>(reserved), len, millis());
+    underlying->commitWrite(len);
+}
+
+void RecordingTransport::startMsg(uint16_t msgType) {
+    // the underlying transport writes the start of message itself, as it may need to begin a frame or packet
+    underlying->startMsg(msgType);
+    uint8_t startOfMsg[] = { START_OF_MESSAGE, TAG_VAL_PROTOCOL, uint8_t(msgType >> 8), uint8_t(msgType & 0xff) };
+    recorder->record(SESSION_OUTBOUND, startOfMsg, sizeof startOfMsg, millis());
+}
+
+void RecordingTransport::startBinMsg(uint16_t msgType, uint16_t byteLen) {
+    underlying->startBinMsg(msgType, byteLen);
+    uint8_t startOfMsg[] = { START_OF_MESSAGE, BINARY_GZ_PROTOCOL, uint8_t(msgType >> 8), uint8_t(msgType & 0xff),
+                             highByte(byteLen), lowByte(byteLen) };
+    recorder->record(SESSION_OUTBOUND, startOfMsg, sizeof startOfMsg, millis());
+}
+
+void RecordingTransport::startChunkedBinMsg(uint16_t msgType) {
+    underlying->startChunkedBinMsg(msgType);
+    uint8_t startOfMsg[] = { START_OF_MESSAGE, BINARY_CHUNKED_PROTOCOL, uint8_t(msgType >> 8), uint8_t(msgType & 0xff) };
+    recorder->record(SESSION_OUTBOUND, startOfMsg, sizeof startOfMsg, millis());
+}
+
+void RecordingTransport::endMsg() {
+    // the underlying transport writes the end of message itself, as it may need to flush afterwards
+    underlying->endMsg();
+    uint8_t endOfMsg = 0x02;
+    recorder->record(SESSION_OUTBOUND, &endOfMsg, 1, millis());
+}
+
+uint8_t RecordingTransport::readByte() {
+    uint8_t data = underlying->readByte();
+    recorder->record(SESSION_INBOUND, &data, 1, millis());
+    return data;
+}
+
+void RecordingTransport::flush() {
+    underlying->flush();
+    recorder->flush();
+}
+
+void RecordingTransport::close() {
+    recorder->flush();
+    underlying->close();
+    clearFieldStatus(FVAL_PROCESSING_AWAITINGMSG);
+}
+
+SessionReplayTransport::SessionReplayTransport(const uint8_t* session, size_t len, SessionReplayTiming timing)
+        : TagValueTransport(TVAL_UNBUFFERED), session(session), sessionLen(len), inPosition(0), inRemaining(0),
+          inTime(0), outPosition(0), outRemaining(0), outTime(0), replayStarted(0), bytesReplayed(0),
+          bytesWritten(0), outboundMismatches(0), timing(timing), open(false) {
+    restart();
+}
+
+bool SessionReplayTransport::restart() {
+    inRemaining = outRemaining = 0;
+    inTime = outTime = 0;
+    bytesReplayed = bytesWritten = outboundMismatches = 0;
+    replayStarted = millis();
+    clearFieldStatus(FVAL_PROCESSING_AWAITINGMSG);
+
+    if(sessionLen < sizeof sessionFileHeader || memcmp(session, sessionFileHeader, sizeof sessionFileHeader) != 0) {
+        serlogF(SER_ERROR, "Not a session recording");
+        inPosition = outPosition = sessionLen;
+        open = false;
+        return false;
+    }
+    inPosition = outPosition = sizeof sessionFileHeader;
+    open = true;
+    return true;
+}
+
+bool SessionReplayTransport::readVarInt(size_t& position, uint32_t& value) {
+    value = 0;
+    for(uint8_t shift = 0; shift < 35 && position < sessionLen; shift += 7) {
+        uint8_t b = session[position++];
+        value |= uint32_t(b & 0x7f) << shift;
+        if((b & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool SessionReplayTransport::nextRecord(size_t& position, size_t& remaining, SessionDirection dir, unsigned long& time) {
+    // each cursor moves over every record, so that it keeps track of the time, but stops only on its own direction.
+    while(position < sessionLen) {
+        uint32_t delta, lenAndDir;
+        if(!readVarInt(position, delta) || !readVarInt(position, lenAndDir)) break;
+        size_t len = lenAndDir >> 1U;
+        if(len > (sessionLen - position)) break;
+        time += delta;
+        if(SessionDirection(lenAndDir & 1U) == dir && len != 0) {
+            remaining = len;
+            return true;
+        }
+        position += len;
+    }
+    position = sessionLen;
+    remaining = 0;
+    return false;
+}
+
+bool SessionReplayTransport::readAvailable() {
+    if(!open) return false;
+    if(inRemaining == 0 && !nextRecord(inPosition, inRemaining, SESSION_INBOUND, inTime)) return false;
+    return timing == REPLAY_AS_FAST_AS_POSSIBLE || (millis() - replayStarted) >= inTime;
+}
+
+uint8_t SessionReplayTransport::readByte() {
+    if(!readAvailable()) return 0xff;
+    inRemaining--;
+    bytesReplayed++;
+    return session[inPosition++];
+}
+
+bool SessionReplayTransport::isFinished() {
+    if(inRemaining != 0) return false;
+    size_t position = inPosition;
+    size_t remaining;
+    unsigned long time = inTime;
+    return !nextRecord(position, remaining, SESSION_INBOUND, time);
+}
+
+int SessionReplayTransport::writeChar(char data) {
+    bytesWritten++;
+    if(outRemaining == 0 && !nextRecord(outPosition, outRemaining, SESSION_OUTBOUND, outTime)) {
+        outboundMismatches++;
+        return 1;
+    }
+    if(session[outPosition] != uint8_t(data)) outboundMismatches++;
+    outPosition++;
+    outRemaining--;
+    return 1;
+}
+
+int SessionReplayTransport::writeStr(const char* data) {
+    int len = 0;
+    while(data[len]) {
+        writeChar(data[len]);
+        len++;
+    }
+    return len;
+}
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+
+bool FileSessionRecordSink::openFile(const char* path) {
+    closeFile();
+    file = fopen(path, "wb");
+    if(file == nullptr) {
+        serlogF2(SER_ERROR, "Session file open fail ", path);
+        return false;
+    }
+    return true;
+}
+
+void FileSessionRecordSink::closeFile() {
+    if(file != nullptr) fclose(file);
+    file = nullptr;
+}
+
+bool FileSessionRecordSink::writeRecordData(const uint8_t* data, size_t len) {
+    return file != nullptr && fwrite(data, 1, len, file) == len;
+}
+
+uint8_t* tcremote::loadSessionFile(const char* path, size_t& lenOut) {
+    lenOut = 0;
+    FILE* file = fopen(path, "rb");
+    if(file == nullptr) return nullptr;
+
+    uint8_t* data = nullptr;
+    if(fseek(file, 0, SEEK_END) == 0) {
+        long len = ftell(file);
+        if(len > 0 && fseek(file, 0, SEEK_SET) == 0) {
+            data = new uint8_t[len];
+            if(fread(data, 1, len, file) == (size_t)len) {
+                lenOut = len;
+            } else {
+                delete[] data;
+                data = nullptr;
+            }
+        }
+    }
+    fclose(file);
+    return data;
+}
+
+#endif // TC_POSIX_REMOTE_SUPPORT
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file SessionRecording.h
+ * @brief records the raw traffic of a tag value session with timing, and replays it back through a transport.
+ */
+
+#ifndef TCMENU_SESSIONRECORDING_H
+#define TCMENU_SESSIONRECORDING_H
+
+#include <PlatformDetermination.h>
+#include "../RemoteConnector.h"
+#include "PosixSocketTransport.h"
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+#include <stdio.h>
+#endif
+
+#ifndef TC_SESSION_RECORD_BUFFER_SIZE
+#define TC_SESSION_RECORD_BUFFER_SIZE 32
+#endif
+
+#define TC_SESSION_FILE_VERSION 1
+
+namespace tcremote {
+
+    /**
+     * The direction of a block of recorded session data, from the point of view of the device.
+     */
+    enum SessionDirection : uint8_t {
+        /** data that was read from the remote */
+        SESSION_INBOUND = 0,
+        /** data that was written to the remote */
+        SESSION_OUTBOUND = 1
+    };
+
+    /**
+     * Somewhere that session recordings can be written, such as a file on a host or an SD card on a device.
+     */
+    class SessionRecordSink {
+    public:
+        virtual ~SessionRecordSink() = default;
+        /**
+         * Write recorded data to the sink
+         * @param data the data to write
+         * @param len the length of the data
+         * @return true if written, otherwise false.
+         */
+        virtual bool writeRecordData(const uint8_t* data, size_t len) = 0;
+    };
+
+    /**
+     * Encodes session traffic into the compact recording format. A recording starts with the bytes `TCSR` and a version
+     * byte, followed by any number of records. Each record is a variable length integer holding the millis since the
+     * previous record, then a variable length integer holding the data length shifted left by one with the direction
+     * in the lowest bit, then the data itself. Variable length integers are seven bits per byte, lowest first, with the
+     * top bit set when more bytes follow.
+     *
+     * Bytes going in the same direction at the same millisecond are coalesced into a single record, so a typical
+     * session costs little more than the traffic itself.
+     */
+    class SessionRecorder {
+    private:
+        SessionRecordSink* sink;
+        unsigned long lastRecordMillis;
+        unsigned long bufferMillis;
+        uint32_t recordsWritten;
+        uint8_t buffer[TC_SESSION_RECORD_BUFFER_SIZE];
+        uint8_t bufferUsed;
+        SessionDirection bufferDirection;
+        bool headerWritten;
+    public:
+        explicit SessionRecorder(SessionRecordSink* sink) : sink(sink), lastRecordMillis(0), bufferMillis(0), recordsWritten(0), buffer{},
+                                                            bufferUsed(0), bufferDirection(SESSION_INBOUND), headerWritten(false) {}
+
+        /**
+         * Records data that has travelled in a given direction at the given time
+         * @param dir the direction of the data
+         * @param data the data itself
+         * @param len the length of the data
+         * @param now the current millis
+         */
+        void record(SessionDirection dir, const uint8_t* data, size_t len, unsigned long now);
+
+        /**
+         * Writes any data that is being coalesced to the sink, call before closing the sink.
+         */
+        void flush();
+
+        /** @return the number of records written so far */
+        uint32_t getRecordsWritten() const { return recordsWritten; }
+    private:
+        void writeVarInt(uint32_t value);
+    };
+
+    /**
+     * A transport that wraps any other transport and records all the traffic passing through it, along with its
+     * timing, to a SessionRecorder. Give this transport to the connector or server connection instead of the real
+     * one. When the real transport is buffered, the server connection still flushes it as normal.
+     */
+    class RecordingTransport : public TagValueTransport {
+    private:
+        TagValueTransport* underlying;
+        SessionRecorder* recorder;
+        char* reserved;
+    public:
+        RecordingTransport(TagValueTransport* underlying, SessionRecorder* recorder)
+                : TagValueTransport(TVAL_RECORDING), underlying(underlying), recorder(recorder), reserved(nullptr) {}
+
+        /** @return the transport that is being recorded */
+        TagValueTransport* getUnderlying() { return underlying; }
+
+        void startMsg(uint16_t msgType) override;
+        void startBinMsg(uint16_t msgType, uint16_t byteLen) override;
+        void startChunkedBinMsg(uint16_t msgType) override;
+        void flush() override;
+        int writeChar(char data) override;
+        int writeStr(const char* data) override;
+        char* reserveWrite(size_t len) override { return reserved = underlying->reserveWrite(len); }
+        void commitWrite(size_t len) override;
+        uint8_t readByte() override;
+        bool readAvailable() override { return underlying->readAvailable(); }
+        bool available() override { return underlying->available(); }
+        bool connected() override { return underlying->connected(); }
+        void close() override;
+        void endMsg() override;
+    };
+
+    /**
+     * How a replay transport releases inbound data to the connector.
+     */
+    enum SessionReplayTiming : uint8_t {
+        /** inbound data is available as soon as it is reached, useful for measuring parsing and processing speed */
+        REPLAY_AS_FAST_AS_POSSIBLE,
+        /** inbound data is available when the same time has passed as in the original session */
+        REPLAY_ORIGINAL_TIMING
+    };
+
+    /**
+     * A transport that replays a recorded session, the recording is provided as a block of memory in the format
+     * written by SessionRecorder. Inbound records are fed to the connector as if they came from the remote, and
+     * anything the connector writes is compared with the recorded outbound data. Comparing outbound data is only a
+     * guide, as messages such as heartbeats carry the current time and will differ from the original session.
+     */
+    class SessionReplayTransport : public TagValueTransport {
+    private:
+        const uint8_t* session;
+        size_t sessionLen;
+        size_t inPosition;
+        size_t inRemaining;
+        unsigned long inTime;
+        size_t outPosition;
+        size_t outRemaining;
+        unsigned long outTime;
+        unsigned long replayStarted;
+        uint32_t bytesReplayed;
+        uint32_t bytesWritten;
+        uint32_t outboundMismatches;
+        SessionReplayTiming timing;
+        bool open;
+    public:
+        /**
+         * Create a replay transport for a recording that is in memory, the memory must remain valid during the replay
+         * @param session the recording
+         * @param len the length of the recording
+         * @param timing how to release inbound data, defaults to as fast as possible
+         */
+        SessionReplayTransport(const uint8_t* session, size_t len, SessionReplayTiming timing = REPLAY_AS_FAST_AS_POSSIBLE);
+
+        /**
+         * Restart the replay from the beginning, the counters are reset too.
+         * @return true if the recording has a valid header, otherwise false.
+         */
+        bool restart();
+
+        /** @return true when all inbound data has been read by the connector */
+        bool isFinished();
+
+        /** @return the number of inbound bytes that have been read by the connector */
+        uint32_t getBytesReplayed() const { return bytesReplayed; }
+
+        /** @return the number of bytes that have been written by the connector */
+        uint32_t getBytesWritten() const { return bytesWritten; }
+
+        /** @return the number of written bytes that did not match the recording, or went past its end */
+        uint32_t getOutboundMismatches() const { return outboundMismatches; }
+
+        void flush() override {}
+        int writeChar(char data) override;
+        int writeStr(const char* data) override;
+        uint8_t readByte() override;
+        bool readAvailable() override;
+        bool available() override { return open; }
+        bool connected() override { return open; }
+        void close() override { open = false; }
+    private:
+        bool nextRecord(size_t& position, size_t& remaining, SessionDirection dir, unsigned long& time);
+        bool readVarInt(size_t& position, uint32_t& value);
+    };
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+    /**
+     * A session record sink that writes to a file on a POSIX host.
+     */
+    class FileSessionRecordSink : public SessionRecordSink {
+    private:
+        FILE* file;
+    public:
+        FileSessionRecordSink() : file(nullptr) {}
+        ~FileSessionRecordSink() override { closeFile(); }
+
+        /**
+         * Open a file to record into, any existing file is replaced.
+         * @param path the file to write
+         * @return true if opened, otherwise false
+         */
+        bool openFile(const char* path);
+
+        /** close the file if it is open */
+        void closeFile();
+
+        bool writeRecordData(const uint8_t* data, size_t len) override;
+    };
+
+    /**
+     * Reads a whole session recording from a file into memory, ready to be given to a SessionReplayTransport.
+     * @param path the file to read
+     * @param lenOut the length of the data that was read
+     * @return the data allocated using new[], which the caller must delete[], or nullptr if it could not be read.
+     */
+    uint8_t* loadSessionFile(const char* path, size_t& lenOut);
+#endif // TC_POSIX_REMOTE_SUPPORT
+}
+
+#ifndef TC_MANUAL_NAMESPACING
+using namespace tcremote;
+#endif // TC_MANUAL_NAMESPACING
+
+#endif //TCMENU_SESSIONRECORDING_H
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+#include "WebSocketFramedTransport.h"
+
+using namespace tcremote;
+
+WebSocketFramedTransport::WebSocketFramedTransport(uint8_t bufferSize, BufferingMode mode)
+        : BaseBufferedRemoteTransport(mode, bufferSize, bufferSize), header{}, control{}, payloadRemaining(0),
+          headerLen(0), controlLen(0), maskIndex(0), frameOpcode(WS_OPCODE_BINARY), inPayload(false) {
+    // the write buffer is replaced with one that has room for the frame header in front of it, so that the header can
+    // be written in place when flushing, the base class deletes the buffer at the start position.
+    delete[] writeBuffer;
+    frameBuffer = new uint8_t[bufferSize + TC_WEBSOCKET_MAX_SERVER_HEADER];
+    writeBuffer = frameBuffer + TC_WEBSOCKET_MAX_SERVER_HEADER;
+}
+
+WebSocketFramedTransport::~WebSocketFramedTransport() {
+    writeBuffer = frameBuffer;
+}
+
+void WebSocketFramedTransport::close() {
+    BaseBufferedRemoteTransport::close();
+    headerLen = controlLen = maskIndex = 0;
+    payloadRemaining = 0;
+    inPayload = false;
+}
+
+uint8_t WebSocketFramedTransport::headerSizeNeeded() const {
+    if(headerLen < 2) return 2;
+    uint8_t len7 = header[1] & 0x7f;
+    uint8_t needed = 2 + ((len7 == 126) ? 2 : (len7 == 127) ? 8 : 0);
+    return needed + ((header[1] & 0x80) ? 4 : 0);
+}
+
+void WebSocketFramedTransport::headerComplete() {
+    uint8_t len7 = header[1] & 0x7f;
+    uint8_t pos = 2;
+    if(len7 == 126) {
+        payloadRemaining = (uint32_t(header[2]) << 8) | header[3];
+        pos = 4;
+    } else if(len7 == 127) {
+        // we never accept frames over 4GB, so only the lower four bytes are of interest.
+        payloadRemaining = (uint32_t(header[6]) << 24) | (uint32_t(header[7]) << 16) | (uint32_t(header[8]) << 8) | header[9];
+        pos = 10;
+    } else {
+        payloadRemaining = len7;
+    }
+
+    // continuation frames carry on with the opcode of the data frame they follow.
+    auto opcode = WebSocketOpcode(header[0] & 0x0f);
+    if(opcode != WS_OPCODE_CONTINUATION) frameOpcode = opcode;
+    else if(frameOpcode >= WS_OPCODE_CLOSE) frameOpcode = WS_OPCODE_BINARY;
+
+    // RFC 6455 requires every frame from a client to be masked, and the server to fail the connection otherwise.
+    if((header[1] & 0x80) == 0) {
+        serlogF(SER_WARNING, "Websocket frame not masked");
+        const uint8_t protocolError[] = { 0x03, 0xEA }; // status 1002
+        sendControlFrame(WS_OPCODE_CLOSE, protocolError, sizeof protocolError);
+        close();
+        return;
+    }
+    memmove(header, &header[pos], 4); // keep the mask key at the start of header.
+    maskIndex = 0;
+    controlLen = 0;
+    headerLen = 0;
+    inPayload = true;
+
+    if(payloadRemaining == 0) {
+        inPayload = false;
+        if(frameOpcode >= WS_OPCODE_CLOSE) controlFrameComplete();
+    }
+}
+
+void WebSocketFramedTransport::controlFrameComplete() {
+    if(frameOpcode == WS_OPCODE_PING) {
+        sendControlFrame(WS_OPCODE_PONG, control, controlLen);
+    } else if(frameOpcode == WS_OPCODE_CLOSE) {
+        serlogF(SER_NETWORK_INFO, "Websocket close frame");
+        sendControlFrame(WS_OPCODE_CLOSE, nullptr, 0);
+        close();
+    }
+    // pongs need no action, we never send pings
+}
+
+int WebSocketFramedTransport::fillReadBuffer(uint8_t* data, int maxSize) {
+    // raw data is read straight into the read buffer, headers are then removed and the payload unmasked in place, as
+    // the output position can never be ahead of the input position.
+    int amt = readRawBytes(data, maxSize);
+    if(amt <= 0) return 0;
+
+    int out = 0;
+    for(int i = 0; i < amt; i++) {
+        uint8_t ch = data[i];
+        if(!inPayload) {
+            header[headerLen++] = ch;
+            if(headerLen == headerSizeNeeded()) {
+                headerComplete();
+                if(!connected()) return 0;
+            }
+            continue;
+        }
+
+        ch ^= header[maskIndex];
+        maskIndex = (maskIndex + 1) & 3;
+        if(frameOpcode < WS_OPCODE_CLOSE) {
+            data[out++] = ch;
+        } else if(controlLen < sizeof control) {
+            control[controlLen++] = ch;
+        } else {
+            controlLen = 0xff; // too large to echo back
+        }
+
+        if(--payloadRemaining == 0) {
+            inPayload = false;
+            if(frameOpcode >= WS_OPCODE_CLOSE) {
+                if(controlLen == 0xff) controlLen = 0;
+                controlFrameComplete();
+                if(!connected()) return 0;
+            }
+        }
+    }
+    return out;
+}
+
+void WebSocketFramedTransport::flush() {
+    if(writeBufferPos == 0) return;
+
+    // the header is built directly in front of the data already in the write buffer.
+    uint8_t headerSize = writeBufferPos < 126 ? 2 : 4;
+    uint8_t* frame = writeBuffer - headerSize;
+    frame[0] = 0x80 | WS_OPCODE_BINARY;
+    if(headerSize == 2) {
+        frame[1] = uint8_t(writeBufferPos);
+    } else {
+        frame[1] = 126;
+        frame[2] = highByte(writeBufferPos);
+        frame[3] = lowByte(writeBufferPos);
+    }
+    uint16_t frameLen = writeBufferPos + headerSize;
+    writeBufferPos = 0;
+    writeFrame(frame, frameLen);
+}
+
+bool WebSocketFramedTransport::writeFrame(const uint8_t* frame, int len) {
+    // a frame that is only partly written would corrupt the stream, so keep going until the device takes no more.
+    int written = 0;
+    while(written < len) {
+        int amt = writeRawBytes(&frame[written], len - written);
+        if(amt <= 0) {
+            serlogF3(SER_WARNING, "Websocket frame not written (wr, len) ", written, len);
+            close();
+            return false;
+        }
+        written += amt;
+    }
+    return true;
+}
+
+void WebSocketFramedTransport::sendControlFrame(WebSocketOpcode opcode, const uint8_t* payload, uint8_t len) {
+    // any data waiting must go first, control frames cannot be sent in the middle of another frame.
+    flush();
+    if(!connected()) return;
+    uint8_t frame[2 + TC_WEBSOCKET_CONTROL_SIZE];
+    frame[0] = 0x80 | opcode;
+    frame[1] = len;
+    if(len) memcpy(&frame[2], payload, len);
+    writeFrame(frame, len + 2);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018 https://www.thecoderscorner.com (Dave Cherry).
+ * This product is licensed under an Apache license, see the LICENSE file in the top-level directory.
+ */
+
+/**
+ * @file WebSocketFramedTransport.h
+ * @brief a buffered transport that frames tag value traffic as WebSocket frames, for TAG_VAL_WEB_SOCKET servers.
+ */
+
+#ifndef TCMENU_WEBSOCKETFRAMEDTRANSPORT_H
+#define TCMENU_WEBSOCKETFRAMEDTRANSPORT_H
+
+#include <PlatformDetermination.h>
+#include "BaseBufferedRemoteTransport.h"
+
+// The largest control frame payload (such as a ping) that will be kept, larger ping payloads are answered with an
+// empty pong.
+#ifndef TC_WEBSOCKET_CONTROL_SIZE
+#define TC_WEBSOCKET_CONTROL_SIZE 16
+#endif
+
+// Server to client frames have at most a four byte header, as the write buffer is never more than 64K.
+#define TC_WEBSOCKET_MAX_SERVER_HEADER 4
+
+namespace tcremote {
+
+    enum WebSocketOpcode : uint8_t {
+        WS_OPCODE_CONTINUATION = 0x00,
+        WS_OPCODE_TEXT = 0x01,
+        WS_OPCODE_BINARY = 0x02,
+        WS_OPCODE_CLOSE = 0x08,
+        WS_OPCODE_PING = 0x09,
+        WS_OPCODE_PONG = 0x0A
+    };
+
+    /**
+     * A transport that handles WebSocket framing for tag value connections, once the HTTP upgrade handshake has been
+     * completed by the device specific code, all data is sent and received through this class. Each flush of the write
+     * buffer is sent as a single binary frame, the frame header is written directly in front of the buffered data, so
+     * the frame goes to the device in one write without copying. Incoming frames from the client are unmasked in place
+     * within the read buffer, and control frames are handled here: pings are answered with a pong, and a close frame
+     * is answered with a close frame before closing the connection. A frame from the client that is not masked fails
+     * the connection with a protocol error, as RFC 6455 requires.
+     *
+     * Extend this class providing the raw read and write functions for the device, and call `close` on this class from
+     * your override of close. Fragmented messages are supported, as the payload of every data frame is passed through
+     * as one stream.
+     */
+    class WebSocketFramedTransport : public BaseBufferedRemoteTransport {
+    private:
+        uint8_t* frameBuffer;
+        uint8_t header[14];
+        uint8_t control[TC_WEBSOCKET_CONTROL_SIZE];
+        uint32_t payloadRemaining;
+        uint8_t headerLen;
+        uint8_t controlLen;
+        uint8_t maskIndex;
+        WebSocketOpcode frameOpcode;
+        bool inPayload;
+    public:
+        /**
+         * Create a websocket transport with a buffer size for reading and writing.
+         * @param bufferSize the size of the read and write buffers
+         * @param mode the buffering mode, with one message each message is sent as its own frame
+         */
+        explicit WebSocketFramedTransport(uint8_t bufferSize, BufferingMode mode = BUFFER_MESSAGES_TILL_FULL);
+        ~WebSocketFramedTransport() override;
+
+        int fillReadBuffer(uint8_t* data, int maxSize) override;
+        void flush() override;
+        void close() override;
+
+        /**
+         * Read raw bytes from the underlying device without blocking.
+         * @param data the buffer to read into
+         * @param maxSize the maximum number of bytes to read
+         * @return the number of bytes read, 0 if none available.
+         */
+        virtual int readRawBytes(uint8_t* data, int maxSize) = 0;
+
+        /**
+         * Write raw bytes to the underlying device. When fewer than len bytes are written, this is called again with the
+         * rest of the frame, if no bytes at all can be written the connection is closed, as the frame cannot be completed.
+         * @param data the bytes to write
+         * @param len the number of bytes to write
+         * @return the number of bytes written, 0 or less if nothing could be written.
+         */
+        virtual int writeRawBytes(const uint8_t* data, int len) = 0;
+    private:
+        void headerComplete();
+        void controlFrameComplete();
+        void sendControlFrame(WebSocketOpcode opcode, const uint8_t* payload, uint8_t len);
+        bool writeFrame(const uint8_t* frame, int len);
+        uint8_t headerSizeNeeded() const;
+    };
+}
+
+#ifndef TC_MANUAL_NAMESPACING
+using namespace tcremote;
+#endif // TC_MANUAL_NAMESPACING
+
+#endif //TCMENU_WEBSOCKETFRAMEDTRANSPORT_H
@@ -19,6 +19,7 @@ int fromKeyToIndex(char ch) {
 
 void MenuEditingKeyListener::keyPressed(char key, bool held) {
     MenuItem *editor = menuMgr.getCurrentEditor();
+    if(menuMgr.getRenderer()->getRendererType() != RENDER_TYPE_NOLOCAL) BaseMenuRenderer::getInstance()->menuAltered();
 
     // holding delete always resets the menu.
     if (key == deleteKey && held) {
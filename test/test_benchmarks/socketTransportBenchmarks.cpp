@@ -0,0 +1,96 @@
+#include <unity.h>
+#include <remote/PosixSocketTransport.h>
+#include "../tutils/TestRemoteTransport.h"
+#include "../tutils/PosixLoopbackClient.h"
+
+using namespace tcremote;
+
+#define BENCHMARK_CHANGE_ROUNDS 200
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+
+void serviceBenchmark(TagValueRemoteServerConnection** connections, PosixLoopbackClient* clients, int count, int loops) {
+    for(int loop = 0; loop < loops; loop++) {
+        for(int i = 0; i < count; i++) connections[i]->runLoop();
+        for(int i = 0; i < count; i++) clients[i].readAvailable();
+    }
+}
+
+/**
+ * Joins the given number of loopback clients to a socket server, then changes a menu item over and over, waiting
+ * each time until every client has the change. Reports the average time for a change to reach all clients, and the
+ * total bytes per second sent to the clients.
+ */
+void benchmarkSocketClients(int count) {
+    PosixSocketInitialisation initialisation(0);
+    PosixSocketTransport transports[ALLOWED_CONNECTIONS];
+    TagValueRemoteServerConnection* connections[ALLOWED_CONNECTIONS];
+    PosixLoopbackClient clients[ALLOWED_CONNECTIONS];
+    for(int i = 0; i < count; i++) {
+        connections[i] = new TagValueRemoteServerConnection(transports[i], initialisation);
+        connections[i]->init(i, testRemoteLocalInfo);
+    }
+    connections[0]->runLoop();
+    for(int i = 0; i < count; i++) TEST_ASSERT_TRUE(clients[i].connectTo(initialisation.getBoundPort()));
+
+    // connect, join and bootstrap every client before timing anything
+    serviceBenchmark(connections, clients, count, 200);
+    for(int i = 0; i < count; i++) {
+        char join[80];
+        snprintf(join, sizeof join, "NM=bench%d|UU=2ba37227-a412-40b7-94e7-42caf9bb0ff4|VE=100|PF=0|", i);
+        clients[i].sendMessage(MSG_HEARTBEAT, "HR=1|");
+        clients[i].sendMessage(MSG_JOIN, join);
+    }
+    serviceBenchmark(connections, clients, count, 2000);
+    for(int i = 0; i < count; i++) {
+        TEST_ASSERT_TRUE(connections[i]->connector()->isAuthenticated());
+        TEST_ASSERT_FALSE(connections[i]->connector()->hasPendingWrites());
+        clients[i].totalReceived = 0;
+    }
+
+    unsigned long totalLatency = 0;
+    unsigned long started = micros();
+    for(int round = 0; round < BENCHMARK_CHANGE_ROUNDS; round++) {
+        // each service loop counts as at least a tick, so the clients heartbeat often to stay connected.
+        for(int i = 0; i < count; i++) {
+            clients[i].clearReceived();
+            if((round % 10) == 0) clients[i].sendMessage(MSG_HEARTBEAT, "HR=0|");
+        }
+        int value = int(menuVolume.getCurrentValue() + 1) % 100;
+        menuVolume.setCurrentValue(value);
+        char expected[16];
+        snprintf(expected, sizeof expected, "|VC=%d|", value);
+
+        unsigned long changed = micros();
+        int waiting = count;
+        for(int loop = 0; loop < 10000 && waiting != 0; loop++) {
+            serviceBenchmark(connections, clients, count, 1);
+            waiting = 0;
+            for(int i = 0; i < count; i++) if(!clients[i].hasReceived(expected)) waiting++;
+        }
+        TEST_ASSERT_EQUAL(0, waiting);
+        totalLatency += micros() - changed;
+    }
+    unsigned long elapsed = micros() - started;
+
+    uint32_t bytes = 0;
+    for(int i = 0; i < count; i++) bytes += clients[i].totalReceived;
+    char sz[120];
+    snprintf(sz, sizeof sz, "%d client(s): change reaches all in %luus, %lu bytes/sec to clients", count,
+             totalLatency / BENCHMARK_CHANGE_ROUNDS, elapsed ? (unsigned long)((bytes * 1000000.0) / elapsed) : 0UL);
+    TEST_MESSAGE(sz);
+
+    for(int i = 0; i < count; i++) delete connections[i];
+}
+
+#endif
+
+void benchmarkSocketServerThroughputAndLatency() {
+#ifdef TC_POSIX_REMOTE_SUPPORT
+    for(int count = 1; count <= ALLOWED_CONNECTIONS; count *= 2) {
+        benchmarkSocketClients(count);
+    }
+#else
+    TEST_IGNORE_MESSAGE("needs POSIX sockets");
+#endif
+}
@@ -0,0 +1,150 @@
+#include <unity.h>
+#include <RemoteConnector.h>
+#include <remote/BaseBufferedRemoteTransport.h>
+#include "../tutils/fixtures_extern.h"
+#include "../tutils/TestRemoteTransport.h"
+
+using namespace tcremote;
+
+#define BENCHMARK_FIELD_ROUNDS 100000
+#define BENCHMARK_BOOTSTRAP_ROUNDS 200
+#define BENCHMARK_CHANGE_ROUNDS 2000
+
+/**
+ * A buffered transport that throws away everything it writes, apart from counting bytes and messages, so that only
+ * the cost of formatting is measured. Writing in place can be turned off to measure the part-wise path instead. Any
+ * messages queued are given to the connector to read.
+ */
+class DiscardingBufferedTransport : public BaseBufferedRemoteTransport {
+private:
+    char inbound[256] = {};
+    int inboundLen = 0;
+    int inboundPos = 0;
+    uint8_t headerPos = 0;
+public:
+    bool inPlace = true;
+    uint32_t bytes = 0;
+    uint32_t messages = 0;
+    uint32_t changeMessages = 0;
+
+    explicit DiscardingBufferedTransport(uint8_t bufferSize) : BaseBufferedRemoteTransport(BUFFER_MESSAGES_TILL_FULL, bufferSize, bufferSize) {}
+
+    char* reserveWrite(size_t len) override { return inPlace ? BaseBufferedRemoteTransport::reserveWrite(len) : nullptr; }
+
+    int fillReadBuffer(uint8_t* data, int maxSize) override {
+        int amt = 0;
+        while(inboundPos < inboundLen && amt < maxSize) data[amt++] = inbound[inboundPos++];
+        return amt;
+    }
+
+    void flush() override {
+        for(int i = 0; i < writeBufferPos; i++) {
+            // follow the message headers, start of message, protocol, then the two message type bytes.
+            char ch = char(writeBuffer[i]);
+            if(headerPos == 0) {
+                if(ch == START_OF_MESSAGE) headerPos = 1;
+            } else if(headerPos == 1) {
+                messages++;
+                headerPos = 2;
+            } else if(headerPos == 2) {
+                headerPos = (ch == 'V') ? 3 : 0;
+            } else {
+                if(ch == 'C') changeMessages++;
+                headerPos = 0;
+            }
+        }
+        bytes += writeBufferPos;
+        writeBufferPos = 0;
+    }
+
+    bool available() override { return true; }
+    bool connected() override { return true; }
+
+    void queueMessage(uint16_t msgType, const char* fields) {
+        inboundLen = snprintf(inbound, sizeof inbound, "%c%c%c%c%s%c", START_OF_MESSAGE, TAG_VAL_PROTOCOL,
+                              char(msgType >> 8), char(msgType & 0xff), fields, 0x02);
+        inboundPos = 0;
+    }
+};
+
+void reportRate(const char* what, uint32_t count, unsigned long elapsedMicros) {
+    char sz[100];
+    snprintf(sz, sizeof sz, "%s: %lu per second", what,
+             elapsedMicros ? (unsigned long)((count * 1000000.0) / elapsedMicros) : 0UL);
+    TEST_MESSAGE(sz);
+}
+
+unsigned long timeFieldWriting(DiscardingBufferedTransport& transport) {
+    unsigned long started = micros();
+    for(long i = 0; i < BENCHMARK_FIELD_ROUNDS; i++) {
+        transport.writeFieldInt(FIELD_ID, int(i & 0x7fff));
+        transport.writeFieldLong(FIELD_TIMESTAMP, i * 7919L);
+        transport.writeField(FIELD_MSG_NAME, "Volume");
+    }
+    return micros() - started;
+}
+
+void benchmarkTagValueFieldWriting() {
+    // the same fields written into a 16 byte buffer, first formatted in place, then through the part-wise path.
+    DiscardingBufferedTransport inPlace(16);
+    unsigned long inPlaceMicros = timeFieldWriting(inPlace);
+    DiscardingBufferedTransport partWise(16);
+    partWise.inPlace = false;
+    unsigned long partWiseMicros = timeFieldWriting(partWise);
+
+    TEST_ASSERT_EQUAL(inPlace.bytes, partWise.bytes);
+    reportRate("fields written in place", BENCHMARK_FIELD_ROUNDS * 3, inPlaceMicros);
+    reportRate("fields written part-wise", BENCHMARK_FIELD_ROUNDS * 3, partWiseMicros);
+}
+
+void benchmarkBootstrapAndChangeStream() {
+    // bootstrap the whole menu over and over, each time on a newly joined connection.
+    uint32_t bootItems = 0;
+    unsigned long bootMicros = 0;
+    for(int round = 0; round < BENCHMARK_BOOTSTRAP_ROUNDS; round++) {
+        DiscardingBufferedTransport transport(128);
+        TestRemoteConnection remote(&transport);
+        remote.tickFor(2);
+        transport.queueMessage(MSG_JOIN, "NM=bench|UU=2ba37227-a412-40b7-94e7-42caf9bb0ff4|VE=100|PF=0|");
+        transport.flush();
+        uint32_t before = transport.messages;
+
+        // the join is read a field per tick, then the bootstrap is written an item per tick until it is complete.
+        unsigned long started = micros();
+        for(int i = 0; i < 1000 && !remote.connector.hasPendingWrites(); i++) remote.connector.tick();
+        for(int i = 0; i < 1000 && remote.connector.hasPendingWrites(); i++) remote.connector.tick();
+        transport.flush();
+        bootMicros += micros() - started;
+        TEST_ASSERT_TRUE(remote.connector.isAuthenticated());
+        TEST_ASSERT_FALSE(remote.connector.hasPendingWrites());
+        // the bootstrap start and end messages are not items
+        bootItems += transport.messages - before - 2;
+    }
+    reportRate("bootstrap items", bootItems, bootMicros);
+
+    // then stream value changes to a joined connection, each round changes two items and ticks until both are sent.
+    DiscardingBufferedTransport transport(128);
+    TestRemoteConnection remote(&transport);
+    remote.tickFor(2);
+    transport.queueMessage(MSG_JOIN, "NM=bench|UU=2ba37227-a412-40b7-94e7-42caf9bb0ff4|VE=100|PF=0|");
+    remote.tickFor(1000);
+    TEST_ASSERT_FALSE(remote.connector.hasPendingWrites());
+    transport.flush();
+    transport.changeMessages = 0;
+
+    unsigned long started = micros();
+    for(int round = 0; round < BENCHMARK_CHANGE_ROUNDS; round++) {
+        // the remote heartbeats now and then, otherwise the connection would time out part way through.
+        if((round % 50) == 0) transport.queueMessage(MSG_HEARTBEAT, "HR=0|");
+        menuVolume.setCurrentValue((menuVolume.getCurrentValue() + 1) % 100);
+        menuLHSTemp.setCurrentValue((menuLHSTemp.getCurrentValue() + 1) % 100);
+        uint32_t expected = transport.changeMessages + 2;
+        for(int i = 0; i < 1000 && transport.changeMessages < expected; i++) {
+            remote.connector.tick();
+            transport.flush();
+        }
+    }
+    unsigned long changeMicros = micros() - started;
+    TEST_ASSERT_EQUAL((uint32_t)BENCHMARK_CHANGE_ROUNDS * 2, transport.changeMessages);
+    reportRate("change stream items", transport.changeMessages, changeMicros);
+}
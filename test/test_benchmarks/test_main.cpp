@@ -0,0 +1,41 @@
+#include <unity.h>
+#include <tcMenu.h>
+#include "../tutils/fixtures_extern.h"
+#include <tcm_test/testFixtures.h>
+
+// The benchmarks measure and report using TEST_MESSAGE, they only fail when the work itself goes wrong, the timings
+// are for comparing before and after a change on the same machine.
+
+// socket transport benchmarks
+void benchmarkSocketServerThroughputAndLatency();
+
+// tag value writer benchmarks
+void benchmarkTagValueFieldWriting();
+void benchmarkBootstrapAndChangeStream();
+
+// message dispatch benchmarks
+void benchmarkMessageFieldDecoding();
+
+void setup() {
+    menuMgr.initWithoutInput(&noRenderer, &menuVolume);
+    Serial.begin(115200);
+
+    UNITY_BEGIN();
+
+    /* socket transport */
+    RUN_TEST(benchmarkSocketServerThroughputAndLatency);
+
+    /* tag value writer */
+    RUN_TEST(benchmarkTagValueFieldWriting);
+    RUN_TEST(benchmarkBootstrapAndChangeStream);
+
+    /* message dispatch */
+    RUN_TEST(benchmarkMessageFieldDecoding);
+
+    UNITY_END();
+}
+
+void loop() {
+}
+
+NoRenderer noRenderer;
@@ -288,3 +288,22 @@ void testFloatItemInMemory() {
     copyMenuItemNameAndValue(&fltItem, sz, sizeof sz);
     TEST_ASSERT_EQUAL_STRING("Floater: 223.234", sz);
 }
+
+void testChangeTimestampRecorded() {
+#if TC_MENU_CHANGE_TIMESTAMPS != 0
+    boolItem1.setBoolean(false);
+    delay(5);
+    unsigned long before = millis();
+    boolItem1.setBoolean(true);
+    TEST_ASSERT_TRUE(boolItem1.getLastChangeMillis() >= before);
+    TEST_ASSERT_TRUE(boolItem1.getLastChangeMillis() <= millis());
+
+    // setting the same value again is not a change, so the time should not move
+    uint32_t lastChange = boolItem1.getLastChangeMillis();
+    delay(5);
+    boolItem1.setBoolean(true);
+    TEST_ASSERT_EQUAL((uint32_t)lastChange, boolItem1.getLastChangeMillis());
+#else
+    TEST_ASSERT_EQUAL((uint32_t)0, boolItem1.getLastChangeMillis());
+#endif
+}
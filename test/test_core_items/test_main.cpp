@@ -45,6 +45,7 @@ void testColor32Struct();
 
 // value item cases
 void testCoreAndBooleanMenuItem();
+void testChangeTimestampRecorded();
 void testEnumMenuItem();
 void testAnalogMenuItem();
 void testAnalogItemNegativeInteger();
@@ -81,6 +82,7 @@ void setup() {
 
     /* value item */
     RUN_TEST(testCoreAndBooleanMenuItem);
+    RUN_TEST(testChangeTimestampRecorded);
     RUN_TEST(testEnumMenuItem);
     RUN_TEST(testAnalogMenuItem);
     RUN_TEST(testAnalogItemNegativeInteger);
@@ -0,0 +1,93 @@
+#include <unity.h>
+#include <remote/CobsFramedTransport.h>
+
+using namespace tcremote;
+
+/**
+ * A framed transport that writes into a buffer and reads back from it, so we can check what is on the wire.
+ */
+class LoopbackCobsTransport : public CobsFramedTransport {
+public:
+    uint8_t wire[600];
+    int wireLen = 0;
+    int wireReadPos = 0;
+
+    LoopbackCobsTransport() : CobsFramedTransport(255) {}
+
+    int readRawBytes(uint8_t* data, int maxSize) override {
+        int amt = 0;
+        while(wireReadPos < wireLen && amt < maxSize) data[amt++] = wire[wireReadPos++];
+        return amt;
+    }
+
+    int writeRawBytes(const uint8_t* data, int len) override {
+        for(int i = 0; i < len && wireLen < (int)sizeof(wire); i++) wire[wireLen++] = data[i];
+        return len;
+    }
+
+    bool available() override { return true; }
+    bool connected() override { return true; }
+};
+
+void writeBytes(LoopbackCobsTransport& transport, const uint8_t* data, int len) {
+    for(int i = 0; i < len; i++) transport.writeChar((char)data[i]);
+    transport.endMsg();
+}
+
+int readBackBytes(LoopbackCobsTransport& transport, uint8_t* data, int maxLen) {
+    int len = 0;
+    while(len < maxLen && transport.readAvailable()) data[len++] = transport.readByte();
+    return len;
+}
+
+void testCobsFramingRoundTrip() {
+    LoopbackCobsTransport transport;
+    uint8_t msg[254];
+    for(int i = 0; i < (int)sizeof(msg); i++) msg[i] = (i % 250) + 1;
+
+    writeBytes(transport, msg, sizeof msg);
+
+    // only the final byte on the wire is the zero delimiter.
+    TEST_ASSERT_EQUAL(0, transport.wire[transport.wireLen - 1]);
+    for(int i = 0; i < transport.wireLen - 1; i++) TEST_ASSERT_NOT_EQUAL(0, transport.wire[i]);
+
+    uint8_t readBack[300];
+    int len = readBackBytes(transport, readBack, sizeof readBack);
+    TEST_ASSERT_EQUAL(sizeof(msg) + 1, len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, readBack, sizeof msg);
+    TEST_ASSERT_EQUAL(0x02, readBack[sizeof msg]);
+    TEST_ASSERT_EQUAL(1, transport.getFramesReceived());
+    TEST_ASSERT_EQUAL(0, transport.getFramesRejected());
+}
+
+void testCobsFramingWithZeroBytes() {
+    LoopbackCobsTransport transport;
+    uint8_t msg[] = { 0, 1, 0, 0, 2, 3, 0 };
+
+    writeBytes(transport, msg, sizeof msg);
+    for(int i = 0; i < transport.wireLen - 1; i++) TEST_ASSERT_NOT_EQUAL(0, transport.wire[i]);
+
+    uint8_t readBack[20];
+    int len = readBackBytes(transport, readBack, sizeof readBack);
+    TEST_ASSERT_EQUAL(sizeof(msg) + 1, len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(msg, readBack, sizeof msg);
+}
+
+void testCobsFramingRejectsCorruptFrame() {
+    LoopbackCobsTransport transport;
+    const uint8_t hello[] = { 'h', 'e', 'l', 'l', 'o' };
+    const uint8_t world[] = { 'w', 'o', 'r', 'l', 'd' };
+    writeBytes(transport, hello, sizeof hello);
+    writeBytes(transport, world, sizeof world);
+
+    // corrupt a byte in the first frame, it should be dropped and the second frame read without loss.
+    transport.wire[2] ^= 0x10;
+
+    uint8_t readBack[20];
+    int len = readBackBytes(transport, readBack, sizeof readBack);
+    if(len == 0) len = readBackBytes(transport, readBack, sizeof readBack);
+    TEST_ASSERT_EQUAL(sizeof(world) + 1, len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(world, readBack, sizeof world);
+    TEST_ASSERT_EQUAL(1, transport.getFramesReceived());
+    TEST_ASSERT_EQUAL(1, transport.getFramesRejected());
+}
@@ -0,0 +1,63 @@
+#include <unity.h>
+#include <remote/PosixSocketTransport.h>
+#include "../tutils/TestRemoteTransport.h"
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
+
+using namespace tcremote;
+
+void testBroadcastConnectionPublishesOverUdp() {
+#ifdef TC_POSIX_REMOTE_SUPPORT
+    // a listener that joins a multicast group on the loopback interface, the port is allocated by the system
+    int listener = socket(AF_INET, SOCK_DGRAM, 0);
+    TEST_ASSERT_TRUE(listener >= 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    inet_pton(AF_INET, "239.255.77.1", &addr.sin_addr);
+    TEST_ASSERT_EQUAL(0, bind(listener, (sockaddr*)&addr, sizeof addr));
+    socklen_t addrLen = sizeof addr;
+    TEST_ASSERT_EQUAL(0, getsockname(listener, (sockaddr*)&addr, &addrLen));
+    ip_mreq membership = {};
+    inet_pton(AF_INET, "239.255.77.1", &membership.imr_multiaddr);
+    inet_pton(AF_INET, "127.0.0.1", &membership.imr_interface);
+    TEST_ASSERT_EQUAL(0, setsockopt(listener, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof membership));
+
+    // published to the group from the loopback interface, with a TTL of 0 so that nothing leaves this host
+    PosixDatagramTransport transport;
+    PosixDatagramInitialisation initialisation("239.255.77.1", ntohs(addr.sin_port), 0, "127.0.0.1");
+    TagValueBroadcastConnection connection(transport, initialisation, 1000);
+    connection.init(0, testRemoteLocalInfo);
+    for(int i = 0; i < 100; i++) connection.runLoop();
+    TEST_ASSERT_TRUE(connection.connected());
+
+    // each message is a datagram of its own, the first is the join, followed by the bootstrap of the whole menu.
+    uint8_t datagram[TC_POSIX_DATAGRAM_SIZE + 1];
+    uint32_t received = 0;
+    int bootstraps = 0;
+    bool volumeSent = false;
+    ssize_t len;
+    while((len = recv(listener, datagram, TC_POSIX_DATAGRAM_SIZE, MSG_DONTWAIT)) > 0) {
+        datagram[len] = 0;
+        TEST_ASSERT_EQUAL(START_OF_MESSAGE, datagram[0]);
+        TEST_ASSERT_EQUAL(0x02, datagram[len - 1]);
+        uint16_t msgType = msgFieldToWord(datagram[2], datagram[3]);
+        if(received == 0) TEST_ASSERT_EQUAL(MSG_JOIN, msgType);
+        if(msgType == MSG_BOOTSTRAP) bootstraps++;
+        if(msgType == MSG_BOOT_ANALOG && strstr((char*)&datagram[4], "ID=1|") != nullptr) volumeSent = true;
+        received++;
+    }
+    ::close(listener);
+
+    TEST_ASSERT_EQUAL(2, bootstraps);
+    TEST_ASSERT_TRUE(volumeSent);
+    TEST_ASSERT_EQUAL(transport.getDatagramsSent(), received);
+    TEST_ASSERT_EQUAL((uint32_t)0, transport.getSendFailures());
+#else
+    TEST_IGNORE_MESSAGE("needs POSIX sockets");
+#endif
+}
@@ -0,0 +1,68 @@
+#include <unity.h>
+#include <RemoteConnector.h>
+#include <MessageProcessors.h>
+#include "../tutils/fixtures_extern.h"
+#include "../tutils/TestRemoteTransport.h"
+
+static bool decodeOne(uint16_t msgType, uint16_t fieldId, const char* value, MessageProcessorInfo* info) {
+    FieldAndValue field = {};
+    field.fieldType = FVAL_FIELD;
+    field.msgType = msgType;
+    field.field = fieldId;
+    strcpy(field.value, value);
+    return decodeMessageField(&field, info);
+}
+
+void testMessageDecodeTableStoresFields() {
+    MessageProcessorInfo info = {};
+    char sz[10];
+    itoa(menuVolume.getId(), sz, 10);
+    TEST_ASSERT_TRUE(decodeOne(MSG_LIST_PAGE, FIELD_ID, sz, &info));
+    TEST_ASSERT_TRUE(decodeOne(MSG_LIST_PAGE, FIELD_LIST_START, "12", &info));
+    TEST_ASSERT_TRUE(decodeOne(MSG_LIST_PAGE, FIELD_LIST_COUNT, "7", &info));
+    TEST_ASSERT_TRUE(decodeOne(MSG_LIST_PAGE, FIELD_CORRELATION, "0000abcd", &info));
+    TEST_ASSERT_EQUAL_PTR(&menuVolume, info.listPage.item);
+    TEST_ASSERT_EQUAL(12, info.listPage.start);
+    TEST_ASSERT_EQUAL(7, info.listPage.count);
+    TEST_ASSERT_EQUAL_UINT32(0xabcd, info.listPage.correlation);
+
+    memset(&info, 0, sizeof info);
+    TEST_ASSERT_TRUE(decodeOne(MSG_DIALOG, FIELD_MODE, "A", &info));
+    TEST_ASSERT_TRUE(decodeOne(MSG_DIALOG, FIELD_BUTTON1, "3", &info));
+    TEST_ASSERT_EQUAL('A', info.dialog.mode);
+    TEST_ASSERT_EQUAL(3, info.dialog.button);
+
+    memset(&info, 0, sizeof info);
+    TEST_ASSERT_TRUE(decodeOne(MSG_FORM_REQUEST, FIELD_FORM_OFFSET, "70000", &info));
+    TEST_ASSERT_EQUAL_UINT32(70000, info.formLoad.offset);
+}
+
+void testMessageDecodeTableLeavesOtherFieldsToHandler() {
+    MessageProcessorInfo info = {};
+    // fields that need more than storing go to the handler, as do all fields of unknown messages
+    TEST_ASSERT_FALSE(decodeOne(MSG_CHANGE_INT, FIELD_ID, "1", &info));
+    TEST_ASSERT_FALSE(decodeOne(MSG_JOIN, FIELD_UUID, "1234", &info));
+    TEST_ASSERT_FALSE(decodeOne(msgFieldToWord('Z', 'Z'), FIELD_CORRELATION, "1", &info));
+    TEST_ASSERT_TRUE(decodeOne(MSG_CHANGE_INT, FIELD_CHANGE_TYPE, "1", &info));
+    TEST_ASSERT_EQUAL(CHANGE_ABSOLUTE, info.value.changeType);
+}
+
+void testExportedHandlersDecodeTheirOwnFields() {
+    // processors written before the decoding table pass every field straight to the exported handlers.
+    TestRemoteConnection remote;
+    remote.tickFor(2);
+    remote.transport.clearWritten();
+    MessageProcessorInfo info = {};
+    FieldAndValue field = {};
+    field.fieldType = FVAL_FIELD;
+    field.msgType = MSG_HEARTBEAT;
+    field.field = FIELD_HB_MODE;
+    itoa(HBMODE_STARTCONNECT, field.value, 10);
+    fieldUpdateHeartbeatMsg(&remote.connector, &field, &info);
+    TEST_ASSERT_EQUAL(HBMODE_STARTCONNECT, info.hb.hbMode);
+
+    field.fieldType = FVAL_END_MSG;
+    fieldUpdateHeartbeatMsg(&remote.connector, &field, &info);
+    TEST_ASSERT_EQUAL(1, remote.transport.countMessages(MSG_JOIN));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("NM=unit test|"));
+}
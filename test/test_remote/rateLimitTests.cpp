@@ -0,0 +1,87 @@
+#include <unity.h>
+#include <MessageProcessors.h>
+#include "../tutils/fixtures_extern.h"
+#include "../tutils/TestRemoteTransport.h"
+
+void testTokenBucketAllowsBurstThenLimits() {
+    TokenBucket bucket(10, 5);
+
+    for(int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(bucket.take(1000));
+    }
+    TEST_ASSERT_FALSE(bucket.take(1000));
+
+    // at 10 per second, a token is added every 100 millis.
+    TEST_ASSERT_FALSE(bucket.take(1050));
+    TEST_ASSERT_TRUE(bucket.take(1100));
+    TEST_ASSERT_FALSE(bucket.take(1100));
+
+    // after a long wait the bucket never holds more than the burst
+    for(int i = 0; i < 5; i++) {
+        TEST_ASSERT_TRUE(bucket.take(20000));
+    }
+    TEST_ASSERT_FALSE(bucket.take(20000));
+}
+
+void testTokenBucketDisabledWhenRateZero() {
+    TokenBucket bucket(10, 1);
+    TEST_ASSERT_TRUE(bucket.take(500));
+    TEST_ASSERT_FALSE(bucket.take(500));
+
+    bucket.setLimit(0, 0);
+    for(int i = 0; i < 100; i++) {
+        TEST_ASSERT_TRUE(bucket.take(500));
+    }
+}
+
+void testRateLimitOffByDefault() {
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_FULL);
+    TEST_ASSERT_TRUE(remote.connector.isAuthenticated());
+
+    for(int i = 0; i < 10; i++) {
+        remote.transport.queueMessage(MSG_CHANGE_INT, "ID=1|VC=5|");
+    }
+    remote.tickFor(100);
+    TEST_ASSERT_EQUAL(0, remote.processor.getMessagesRejected());
+    TEST_ASSERT_FALSE(remote.transport.hasWritten("ST=3|"));
+}
+
+void testRateLimitAcknowledgesEachCorrelatedRejection() {
+    TestRemoteConnection remote;
+    remote.processor.setInboundRateLimit(1, 1);
+
+    // joining is never limited, so the connection is still made with a burst of one.
+    remote.join(JOINMODE_FULL);
+    TEST_ASSERT_TRUE(remote.connector.isAuthenticated());
+    remote.transport.clearWritten();
+
+    remote.transport.queueMessage(MSG_CHANGE_INT, "ID=1|IC=00000011|TC=1|VC=5|");
+    remote.transport.queueMessage(MSG_CHANGE_INT, "ID=1|IC=00000012|TC=1|VC=6|");
+    remote.transport.queueMessage(MSG_CHANGE_INT, "ID=1|IC=00000013|TC=1|VC=7|");
+    remote.tickFor(60);
+
+    TEST_ASSERT_EQUAL(2, remote.processor.getMessagesRejected());
+    TEST_ASSERT_EQUAL(5, menuVolume.getCurrentValue());
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("ST=0|IC=00000011|"));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("ST=3|IC=00000012|"));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("ST=3|IC=00000013|"));
+}
+
+void testRateLimitAcknowledgesUncorrelatedRunOnce() {
+    TestRemoteConnection remote;
+    remote.processor.setInboundRateLimit(1, 1);
+    remote.join(JOINMODE_FULL);
+    remote.transport.clearWritten();
+
+    for(int i = 0; i < 4; i++) {
+        remote.transport.queueMessage(MSG_CHANGE_INT, "ID=1|VC=8|");
+    }
+    remote.tickFor(60);
+
+    TEST_ASSERT_EQUAL(3, remote.processor.getMessagesRejected());
+    // one acknowledgement for the accepted change, and only one for the three that were rejected.
+    TEST_ASSERT_EQUAL(2, remote.transport.countMessages(MSG_ACKNOWLEDGEMENT));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("ST=0|IC=00000000|"));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("ST=3|IC=00000000|"));
+}
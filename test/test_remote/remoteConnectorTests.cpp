@@ -0,0 +1,347 @@
+#include <unity.h>
+#include <RemoteConnector.h>
+#include "../tutils/fixtures_extern.h"
+#include <remote/BaseRemoteComponents.h>
+#include <remote/BaseBufferedRemoteTransport.h>
+#include "../tutils/TestRemoteTransport.h"
+
+using namespace tcremote;
+
+#define TEST_MSG_BIN_STREAM msgFieldToWord('Z','Z')
+
+int testLargeListRenderFn(RuntimeMenuItem* item, uint8_t row, RenderFnMode mode, char* buffer, int bufferSize) {
+    switch(mode) {
+    case RENDERFN_NAME:
+        if(row == LIST_PARENT_ITEM_POS) {
+            strncpy(buffer, "Large list", bufferSize);
+        } else {
+            ltoaClrBuff(buffer, row, 3, NOT_PADDED, bufferSize);
+        }
+        return true;
+    case RENDERFN_VALUE:
+        buffer[0] = 'V';
+        buffer[1] = 0;
+        fastltoa(buffer, row, 3, NOT_PADDED, bufferSize);
+        return true;
+    case RENDERFN_EEPROM_POS:
+        return -1;
+    default:
+        return false;
+    }
+}
+
+void testListPageRequestOutOfRange() {
+    ListRuntimeMenuItem largeList(2000, 250, testLargeListRenderFn, nullptr);
+    menuMgr.initWithoutInput(&noRenderer, &largeList);
+
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_FULL, JOINCAP_LIST_PAGING);
+    remote.transport.clearWritten();
+
+    // a start of 300 from the remote must not wrap around onto row 44, it is past the end of the list, so no rows are sent.
+    remote.transport.queueMessage(MSG_LIST_PAGE, "ID=2000|LS=300|LC=5|IC=0000001f|");
+    remote.tickFor(10);
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("LS=250|"));
+    TEST_ASSERT_FALSE(remote.transport.hasWritten("CA="));
+
+    remote.transport.clearWritten();
+    remote.transport.queueMessage(MSG_LIST_PAGE, "ID=2000|LS=245|LC=20|");
+    remote.tickFor(10);
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("LS=245|CA=V245|"));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("CE=V249|"));
+    TEST_ASSERT_FALSE(remote.transport.hasWritten("CF="));
+
+    menuMgr.initWithoutInput(&noRenderer, &menuVolume);
+}
+
+void testListPagedOnlyWhenRemoteSupportsIt() {
+    ListRuntimeMenuItem largeList(2000, 25, testLargeListRenderFn, nullptr);
+    menuMgr.initWithoutInput(&noRenderer, &largeList);
+
+    // a remote that supports paging gets the first page in bootstrap and changes, with the start row
+    TestRemoteConnection paged;
+    paged.join(JOINMODE_FULL, JOINCAP_LIST_PAGING);
+    TEST_ASSERT_TRUE(paged.connector.isListPaging());
+    TEST_ASSERT_TRUE(paged.transport.hasWritten("NC=25|LS=0|CA=V0|"));
+    TEST_ASSERT_FALSE(paged.transport.hasWritten("CU="));
+    paged.transport.clearWritten();
+    largeList.setChanged(true);
+    paged.tickFor(5);
+    TEST_ASSERT_TRUE(paged.transport.hasWritten("LS=0|CA=V0|"));
+    TEST_ASSERT_FALSE(paged.transport.hasWritten("CU="));
+
+    // an older remote that does not indicate paging gets every row and no start field
+    TestRemoteConnection older;
+    older.join(JOINMODE_FULL);
+    TEST_ASSERT_FALSE(older.connector.isListPaging());
+    TEST_ASSERT_TRUE(older.transport.hasWritten("NC=25|CA=V0|"));
+    TEST_ASSERT_TRUE(older.transport.hasWritten("CY=V24|"));
+    TEST_ASSERT_FALSE(older.transport.hasWritten("LS="));
+    older.transport.clearWritten();
+    largeList.setChanged(true);
+    older.tickFor(5);
+    TEST_ASSERT_TRUE(older.transport.hasWritten("CY=V24|"));
+    TEST_ASSERT_FALSE(older.transport.hasWritten("LS="));
+
+    menuMgr.initWithoutInput(&noRenderer, &menuVolume);
+}
+
+void testBinaryStreamFinishReportsStatus() {
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_FULL);
+    remote.transport.clearWritten();
+
+    ChunkedBinaryWriter writer;
+    TEST_ASSERT_EQUAL(BINSTREAM_NOT_STARTED, writer.finish());
+    TEST_ASSERT_TRUE(remote.connector.beginCustomBinaryStream(TEST_MSG_BIN_STREAM, writer));
+    TEST_ASSERT_EQUAL(3, writer.write((const uint8_t*)"abc", 3));
+    TEST_ASSERT_TRUE(remote.connector.hasPendingWrites());
+
+    // the partial chunk and the terminating zero length chunk are written by finish
+    TEST_ASSERT_EQUAL(BINSTREAM_COMPLETE, writer.finish());
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("abc"));
+    TEST_ASSERT_EQUAL(0x02, remote.transport.written[remote.transport.writtenLen - 1]);
+    TEST_ASSERT_FALSE(remote.connector.hasPendingWrites());
+    TEST_ASSERT_EQUAL(BINSTREAM_NOT_STARTED, writer.finish());
+
+    // a writer destroyed without finish does not end the stream, the connector ends it once it times out.
+    remote.transport.clearWritten();
+    {
+        ChunkedBinaryWriter abandoned;
+        TEST_ASSERT_TRUE(remote.connector.beginCustomBinaryStream(TEST_MSG_BIN_STREAM, abandoned));
+        abandoned.write((const uint8_t*)"xyz", 3);
+    }
+    TEST_ASSERT_FALSE(remote.transport.hasWritten("xyz"));
+    TEST_ASSERT_TRUE(remote.connector.hasPendingWrites());
+    remote.connector.tick(HEARTBEAT_INTERVAL + 1);
+    TEST_ASSERT_FALSE(remote.connector.hasPendingWrites());
+    TEST_ASSERT_EQUAL(0x02, remote.transport.written[remote.transport.writtenLen - 1]);
+    TEST_ASSERT_TRUE(remote.connector.isConnected());
+}
+
+void testBinaryStreamDisconnectAndStall() {
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_FULL);
+    TEST_ASSERT_TRUE(remote.connector.isConnected());
+
+    // the transport going away during a stream must disconnect the connector and detach the writer
+    ChunkedBinaryWriter writer;
+    TEST_ASSERT_TRUE(remote.connector.beginCustomBinaryStream(TEST_MSG_BIN_STREAM, writer));
+    remote.transport.isConnected = false;
+    remote.tickFor(1);
+    TEST_ASSERT_FALSE(remote.connector.isConnected());
+    TEST_ASSERT_FALSE(remote.connector.hasPendingWrites());
+    TEST_ASSERT_FALSE(writer.isStarted());
+    TEST_ASSERT_EQUAL(0, writer.write((const uint8_t*)"abc", 3));
+    TEST_ASSERT_EQUAL(BINSTREAM_DISCONNECTED, writer.finish());
+
+    // a stream that is never finished is ended by the connector after the heartbeat timeout
+    remote.transport.isConnected = true;
+    remote.join(JOINMODE_FULL);
+    TEST_ASSERT_TRUE(remote.connector.isConnected());
+    TEST_ASSERT_TRUE(remote.connector.beginCustomBinaryStream(TEST_MSG_BIN_STREAM, writer));
+    remote.transport.clearWritten();
+    remote.connector.tick(HEARTBEAT_INTERVAL / 2);
+    writer.write((const uint8_t*)"ab", 2);
+    remote.connector.tick(HEARTBEAT_INTERVAL / 2);
+    TEST_ASSERT_TRUE(writer.isStarted());
+    remote.connector.tick(HEARTBEAT_INTERVAL);
+    TEST_ASSERT_FALSE(writer.isStarted());
+    TEST_ASSERT_TRUE(remote.connector.isConnected());
+    TEST_ASSERT_EQUAL(0x02, remote.transport.written[remote.transport.writtenLen - 1]);
+
+    // the data was cut short, which the writer reports instead of ending the message a second time
+    size_t writtenBefore = remote.transport.writtenLen;
+    TEST_ASSERT_EQUAL(BINSTREAM_TIMED_OUT, writer.finish());
+    TEST_ASSERT_EQUAL(writtenBefore, remote.transport.writtenLen);
+
+    // now the stream has ended, changes are sent again
+    remote.transport.clearWritten();
+    menuVolume.setCurrentValue(menuVolume.getCurrentValue() + 1);
+    remote.tickFor(5);
+    TEST_ASSERT_EQUAL(1, remote.transport.countMessages(MSG_CHANGE_INT));
+}
+
+/**
+ * A buffered transport that gives out a single block of data the first time its read buffer is filled.
+ */
+class OneShotBufferedTransport : public BaseBufferedRemoteTransport {
+private:
+    const char* data;
+public:
+    explicit OneShotBufferedTransport(const char* data) : BaseBufferedRemoteTransport(BUFFER_ONE_MESSAGE, 64, 64), data(data) {}
+    void flush() override { writeBufferPos = 0; }
+    bool available() override { return true; }
+    bool connected() override { return true; }
+    int fillReadBuffer(uint8_t* buffer, int maxSize) override {
+        if(data == nullptr) return 0;
+        int len = internal_min(int(strlen(data)), maxSize);
+        memcpy(buffer, data, len);
+        data = nullptr;
+        return len;
+    }
+};
+
+void testBufferedReadDataIsPendingWork() {
+    // a heartbeat with several fields arrives in one read, the device will not signal readiness again for it.
+    OneShotBufferedTransport transport("\x01\x01HBHI=1500|HR=0|HT=5|\x02");
+    NoInitialisationNeeded initialisation;
+    TagValueRemoteServerConnection connection(transport, initialisation);
+    connection.enableReadinessSignalling();
+    connection.init(0, testRemoteLocalInfo);
+    TEST_ASSERT_FALSE(connection.hasPendingWork());
+
+    connection.tick();
+    TEST_ASSERT_TRUE(transport.hasUnreadData());
+    TEST_ASSERT_TRUE(connection.hasPendingWork());
+
+    int ticks = 0;
+    while(connection.hasPendingWork() && ticks++ < 100) connection.tick();
+    TEST_ASSERT_FALSE(transport.hasUnreadData());
+    TEST_ASSERT_TRUE(ticks > 2);
+}
+
+void testLongServiceGapTimesOutConnection() {
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_FULL);
+    TEST_ASSERT_TRUE(remote.connector.isConnected());
+
+    // a server connection reports at most 0xffff ticks when it has not been serviced for a long time, adding that
+    // to the ticks already counted must not wrap around to a small value that stops the timeout.
+    remote.connector.tick(0xffff);
+    TEST_ASSERT_FALSE(remote.connector.isConnected());
+    TEST_ASSERT_FALSE(remote.transport.connected());
+}
+
+void testReadinessTakenOnce() {
+    OneShotBufferedTransport transport(nullptr);
+    NoInitialisationNeeded initialisation;
+    TagValueRemoteServerConnection connection(transport, initialisation);
+    connection.markReady(READY_TO_READ);
+    connection.markReady(READY_STATE_CHANGED);
+    TEST_ASSERT_EQUAL(READY_TO_READ | READY_STATE_CHANGED, connection.takeReadiness());
+    TEST_ASSERT_EQUAL(READY_NONE, connection.takeReadiness());
+}
+
+void testQueryOnlyJoinSendsNoBootstrapOrChanges() {
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_QUERY_ONLY);
+    TEST_ASSERT_TRUE(remote.connector.isQueryOnly());
+    TEST_ASSERT_EQUAL(0, remote.transport.countMessages(MSG_BOOTSTRAP));
+
+    remote.transport.clearWritten();
+    menuVolume.setCurrentValue(42);
+    remote.tickFor(20);
+    TEST_ASSERT_EQUAL(0, remote.transport.countMessages(MSG_CHANGE_INT));
+
+    // values are only sent when the remote asks for them, an unknown ID is returned without a value.
+    remote.transport.queueMessage(MSG_VALUE_QUERY, "IC=00000021|ID=1|ID=9999|");
+    remote.tickFor(20);
+    TEST_ASSERT_EQUAL(1, remote.transport.countMessages(MSG_VALUE_RESPONSE));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("IC=00000021|NC=2|qA=1|QA=42|qB=9999|"));
+    TEST_ASSERT_FALSE(remote.transport.hasWritten("QB="));
+    TEST_ASSERT_EQUAL(0, remote.transport.countMessages(MSG_CHANGE_INT));
+}
+
+void testValueQueryWhenFullyJoined() {
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_FULL);
+    TEST_ASSERT_FALSE(remote.connector.isQueryOnly());
+    TEST_ASSERT_TRUE(remote.transport.countMessages(MSG_BOOTSTRAP) > 0);
+
+    remote.transport.clearWritten();
+    menuVolume.setCurrentValue(12);
+    remote.transport.queueMessage(MSG_VALUE_QUERY, "ID=1|IC=00000022|");
+    remote.tickFor(20);
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("IC=00000022|NC=1|qA=1|QA=12|"));
+    TEST_ASSERT_EQUAL(1, remote.transport.countMessages(MSG_CHANGE_INT));
+}
+
+void testLazyJoinOnlyStreamsExpandedSubMenus() {
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_LAZY_BOOT);
+    TEST_ASSERT_FALSE(remote.transport.hasWritten("ID=4|"));
+
+    // the settings submenu has not been expanded, so only the change at the root is sent.
+    remote.transport.clearWritten();
+    menuVolume.setCurrentValue(20);
+    menu12VStandby.setBoolean(!menu12VStandby.getBoolean());
+    remote.tickFor(30);
+    TEST_ASSERT_EQUAL(1, remote.transport.countMessages(MSG_CHANGE_INT));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("ID=1|"));
+    TEST_ASSERT_FALSE(remote.transport.hasWritten("ID=4|"));
+
+    remote.transport.queueMessage(MSG_SUBMENU_EXPAND, "ID=3|IC=00000031|");
+    remote.tickFor(30);
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("ID=4|"));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("IC=00000031|"));
+
+    // now it is expanded, changes within settings are sent, but not those in the status submenu.
+    remote.transport.clearWritten();
+    menu12VStandby.setBoolean(!menu12VStandby.getBoolean());
+    menuLHSTemp.setCurrentValue(menuLHSTemp.getCurrentValue() + 1);
+    remote.tickFor(30);
+    TEST_ASSERT_EQUAL(1, remote.transport.countMessages(MSG_CHANGE_INT));
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("ID=4|"));
+    TEST_ASSERT_FALSE(remote.transport.hasWritten("ID=7|"));
+}
+
+uint8_t testFormData[150];
+const EmbedControlFlashedForm testForm = { "Settings", testFormData, sizeof testFormData };
+const EmbedControlFlashedForm* testFormTemplates[] = { &testForm, nullptr };
+
+/**
+ * Finds the form chunks that have been written, each is a binary message holding the offset and total length of the
+ * form followed by the data. Checks that the total and the data are correct, and records the offset of each chunk.
+ * @return the number of chunks found
+ */
+int checkFormChunksWritten(const TestRemoteTransport& transport, uint32_t* offsets, int maxChunks) {
+    const auto* wr = reinterpret_cast<const uint8_t*>(transport.written);
+    int found = 0;
+    for(size_t i = 0; i + 14 <= transport.writtenLen && found < maxChunks; i++) {
+        if(wr[i] != START_OF_MESSAGE || wr[i + 1] != BINARY_GZ_PROTOCOL || wr[i + 2] != 'F' || wr[i + 3] != 'C') continue;
+        uint16_t len = (wr[i + 4] << 8) | wr[i + 5];
+        uint32_t offset = (uint32_t(wr[i + 6]) << 24) | (uint32_t(wr[i + 7]) << 16) | (wr[i + 8] << 8) | wr[i + 9];
+        uint32_t total = (uint32_t(wr[i + 10]) << 24) | (uint32_t(wr[i + 11]) << 16) | (wr[i + 12] << 8) | wr[i + 13];
+        TEST_ASSERT_EQUAL(sizeof testFormData, total);
+        TEST_ASSERT_EQUAL(internal_min(uint32_t(TC_REMOTE_FORM_CHUNK_SIZE), total - offset) + 8, len);
+        TEST_ASSERT_TRUE(i + 6 + len <= transport.writtenLen);
+        TEST_ASSERT_TRUE(memcmp(&wr[i + 14], &testFormData[offset], len - 8) == 0);
+        offsets[found++] = offset;
+        i += 6 + len;
+    }
+    return found;
+}
+
+void testFormStreamedInChunksWithCredits() {
+    for(size_t i = 0; i < sizeof testFormData; i++) testFormData[i] = 'a' + (i % 26);
+    CombinedMessageProcessor::setFormTemplatesInFlash(testFormTemplates);
+
+    TestRemoteConnection remote;
+    remote.join(JOINMODE_FULL);
+    remote.transport.clearWritten();
+
+    remote.transport.queueMessage(MSG_FORM_NAMES, "");
+    remote.tickFor(10);
+    TEST_ASSERT_TRUE(remote.transport.hasWritten("CA=Settings|NC=1|"));
+
+    // the form needs three chunks, but only two credits are given, so only two are sent however long we wait.
+    remote.transport.clearWritten();
+    remote.transport.queueMessage(MSG_FORM_REQUEST, "NM=Settings|FO=0|FC=2|IC=00000041|");
+    remote.tickFor(40);
+    uint32_t offsets[4];
+    TEST_ASSERT_EQUAL(2, checkFormChunksWritten(remote.transport, offsets, 4));
+    TEST_ASSERT_EQUAL(0, offsets[0]);
+    TEST_ASSERT_EQUAL(TC_REMOTE_FORM_CHUNK_SIZE, offsets[1]);
+    TEST_ASSERT_FALSE(remote.connector.hasPendingWrites());
+
+    // the remote resumes from where it got to, the last chunk is short and ends the transfer with credits left.
+    remote.transport.clearWritten();
+    remote.transport.queueMessage(MSG_FORM_REQUEST, "NM=Settings|FO=128|FC=5|IC=00000042|");
+    remote.tickFor(40);
+    TEST_ASSERT_EQUAL(1, checkFormChunksWritten(remote.transport, offsets, 4));
+    TEST_ASSERT_EQUAL(128, offsets[0]);
+    TEST_ASSERT_FALSE(remote.connector.hasPendingWrites());
+
+    CombinedMessageProcessor::setFormTemplatesInFlash(nullptr);
+}
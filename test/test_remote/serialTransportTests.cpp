@@ -0,0 +1,64 @@
+#include <unity.h>
+#include <remote/PosixSerialTransport.h>
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#endif
+
+using namespace tcremote;
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+int readFrameFromPty(PosixSerialCobsTransport& transport, uint8_t* data, int maxLen) {
+    // the pty may not have passed all the bytes over yet, so wait a little for the frame to arrive.
+    int len = 0;
+    for(int attempt = 0; attempt < 100 && len == 0; attempt++) {
+        while(len < maxLen && transport.readAvailable()) data[len++] = transport.readByte();
+        if(len == 0) usleep(1000);
+    }
+    return len;
+}
+#endif
+
+void testSerialTransportOverPseudoTerminal() {
+#ifdef TC_POSIX_REMOTE_SUPPORT
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    TEST_ASSERT_TRUE(master >= 0);
+    TEST_ASSERT_EQUAL(0, grantpt(master));
+    TEST_ASSERT_EQUAL(0, unlockpt(master));
+    const char* deviceName = ptsname(master);
+    TEST_ASSERT_NOT_NULL(deviceName);
+
+    // the device end is opened as a serial device would be, and the test drives the other end of the pair.
+    PosixSerialCobsTransport device;
+    TEST_ASSERT_FALSE(device.openDevice(deviceName, 12345));
+    TEST_ASSERT_FALSE(device.connected());
+    TEST_ASSERT_FALSE(device.openDevice("/dev/tcmenu-does-not-exist", 115200));
+    TEST_ASSERT_TRUE(device.openDevice(deviceName, 115200));
+    TEST_ASSERT_TRUE(device.connected());
+
+    PosixSerialCobsTransport remote;
+    remote.setFileDescriptor(master);
+
+    // a frame with zero bytes and bytes that a terminal would normally translate must pass through unchanged.
+    const uint8_t toDevice[] = { 'a', 0, '\r', '\n', 0x03, 0x7f, 'z' };
+    for(auto b : toDevice) remote.writeChar((char)b);
+    remote.endMsg();
+    uint8_t readBack[20];
+    int len = readFrameFromPty(device, readBack, sizeof readBack);
+    TEST_ASSERT_EQUAL(sizeof(toDevice) + 1, len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(toDevice, readBack, sizeof toDevice);
+    TEST_ASSERT_EQUAL(1, device.getFramesReceived());
+
+    const uint8_t toRemote[] = { 'o', 'k', 0, 0x11, 0x13 };
+    for(auto b : toRemote) device.writeChar((char)b);
+    device.endMsg();
+    len = readFrameFromPty(remote, readBack, sizeof readBack);
+    TEST_ASSERT_EQUAL(sizeof(toRemote) + 1, len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(toRemote, readBack, sizeof toRemote);
+    TEST_ASSERT_EQUAL(0, remote.getFramesRejected());
+#else
+    TEST_IGNORE_MESSAGE("needs POSIX serial devices");
+#endif
+}
@@ -0,0 +1,148 @@
+#include <unity.h>
+#include <remote/SessionRecording.h>
+#include "../tutils/TestRemoteTransport.h"
+
+using namespace tcremote;
+
+/**
+ * A sink that records into memory so that it can be replayed straight back.
+ */
+class MemorySessionSink : public SessionRecordSink {
+public:
+    uint8_t data[512];
+    size_t used = 0;
+
+    bool writeRecordData(const uint8_t* toWrite, size_t len) override {
+        if(used + len > sizeof data) return false;
+        memcpy(&data[used], toWrite, len);
+        used += len;
+        return true;
+    }
+};
+
+void testSessionRecordCoalescesRecords() {
+    MemorySessionSink sink;
+    SessionRecorder recorder(&sink);
+
+    recorder.record(SESSION_INBOUND, (const uint8_t*)"abc", 3, 100);
+    recorder.record(SESSION_INBOUND, (const uint8_t*)"de", 2, 100);
+    recorder.record(SESSION_OUTBOUND, (const uint8_t*)"xyz", 3, 100);
+    recorder.record(SESSION_OUTBOUND, (const uint8_t*)"!", 1, 400);
+    recorder.flush();
+
+    TEST_ASSERT_EQUAL((uint32_t)3, recorder.getRecordsWritten());
+
+    // header, then delta 0, len 5 inbound, data, then delta 0, len 3 outbound, then delta 300 as two bytes, len 1 out
+    const uint8_t expected[] = { 'T', 'C', 'S', 'R', TC_SESSION_FILE_VERSION,
+                                 0, 10, 'a', 'b', 'c', 'd', 'e',
+                                 0, 7, 'x', 'y', 'z',
+                                 0xac, 0x02, 3, '!' };
+    TEST_ASSERT_EQUAL(sizeof expected, sink.used);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, sink.data, sizeof expected);
+}
+
+void testSessionReplayFeedsInboundAndChecksOutbound() {
+    MemorySessionSink sink;
+    SessionRecorder recorder(&sink);
+    recorder.record(SESSION_INBOUND, (const uint8_t*)"hello", 5, 10);
+    recorder.record(SESSION_OUTBOUND, (const uint8_t*)"ok", 2, 12);
+    recorder.record(SESSION_INBOUND, (const uint8_t*)"bye", 3, 20);
+    recorder.flush();
+
+    SessionReplayTransport replay(sink.data, sink.used);
+    TEST_ASSERT_TRUE(replay.connected());
+
+    char sz[10];
+    int pos = 0;
+    while(replay.readAvailable() && pos < 9) sz[pos++] = (char)replay.readByte();
+    sz[pos] = 0;
+    TEST_ASSERT_EQUAL_STRING("hellobye", sz);
+    TEST_ASSERT_TRUE(replay.isFinished());
+    TEST_ASSERT_EQUAL((uint32_t)8, replay.getBytesReplayed());
+
+    replay.writeStr("ok");
+    TEST_ASSERT_EQUAL((uint32_t)0, replay.getOutboundMismatches());
+    replay.writeChar('?');
+    TEST_ASSERT_EQUAL((uint32_t)1, replay.getOutboundMismatches());
+    TEST_ASSERT_EQUAL((uint32_t)3, replay.getBytesWritten());
+
+    TEST_ASSERT_TRUE(replay.restart());
+    TEST_ASSERT_FALSE(replay.isFinished());
+    TEST_ASSERT_EQUAL('h', replay.readByte());
+}
+
+void testSessionReplayRejectsBadHeader() {
+    const uint8_t notASession[] = { 'N', 'O', 'P', 'E', 1, 0, 2, 'a' };
+    SessionReplayTransport replay(notASession, sizeof notASession);
+    TEST_ASSERT_FALSE(replay.connected());
+    TEST_ASSERT_FALSE(replay.readAvailable());
+}
+
+/**
+ * A test transport that counts the messages it is asked to start, as transports that frame messages rely on startMsg.
+ */
+class StartCountingTransport : public TestRemoteTransport {
+public:
+    int messagesStarted = 0;
+    int binaryMessagesStarted = 0;
+
+    void startMsg(uint16_t msgType) override {
+        messagesStarted++;
+        TestRemoteTransport::startMsg(msgType);
+    }
+
+    void startBinMsg(uint16_t msgType, uint16_t byteLen) override {
+        binaryMessagesStarted++;
+        TestRemoteTransport::startBinMsg(msgType, byteLen);
+    }
+};
+
+void testRecordingTransportWithConnector() {
+    MemorySessionSink sink;
+    SessionRecorder recorder(&sink);
+    StartCountingTransport underlying;
+    RecordingTransport recording(&underlying, &recorder);
+    TestRemoteConnection remote(&recording);
+
+    char sz[80];
+    snprintf(sz, sizeof sz, "NM=tester|UU=%s|VE=100|PF=0|JM=%d|", "2ba37227-a412-40b7-94e7-42caf9bb0ff4", int(JOINMODE_QUERY_ONLY));
+    underlying.queueMessage(MSG_JOIN, sz);
+    remote.tickFor(60);
+    recording.flush();
+
+    TEST_ASSERT_TRUE(remote.connector.isAuthenticated());
+    TEST_ASSERT_TRUE(underlying.messagesStarted > 0);
+    TEST_ASSERT_EQUAL(underlying.countMessages(MSG_JOIN) + underlying.countMessages(MSG_HEARTBEAT)
+                      + underlying.countMessages(MSG_ACKNOWLEDGEMENT), underlying.messagesStarted);
+
+    // what was recorded must be exactly what went over the real transport in each direction
+    SessionReplayTransport replay(sink.data, sink.used);
+    while(replay.readAvailable()) replay.readByte();
+    TEST_ASSERT_EQUAL((uint32_t)underlying.inboundLen, replay.getBytesReplayed());
+    for(size_t i = 0; i < underlying.writtenLen; i++) replay.writeChar(underlying.written[i]);
+    TEST_ASSERT_EQUAL((uint32_t)0, replay.getOutboundMismatches());
+    TEST_ASSERT_EQUAL((uint32_t)underlying.writtenLen, replay.getBytesWritten());
+}
+
+void testRecordingTransportForwardsBinaryMessages() {
+    MemorySessionSink sink;
+    SessionRecorder recorder(&sink);
+    StartCountingTransport underlying;
+    RecordingTransport recording(&underlying, &recorder);
+    TestRemoteConnection remote(&recording);
+
+    uint8_t payload[] = { 0xde, 0xad, 0xbe, 0xef };
+    remote.connector.encodeCustomBinaryMessage(MSG_FORM_CHUNK, sizeof payload, [](TagValueTransport* tx, void* data, size_t len) {
+        for(size_t i = 0; i < len; i++) tx->writeChar(((uint8_t*)data)[i]);
+    }, payload);
+    recording.flush();
+
+    // the binary start must reach the wrapped transport, so that any framing it does is applied
+    TEST_ASSERT_EQUAL(1, underlying.binaryMessagesStarted);
+    TEST_ASSERT_EQUAL(0, underlying.messagesStarted);
+
+    SessionReplayTransport replay(sink.data, sink.used);
+    for(size_t i = 0; i < underlying.writtenLen; i++) replay.writeChar(underlying.written[i]);
+    TEST_ASSERT_EQUAL((uint32_t)0, replay.getOutboundMismatches());
+    TEST_ASSERT_EQUAL((uint32_t)underlying.writtenLen, replay.getBytesWritten());
+}
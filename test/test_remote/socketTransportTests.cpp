@@ -0,0 +1,76 @@
+#include <unity.h>
+#include <remote/PosixSocketTransport.h>
+#include "../tutils/TestRemoteTransport.h"
+#include "../tutils/PosixLoopbackClient.h"
+
+using namespace tcremote;
+
+#define LOOPBACK_CLIENTS 3
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+void serviceLoopback(TagValueRemoteServerConnection* connections, PosixLoopbackClient* clients, int loops) {
+    for(int loop = 0; loop < loops; loop++) {
+        for(int i = 0; i < LOOPBACK_CLIENTS; i++) connections[i].runLoop();
+        for(int i = 0; i < LOOPBACK_CLIENTS; i++) clients[i].readAvailable();
+    }
+}
+#endif
+
+void testSocketServerRoundTripsOnEachConnection() {
+#ifdef TC_POSIX_REMOTE_SUPPORT
+    // several connections share one listening socket, the port is allocated by the system
+    PosixSocketInitialisation initialisation(0);
+    PosixSocketTransport transports[LOOPBACK_CLIENTS];
+    TagValueRemoteServerConnection connections[LOOPBACK_CLIENTS] = {
+        {transports[0], initialisation}, {transports[1], initialisation}, {transports[2], initialisation}
+    };
+    for(int i = 0; i < LOOPBACK_CLIENTS; i++) connections[i].init(i, testRemoteLocalInfo);
+    connections[0].runLoop();
+    TEST_ASSERT_TRUE(initialisation.isInitialised());
+    TEST_ASSERT_TRUE(initialisation.getBoundPort() != 0);
+
+    PosixLoopbackClient clients[LOOPBACK_CLIENTS];
+    for(auto& client : clients) TEST_ASSERT_TRUE(client.connectTo(initialisation.getBoundPort()));
+
+    // each connection accepts one of the clients and the device starts the connection with a heartbeat
+    serviceLoopback(connections, clients, 200);
+    for(int i = 0; i < LOOPBACK_CLIENTS; i++) {
+        TEST_ASSERT_TRUE(transports[i].connected());
+        TEST_ASSERT_TRUE(clients[i].hasReceived("HR=1|"));
+    }
+
+    // the device answers a start heartbeat from each client with its join
+    for(auto& client : clients) TEST_ASSERT_TRUE(client.sendMessage(MSG_HEARTBEAT, "HR=1|"));
+    serviceLoopback(connections, clients, 200);
+    for(auto& client : clients) TEST_ASSERT_TRUE(client.hasReceived("NM=unit test|"));
+
+    // each client joins with its own name, which must arrive on its own connection, then it is bootstrapped
+    for(int i = 0; i < LOOPBACK_CLIENTS; i++) {
+        char join[80];
+        snprintf(join, sizeof join, "NM=client%d|UU=2ba37227-a412-40b7-94e7-42caf9bb0ff4|VE=100|PF=0|", i);
+        TEST_ASSERT_TRUE(clients[i].sendMessage(MSG_JOIN, join));
+    }
+    serviceLoopback(connections, clients, 2000);
+    for(int i = 0; i < LOOPBACK_CLIENTS; i++) {
+        char name[16];
+        snprintf(name, sizeof name, "client%d", i);
+        TEST_ASSERT_EQUAL_STRING(name, connections[i].connector()->getRemoteName());
+        TEST_ASSERT_TRUE(connections[i].connector()->isConnected());
+        TEST_ASSERT_TRUE(clients[i].hasReceived("ID=1|"));
+        TEST_ASSERT_TRUE(transports[i].getBytesRead() > 0);
+        TEST_ASSERT_EQUAL(clients[i].totalReceived, transports[i].getBytesWritten());
+    }
+
+    // closing a client is noticed by its connection only
+    ::close(clients[1].fd);
+    clients[1].fd = -1;
+    for(int loop = 0; loop < 100; loop++) {
+        for(auto& connection : connections) connection.runLoop();
+    }
+    TEST_ASSERT_TRUE(transports[0].connected());
+    TEST_ASSERT_FALSE(transports[1].connected());
+    TEST_ASSERT_TRUE(transports[2].connected());
+#else
+    TEST_IGNORE_MESSAGE("needs POSIX sockets");
+#endif
+}
@@ -0,0 +1,60 @@
+#include <unity.h>
+#include <remote/BaseBufferedRemoteTransport.h>
+
+using namespace tcremote;
+
+/**
+ * A buffered transport with a small write buffer that captures everything flushed, so that both writing in place
+ * and falling back to character writes when the buffer is nearly full can be checked.
+ */
+class CapturingBufferedTransport : public BaseBufferedRemoteTransport {
+public:
+    char wire[128];
+    int wireLen = 0;
+    int flushes = 0;
+
+    CapturingBufferedTransport() : BaseBufferedRemoteTransport(BUFFER_MESSAGES_TILL_FULL, 16, 16) {}
+
+    int fillReadBuffer(uint8_t* data, int maxSize) override { return 0; }
+    void flush() override {
+        memcpy(&wire[wireLen], writeBuffer, writeBufferPos);
+        wireLen += writeBufferPos;
+        writeBufferPos = 0;
+        flushes++;
+    }
+    bool available() override { return true; }
+    bool connected() override { return true; }
+
+    void assertWire(const char* expected) {
+        flush();
+        wire[wireLen] = 0;
+        TEST_ASSERT_EQUAL_STRING(expected, wire);
+    }
+};
+
+void testTagValueWriterFormatsFieldsInPlace() {
+    CapturingBufferedTransport transport;
+    transport.writeFieldInt(FIELD_ID, -1234);
+    transport.writeFieldLong(FIELD_TIMESTAMP, 0);
+    TEST_ASSERT_EQUAL(0, transport.flushes);
+    transport.assertWire("ID=-1234|TS=0|");
+
+    // longer than nine digits are no longer truncated
+    transport.wireLen = 0;
+    transport.writeFieldLong(FIELD_CURRENT_VAL, 2147483647L);
+    transport.assertWire("VC=2147483647|");
+}
+
+void testTagValueWriterFallsBackWhenBufferFull() {
+    CapturingBufferedTransport transport;
+    transport.writeField(FIELD_MSG_NAME, "abcdefgh");
+    // the buffer now has 4 bytes free, so the next field is written in parts across a flush.
+    transport.writeField(FIELD_UUID, "xyz");
+    TEST_ASSERT_EQUAL(1, transport.flushes);
+    transport.assertWire("NM=abcdefgh|UU=xyz|");
+
+    // a string longer than the buffer is copied in several steps.
+    transport.wireLen = 0;
+    transport.writeStr("0123456789abcdefghijklmnopqrstuvwxyz");
+    transport.assertWire("0123456789abcdefghijklmnopqrstuvwxyz");
+}
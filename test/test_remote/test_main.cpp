@@ -0,0 +1,132 @@
+#include <unity.h>
+#include <tcMenu.h>
+#include "../tutils/fixtures_extern.h"
+#include <tcm_test/testFixtures.h>
+
+// framing tests
+void testCobsFramingRoundTrip();
+void testCobsFramingWithZeroBytes();
+void testCobsFramingRejectsCorruptFrame();
+
+// rate limiting tests
+void testTokenBucketAllowsBurstThenLimits();
+void testTokenBucketDisabledWhenRateZero();
+void testRateLimitOffByDefault();
+void testRateLimitAcknowledgesEachCorrelatedRejection();
+void testRateLimitAcknowledgesUncorrelatedRunOnce();
+
+// session recording tests
+void testSessionRecordCoalescesRecords();
+void testSessionReplayFeedsInboundAndChecksOutbound();
+void testSessionReplayRejectsBadHeader();
+void testRecordingTransportWithConnector();
+void testRecordingTransportForwardsBinaryMessages();
+
+// datagram transport tests
+void testBroadcastConnectionPublishesOverUdp();
+
+// socket transport tests
+void testSocketServerRoundTripsOnEachConnection();
+
+// serial transport tests
+void testSerialTransportOverPseudoTerminal();
+
+// websocket framing tests
+void testWebSocketWritesBinaryFrames();
+void testWebSocketUnmasksClientFrames();
+void testWebSocketAnswersPingAndClose();
+void testWebSocketCompletesPartialWrites();
+void testWebSocketRejectsUnmaskedFrames();
+
+// tag value writer tests
+void testTagValueWriterFormatsFieldsInPlace();
+void testTagValueWriterFallsBackWhenBufferFull();
+
+// message dispatch tests
+void testMessageDecodeTableStoresFields();
+void testMessageDecodeTableLeavesOtherFieldsToHandler();
+void testExportedHandlersDecodeTheirOwnFields();
+
+// remote connector tests
+void testListPageRequestOutOfRange();
+void testListPagedOnlyWhenRemoteSupportsIt();
+void testBinaryStreamFinishReportsStatus();
+void testBinaryStreamDisconnectAndStall();
+void testBufferedReadDataIsPendingWork();
+void testLongServiceGapTimesOutConnection();
+void testReadinessTakenOnce();
+void testQueryOnlyJoinSendsNoBootstrapOrChanges();
+void testValueQueryWhenFullyJoined();
+void testLazyJoinOnlyStreamsExpandedSubMenus();
+void testFormStreamedInChunksWithCredits();
+
+void setup() {
+    menuMgr.initWithoutInput(&noRenderer, &menuVolume);
+    Serial.begin(115200);
+
+    UNITY_BEGIN();
+
+    /* framing */
+    RUN_TEST(testCobsFramingRoundTrip);
+    RUN_TEST(testCobsFramingWithZeroBytes);
+    RUN_TEST(testCobsFramingRejectsCorruptFrame);
+
+    /* rate limiting */
+    RUN_TEST(testTokenBucketAllowsBurstThenLimits);
+    RUN_TEST(testTokenBucketDisabledWhenRateZero);
+    RUN_TEST(testRateLimitOffByDefault);
+    RUN_TEST(testRateLimitAcknowledgesEachCorrelatedRejection);
+    RUN_TEST(testRateLimitAcknowledgesUncorrelatedRunOnce);
+
+    /* session recording */
+    RUN_TEST(testSessionRecordCoalescesRecords);
+    RUN_TEST(testSessionReplayFeedsInboundAndChecksOutbound);
+    RUN_TEST(testSessionReplayRejectsBadHeader);
+    RUN_TEST(testRecordingTransportWithConnector);
+    RUN_TEST(testRecordingTransportForwardsBinaryMessages);
+
+    /* datagram transport */
+    RUN_TEST(testBroadcastConnectionPublishesOverUdp);
+
+    /* socket transport */
+    RUN_TEST(testSocketServerRoundTripsOnEachConnection);
+
+    /* serial transport */
+    RUN_TEST(testSerialTransportOverPseudoTerminal);
+
+    /* websocket framing */
+    RUN_TEST(testWebSocketWritesBinaryFrames);
+    RUN_TEST(testWebSocketUnmasksClientFrames);
+    RUN_TEST(testWebSocketAnswersPingAndClose);
+    RUN_TEST(testWebSocketCompletesPartialWrites);
+    RUN_TEST(testWebSocketRejectsUnmaskedFrames);
+
+    /* tag value writer */
+    RUN_TEST(testTagValueWriterFormatsFieldsInPlace);
+    RUN_TEST(testTagValueWriterFallsBackWhenBufferFull);
+
+    /* message dispatch */
+    RUN_TEST(testMessageDecodeTableStoresFields);
+    RUN_TEST(testMessageDecodeTableLeavesOtherFieldsToHandler);
+    RUN_TEST(testExportedHandlersDecodeTheirOwnFields);
+
+    /* remote connector */
+    RUN_TEST(testListPageRequestOutOfRange);
+    RUN_TEST(testListPagedOnlyWhenRemoteSupportsIt);
+    RUN_TEST(testBinaryStreamFinishReportsStatus);
+    RUN_TEST(testBinaryStreamDisconnectAndStall);
+    RUN_TEST(testBufferedReadDataIsPendingWork);
+    RUN_TEST(testLongServiceGapTimesOutConnection);
+    RUN_TEST(testReadinessTakenOnce);
+    RUN_TEST(testQueryOnlyJoinSendsNoBootstrapOrChanges);
+    RUN_TEST(testValueQueryWhenFullyJoined);
+    RUN_TEST(testLazyJoinOnlyStreamsExpandedSubMenus);
+    RUN_TEST(testFormStreamedInChunksWithCredits);
+
+    UNITY_END();
+}
+
+void loop() {
+}
+
+NoRenderer noRenderer;
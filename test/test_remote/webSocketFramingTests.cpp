@@ -0,0 +1,129 @@
+#include <unity.h>
+#include <remote/WebSocketFramedTransport.h>
+
+using namespace tcremote;
+
+/**
+ * A websocket transport that reads from a fixed array a few bytes at a time, and captures what is written, accepting
+ * at most maxWrite bytes on each write.
+ */
+class LoopbackWebSocketTransport : public WebSocketFramedTransport {
+public:
+    const uint8_t* incoming = nullptr;
+    int incomingLen = 0;
+    int incomingPos = 0;
+    uint8_t wire[300];
+    int wireLen = 0;
+    int maxWrite = 300;
+    bool isOpen = true;
+
+    LoopbackWebSocketTransport() : WebSocketFramedTransport(200) {}
+
+    int readRawBytes(uint8_t* data, int maxSize) override {
+        // deliver at most three bytes at once, so that headers are split over reads.
+        int amt = 0;
+        while(incomingPos < incomingLen && amt < maxSize && amt < 3) data[amt++] = incoming[incomingPos++];
+        return amt;
+    }
+
+    int writeRawBytes(const uint8_t* data, int len) override {
+        if(len > maxWrite) len = maxWrite;
+        memcpy(&wire[wireLen], data, len);
+        wireLen += len;
+        return len;
+    }
+
+    bool available() override { return isOpen; }
+    bool connected() override { return isOpen; }
+    void close() override {
+        WebSocketFramedTransport::close();
+        isOpen = false;
+    }
+};
+
+void testWebSocketWritesBinaryFrames() {
+    LoopbackWebSocketTransport transport;
+    transport.writeStr("hello");
+    transport.flush();
+
+    const uint8_t expected[] = { 0x82, 5, 'h', 'e', 'l', 'l', 'o' };
+    TEST_ASSERT_EQUAL(sizeof expected, transport.wireLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, transport.wire, sizeof expected);
+
+    // a larger frame needs the extended 16 bit length
+    transport.wireLen = 0;
+    for(int i = 0; i < 130; i++) transport.writeChar('A');
+    transport.flush();
+    TEST_ASSERT_EQUAL(134, transport.wireLen);
+    TEST_ASSERT_EQUAL(0x82, transport.wire[0]);
+    TEST_ASSERT_EQUAL(126, transport.wire[1]);
+    TEST_ASSERT_EQUAL(0, transport.wire[2]);
+    TEST_ASSERT_EQUAL(130, transport.wire[3]);
+    TEST_ASSERT_EQUAL('A', transport.wire[4]);
+}
+
+void testWebSocketUnmasksClientFrames() {
+    // two masked binary frames "Hi" and "!", the mask is 1,2,3,4
+    const uint8_t frames[] = { 0x82, 0x82, 1, 2, 3, 4, 'H' ^ 1, 'i' ^ 2,
+                               0x82, 0x81, 1, 2, 3, 4, '!' ^ 1 };
+    LoopbackWebSocketTransport transport;
+    transport.incoming = frames;
+    transport.incomingLen = sizeof frames;
+
+    char sz[10];
+    int pos = 0;
+    for(int i = 0; i < 20 && pos < 9; i++) {
+        if(transport.readAvailable()) sz[pos++] = (char)transport.readByte();
+    }
+    sz[pos] = 0;
+    TEST_ASSERT_EQUAL_STRING("Hi!", sz);
+}
+
+void testWebSocketAnswersPingAndClose() {
+    const uint8_t frames[] = { 0x89, 0x82, 9, 9, 9, 9, 'p' ^ 9, 'g' ^ 9,
+                               0x88, 0x80, 0, 0, 0, 0 };
+    LoopbackWebSocketTransport transport;
+    transport.incoming = frames;
+    transport.incomingLen = sizeof frames;
+
+    for(int i = 0; i < 10; i++) transport.readAvailable();
+
+    const uint8_t expected[] = { 0x8A, 2, 'p', 'g', 0x88, 0 };
+    TEST_ASSERT_EQUAL(sizeof expected, transport.wireLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, transport.wire, sizeof expected);
+    TEST_ASSERT_FALSE(transport.connected());
+}
+
+void testWebSocketCompletesPartialWrites() {
+    LoopbackWebSocketTransport transport;
+    transport.maxWrite = 3;
+    transport.writeStr("hello");
+    transport.flush();
+
+    // the device only takes three bytes at a time, the rest of the frame must still follow
+    const uint8_t expected[] = { 0x82, 5, 'h', 'e', 'l', 'l', 'o' };
+    TEST_ASSERT_EQUAL(sizeof expected, transport.wireLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, transport.wire, sizeof expected);
+    TEST_ASSERT_TRUE(transport.connected());
+
+    // when the device takes nothing at all, the frame cannot be completed and the connection is closed
+    transport.maxWrite = 0;
+    transport.writeStr("lost");
+    transport.flush();
+    TEST_ASSERT_FALSE(transport.connected());
+}
+
+void testWebSocketRejectsUnmaskedFrames() {
+    const uint8_t frames[] = { 0x82, 0x02, 'H', 'i' };
+    LoopbackWebSocketTransport transport;
+    transport.incoming = frames;
+    transport.incomingLen = sizeof frames;
+
+    for(int i = 0; i < 10; i++) TEST_ASSERT_FALSE(transport.readAvailable());
+
+    // the connection is failed with a close frame giving status 1002, a protocol error
+    const uint8_t expected[] = { 0x88, 2, 0x03, 0xEA };
+    TEST_ASSERT_EQUAL(sizeof expected, transport.wireLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, transport.wire, sizeof expected);
+    TEST_ASSERT_FALSE(transport.connected());
+}
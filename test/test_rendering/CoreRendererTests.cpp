@@ -1,6 +1,8 @@
 #include <unity.h>
 #include <graphics/GfxMenuConfig.h>
 #include <graphics/BaseGraphicalRenderer.h>
+#include <graphics/GraphicsDeviceRenderer.h>
+#include <graphics/FrameBufferDrawable.h>
 #include "../tutils/fixtures_extern.h"
 #include "../tutils/TestCapturingRenderer.h"
 
@@ -360,6 +362,137 @@ void testTakeOverDisplay() {
     TEST_ASSERT_EQUAL(500, drawingTest.getTicks());
 }
 
+void testEventDrivenRendering() {
+    TestCapturingRenderer renderer(320, 120, false, pgmName);
+    menuMgr.getNavigationStore().clearNavigationListeners();
+    menuMgr.initWithoutInput(&renderer, &textMenuItem1);
+    renderer.turnOffResetLogic();
+    taskManager.reset();
+    // item changes reach the renderer through an event that this registers, so it must be after the reset.
+    renderer.setEventDrivenRendering(25);
+    TEST_ASSERT_TRUE(renderer.isEventDrivenRendering());
+
+    renderer.exec();
+    TEST_ASSERT_TRUE(renderer.checkCommands(true, true, true));
+
+    // nothing has changed, so there should be no frames at all
+    renderer.resetCommandStates();
+    taskManager.yieldForMicros(100000);
+    TEST_ASSERT_TRUE(renderer.checkCommands(false, false, false));
+
+    // changing an item schedules a single frame that draws it
+    auto enumRecord = renderer.getMenuItemRecordings().getByKey(3);
+    TEST_ASSERT_NOT_NULL(enumRecord);
+    int enumDraws = enumRecord->updated;
+    menuEnum1.setCurrentValue(menuEnum1.getCurrentValue() == 0 ? 1 : 0);
+    taskManager.yieldForMicros(100000);
+    TEST_ASSERT_TRUE(renderer.checkCommands(false, true, true));
+    TEST_ASSERT_EQUAL(enumDraws + 1, renderer.getMenuItemRecordings().getByKey(3)->updated);
+
+    renderer.resetCommandStates();
+    taskManager.yieldForMicros(100000);
+    TEST_ASSERT_TRUE(renderer.checkCommands(false, false, false));
+
+    renderer.setEventDrivenRendering(0);
+    taskManager.reset();
+}
+
+void testAdaptiveFrameRate() {
+    TestCapturingRenderer renderer(320, 120, false, pgmName);
+    menuMgr.getNavigationStore().clearNavigationListeners();
+    menuMgr.initWithoutInput(&renderer, &textMenuItem1);
+    renderer.turnOffResetLogic();
+    taskManager.reset();
+    renderer.setAdaptiveFrameRate(2, 20, 100, 100);
+
+    // straight after interaction the rate is boosted
+    renderer.menuAltered();
+    renderer.exec();
+    TEST_ASSERT_EQUAL(20, renderer.getEffectiveFrameRate());
+
+    // half way through the decay the rate is between the two, and it keeps falling
+    taskManager.yieldForMicros(150000);
+    renderer.exec();
+    uint8_t decaying = renderer.getEffectiveFrameRate();
+    TEST_ASSERT_TRUE(decaying > 2 && decaying < 20);
+    taskManager.yieldForMicros(30000);
+    renderer.exec();
+    TEST_ASSERT_TRUE(renderer.getEffectiveFrameRate() < decaying);
+    TEST_ASSERT_TRUE(renderer.getEffectiveFrameRate() > 2);
+
+    // and once both the hold and decay time have passed it is back to idle
+    taskManager.yieldForMicros(250000);
+    renderer.exec();
+    TEST_ASSERT_EQUAL(2, renderer.getEffectiveFrameRate());
+
+    // the next idle frame is 500ms away, interaction brings it forward to the boosted rate
+    renderer.resetCommandStates();
+    renderer.menuAltered();
+    TEST_ASSERT_EQUAL(20, renderer.getEffectiveFrameRate());
+    taskManager.yieldForMicros(100000);
+    TEST_ASSERT_TRUE(renderer.checkCommands(false, true, true));
+
+    // when event driven, a frame requested while idle is also brought forward by interaction
+    renderer.setEventDrivenRendering(25);
+    taskManager.yieldForMicros(450000);
+    renderer.exec();
+    renderer.resetCommandStates();
+    menuEnum1.setCurrentValue(menuEnum1.getCurrentValue() == 0 ? 1 : 0);
+    taskManager.yieldForMicros(1000);
+    TEST_ASSERT_EQUAL(2, renderer.getEffectiveFrameRate());
+    renderer.menuAltered();
+    taskManager.yieldForMicros(100000);
+    TEST_ASSERT_TRUE(renderer.checkCommands(false, true, true));
+    renderer.setEventDrivenRendering(0);
+
+    renderer.turnOffAdaptiveFrameRate();
+    renderer.exec();
+    TEST_ASSERT_EQUAL(TC_DISPLAY_UPDATES_PER_SECOND, renderer.getEffectiveFrameRate());
+    taskManager.reset();
+}
+
+void testRendererCollectsStatistics() {
+    TestCapturingRenderer renderer(320, 120, false, pgmName);
+    menuMgr.getNavigationStore().clearNavigationListeners();
+    menuMgr.initWithoutInput(&renderer, &textMenuItem1);
+    taskManager.reset();
+    TEST_ASSERT_NULL(renderer.getRenderStatistics());
+    auto* stats = renderer.enableRenderStatistics(8);
+    TEST_ASSERT_EQUAL_PTR(stats, renderer.enableRenderStatistics());
+
+    renderer.exec();
+    TEST_ASSERT_EQUAL(1, stats->getFramesStored());
+    TEST_ASSERT_TRUE(stats->getFrame(0).completeRedraw);
+    TEST_ASSERT_EQUAL(1, stats->getCompleteRedraws());
+    TEST_ASSERT_EQUAL(renderer.getMenuItemRecordings().count(), stats->getFrame(0).itemsDrawn);
+    TEST_ASSERT_EQUAL(0, stats->getFrame(0).itemsSkipped);
+
+    // only the changed item is drawn, the rest are skipped
+    menuEnum1.setCurrentValue(menuEnum1.getCurrentValue() == 0 ? 1 : 0);
+    renderer.exec();
+    TEST_ASSERT_EQUAL(2, stats->getFramesStored());
+    TEST_ASSERT_FALSE(stats->getFrame(0).completeRedraw);
+    TEST_ASSERT_EQUAL(1, stats->getFrame(0).itemsDrawn);
+    TEST_ASSERT_TRUE(stats->getFrame(0).itemsSkipped > 0);
+    TEST_ASSERT_EQUAL(1, stats->getCompleteRedraws());
+
+    // a statistics item that is not on screen is never marked changed, otherwise it would force a frame every second
+    RenderStatisticsMenuItem offScreenItem(stats, 2000);
+    offScreenItem.setChanged(false);
+    taskManager.yieldForMicros(1100000);
+    renderer.exec();
+    TEST_ASSERT_FALSE(offScreenItem.isChanged());
+
+    // but once on screen, it is marked changed a second after it was last updated
+    RenderStatisticsMenuItem onScreenItem(stats, 2001, &textMenuItem1);
+    menuMgr.navigateToMenu(&onScreenItem, nullptr, true);
+    renderer.exec();
+    taskManager.yieldForMicros(1100000);
+    renderer.exec();
+    TEST_ASSERT_TRUE(onScreenItem.isChanged());
+    taskManager.reset();
+}
+
 extern int testBasicRuntimeFn(RuntimeMenuItem* item, uint8_t row, RenderFnMode mode, char* buffer, int bufferSize);
 
 void testListRendering() {
@@ -382,3 +515,147 @@ void testListRendering() {
     checkItem("List.R2", renderer.getMenuItemRecordings().getByKey(2), Coord(0, 65), Coord(320, 20), pointer1, GridPosition::DRAW_TEXTUAL_ITEM, GridPosition::JUSTIFY_TITLE_LEFT_VALUE_RIGHT, 0, &runtimeItem);
     checkItem("List.R3", renderer.getMenuItemRecordings().getByKey(3), Coord(0, 90), Coord(320, 20), pointer1, GridPosition::DRAW_TEXTUAL_ITEM, GridPosition::JUSTIFY_TITLE_LEFT_VALUE_RIGHT, 0, &runtimeItem);
 }
+
+/**
+ * A framebuffer with a simple native font, every character is drawn as a 5x8 block with a 6 pixel advance, so that
+ * where the graphics renderer drew text can be checked.
+ */
+class BlockFontDrawable : public FrameBufferDrawable {
+public:
+    explicit BlockFontDrawable(int width) : FrameBufferDrawable(Coord(width, 64), FRAMEBUFFER_RGB565) {}
+
+    void internalDrawText(const Coord &where, const void *font, int mag, const char *text) override {
+        for(int x = where.x; *text; text++, x += 6) {
+            drawBox(Coord(x, where.y), Coord(5, 8), true);
+        }
+    }
+
+    Coord internalTextExtents(const void *font, int mag, const char *text, int *baseline) override {
+        if(baseline) *baseline = 1;
+        return Coord(int(strlen(text)) * 6, 8);
+    }
+
+    bool isTextAt(int x, int y) const { return getPixelRgb(x, y) == 0xffffffUL; }
+};
+
+color_t blockFontPalette[] = {RGB(255,255,255), RGB(0,0,0), RGB(0,0,255), RGB(255,255,255)};
+
+void prepareBlockFontRenderer(GraphicsDeviceRenderer& renderer) {
+    auto& factory = renderer.getGraphicsPropertiesFactory();
+    factory.setSelectedColors(RGB(0,0,255), RGB(255,255,255));
+    factory.setDrawingPropertiesDefault(ItemDisplayProperties::COMPTYPE_TITLE, blockFontPalette, MenuPadding(4), pointer1, 1, 0, 20, GridPosition::JUSTIFY_CENTER_NO_VALUE, MenuBorder(0));
+    factory.setDrawingPropertiesDefault(ItemDisplayProperties::COMPTYPE_ACTION, blockFontPalette, MenuPadding(4), pointer1, 1, 0, 20, GridPosition::JUSTIFY_LEFT_NO_VALUE, MenuBorder(0));
+    factory.setDrawingPropertiesDefault(ItemDisplayProperties::COMPTYPE_ITEM, blockFontPalette, MenuPadding(4), pointer1, 1, 0, 20, GridPosition::JUSTIFY_TITLE_LEFT_VALUE_RIGHT, MenuBorder(0));
+    textMenuItem1.setTextValue("AB");
+    menuMgr.getNavigationStore().clearNavigationListeners();
+    menuMgr.initWithoutInput(&renderer, &textMenuItem1);
+    renderer.setTitleMode(BaseGraphicalRenderer::NO_TITLE);
+    renderer.turnOffResetLogic();
+    taskManager.reset();
+}
+
+void testGraphicsRendererRedrawsOnlyValue() {
+    BlockFontDrawable drawable(80);
+    GraphicsDeviceRenderer renderer(30, pgmName, &drawable);
+    prepareBlockFontRenderer(renderer);
+    renderer.exec();
+    TEST_ASSERT_EQUAL(0, renderer.getValueOnlyRedraws());
+    TEST_ASSERT_TRUE(drawable.isTextAt(65, 5));
+
+    // the value is now one character longer, only it is drawn and the name is left as it was
+    textMenuItem1.setTextValue("ABC");
+    drawable.resetStatistics();
+    renderer.exec();
+    TEST_ASSERT_EQUAL(1, renderer.getValueOnlyRedraws());
+    TEST_ASSERT_TRUE(drawable.isTextAt(59, 5));
+    TEST_ASSERT_FALSE(drawable.isTextAt(57, 5));
+    TEST_ASSERT_TRUE(drawable.getPixelsWritten() < 80 * 20);
+    TEST_ASSERT_TRUE(drawable.isTextAt(5, 5));
+
+    // the value would reach the name, so the whole row is drawn again
+    textMenuItem1.setTextValue("ABCDEFGHI");
+    drawable.resetStatistics();
+    renderer.exec();
+    TEST_ASSERT_EQUAL(1, renderer.getValueOnlyRedraws());
+    TEST_ASSERT_TRUE(drawable.getPixelsWritten() >= 80 * 20);
+    TEST_ASSERT_TRUE(drawable.isTextAt(23, 5));
+    taskManager.reset();
+}
+
+/**
+ * A block font drawable that keeps the areas it was given at the end of each transaction.
+ */
+class RegionCapturingDrawable : public BlockFontDrawable {
+public:
+    DirtyRegions lastChanged;
+    int transactionsEnded = 0;
+
+    explicit RegionCapturingDrawable(int width) : BlockFontDrawable(width) {}
+
+    void endTransaction(const DirtyRegions& changed) override {
+        lastChanged = changed;
+        transactionsEnded++;
+        BlockFontDrawable::endTransaction(changed);
+    }
+};
+
+void checkRegion(const DirtyRegions& regions, uint8_t idx, Coord where, Coord size) {
+    auto& region = regions.getRegion(idx);
+    TEST_ASSERT_EQUAL(where.x, region.where.x);
+    TEST_ASSERT_EQUAL(where.y, region.where.y);
+    TEST_ASSERT_EQUAL(size.x, region.size.x);
+    TEST_ASSERT_EQUAL(size.y, region.size.y);
+}
+
+void testGraphicsRendererPassesDirtyRegionsToDrawable() {
+    RegionCapturingDrawable drawable(80);
+    GraphicsDeviceRenderer renderer(30, pgmName, &drawable);
+    prepareBlockFontRenderer(renderer);
+
+    // a complete redraw is one area that covers the display, and the last row that overhangs it
+    renderer.exec();
+    TEST_ASSERT_EQUAL(1, drawable.transactionsEnded);
+    TEST_ASSERT_EQUAL(1, drawable.lastChanged.getCount());
+    checkRegion(drawable.lastChanged, 0, Coord(0, 0), Coord(80, 80));
+
+    // only the value of the first row is drawn, so only that part of the row is passed on
+    textMenuItem1.setTextValue("ABC");
+    renderer.exec();
+    TEST_ASSERT_EQUAL(1, drawable.lastChanged.getCount());
+    checkRegion(drawable.lastChanged, 0, Coord(58, 0), Coord(22, 20));
+
+    // two rows that do not touch are kept as separate areas
+    menuEnum1.setCurrentValue(menuEnum1.getCurrentValue() == 0 ? 1 : 0);
+    textMenuItem1.setTextValue("ABCDEFGHIJ");
+    renderer.exec();
+    TEST_ASSERT_EQUAL(2, drawable.lastChanged.getCount());
+    checkRegion(drawable.lastChanged, 0, Coord(0, 0), Coord(80, 20));
+    checkRegion(drawable.lastChanged, 1, Coord(0, 40), Coord(80, 20));
+
+    // and when nothing changes, the transaction still ends but with no areas
+    renderer.exec();
+    TEST_ASSERT_EQUAL(4, drawable.transactionsEnded);
+    TEST_ASSERT_TRUE(drawable.lastChanged.isEmpty());
+    taskManager.reset();
+}
+
+const uint8_t cardArrowXbm[] = { 0x03, 0x07, 0x0f, 0x1f, 0x3f, 0x7f, 0x3f, 0x1f, 0x0f, 0x07, 0x03 };
+
+void testGraphicsRendererCardLayoutDrawsWholeItem() {
+    BlockFontDrawable drawable(128);
+    GraphicsDeviceRenderer renderer(30, pgmName, &drawable);
+    DrawableIcon arrow(0, Coord(8, 11), DrawableIcon::ICON_XBITMAP, cardArrowXbm);
+    renderer.enableCardLayout(arrow, arrow, nullptr, false);
+    prepareBlockFontRenderer(renderer);
+    renderer.exec();
+    TEST_ASSERT_TRUE(drawable.isTextAt(21, 27));
+    TEST_ASSERT_TRUE(drawable.isTextAt(97, 27));
+
+    // the card pane is cleared whenever its item changes, so the name must be drawn again along with the value
+    textMenuItem1.setTextValue("ABC");
+    renderer.exec();
+    TEST_ASSERT_EQUAL(0, renderer.getValueOnlyRedraws());
+    TEST_ASSERT_TRUE(drawable.isTextAt(21, 27));
+    TEST_ASSERT_TRUE(drawable.isTextAt(91, 27));
+    taskManager.reset();
+}
@@ -0,0 +1,51 @@
+#include <unity.h>
+#include <graphics/DeviceDrawable.h>
+
+using namespace tcgfx;
+
+static void assertRegion(const DirtyRegions::Region& r, int x, int y, int w, int h) {
+    TEST_ASSERT_EQUAL(x, r.where.x);
+    TEST_ASSERT_EQUAL(y, r.where.y);
+    TEST_ASSERT_EQUAL(w, r.size.x);
+    TEST_ASSERT_EQUAL(h, r.size.y);
+}
+
+void testDirtyRegionsMergeTouchingAreas() {
+    DirtyRegions regions;
+    TEST_ASSERT_TRUE(regions.isEmpty());
+    regions.add(Coord(0, 0), Coord(0, 10));
+    TEST_ASSERT_TRUE(regions.isEmpty());
+
+    // two rows that are next to each other become one area
+    regions.add(Coord(0, 20), Coord(320, 20));
+    regions.add(Coord(0, 40), Coord(320, 20));
+    TEST_ASSERT_EQUAL(1, regions.getCount());
+    assertRegion(regions.getRegion(0), 0, 20, 320, 40);
+
+    // a widget far away is kept separate
+    regions.add(Coord(300, 0), Coord(16, 10));
+    TEST_ASSERT_EQUAL(2, regions.getCount());
+
+    // an area between them that touches both joins all three together
+    regions.add(Coord(300, 10), Coord(16, 10));
+    TEST_ASSERT_EQUAL(1, regions.getCount());
+    assertRegion(regions.getRegion(0), 0, 0, 320, 60);
+
+    regions.clear();
+    TEST_ASSERT_TRUE(regions.isEmpty());
+}
+
+void testDirtyRegionsMergeNearestWhenFull() {
+    DirtyRegions regions;
+    for(int i = 0; i < TC_DIRTY_REGION_COUNT; i++) {
+        regions.add(Coord(0, i * 100), Coord(10, 10));
+    }
+    TEST_ASSERT_EQUAL(TC_DIRTY_REGION_COUNT, regions.getCount());
+
+    // no space, so this is merged with the area that grows the least, the one at y = 100
+    regions.add(Coord(0, 125), Coord(10, 10));
+    TEST_ASSERT_EQUAL(TC_DIRTY_REGION_COUNT, regions.getCount());
+    assertRegion(regions.getRegion(1), 0, 100, 10, 35);
+
+    assertRegion(regions.getBounds(), 0, 0, 10, (TC_DIRTY_REGION_COUNT - 1) * 100 + 10);
+}
@@ -0,0 +1,188 @@
+#include <unity.h>
+#include <graphics/FrameBufferDrawable.h>
+#include <graphics/DeviceDrawableHelper.h>
+#include <graphics/GraphicsDeviceRenderer.h>
+#include <tcMenu.h>
+
+using namespace tcgfx;
+
+extern const GFXfont testFont;
+
+const color_t frameBufferPalette[] = { RGB(0, 0, 0), RGB(255, 255, 255), RGB(255, 0, 0), RGB(0, 0, 255) };
+
+void drawRedBoxOnto(FrameBufferDrawable& fb) {
+    fb.startDraw();
+    fb.setDrawColor(RGB(250, 0, 0));
+    fb.drawBox(Coord(2, 1), Coord(4, 3), true);
+    fb.endDraw();
+}
+
+void testFrameBufferFormats() {
+    FrameBufferDrawable mono(Coord(16, 8), FrameBufferDrawable::FRAMEBUFFER_MONO);
+    FrameBufferDrawable palette(Coord(16, 8), FrameBufferDrawable::FRAMEBUFFER_4BPP, frameBufferPalette, 4);
+    FrameBufferDrawable rgb(Coord(16, 8), FrameBufferDrawable::FRAMEBUFFER_RGB565);
+    drawRedBoxOnto(mono);
+    drawRedBoxOnto(palette);
+    drawRedBoxOnto(rgb);
+
+    TEST_ASSERT_EQUAL(1, mono.getRawPixel(2, 1));
+    TEST_ASSERT_EQUAL(1, mono.getRawPixel(5, 3));
+    TEST_ASSERT_EQUAL(0, mono.getRawPixel(6, 3));
+    TEST_ASSERT_EQUAL_HEX32(0xffffff, mono.getPixelRgb(3, 2));
+
+    // the nearest palette entry is used when the color is not in the palette
+    TEST_ASSERT_EQUAL(2, palette.getRawPixel(2, 1));
+    TEST_ASSERT_EQUAL(0, palette.getRawPixel(1, 1));
+    TEST_ASSERT_EQUAL_HEX32(0xff0000, palette.getPixelRgb(5, 3));
+
+    // pixels are always stored as RGB565, even when color_t is 32 bit
+    TEST_ASSERT_EQUAL_HEX16(0xf800, rgb.getRawPixel(4, 2));
+    TEST_ASSERT_EQUAL_HEX32(0, rgb.getPixelRgb(2, 4));
+    TEST_ASSERT_EQUAL_HEX32(0, rgb.getPixelRgb(-1, 40));
+
+    TEST_ASSERT_EQUAL(12, rgb.getPixelsWritten());
+    TEST_ASSERT_EQUAL(12, rgb.getPixelsLastFrame());
+    TEST_ASSERT_EQUAL(1, rgb.getFramesDrawn());
+
+#ifdef TC_FRAMEBUFFER_FILE_SUPPORT
+    FILE* file = tmpfile();
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_TRUE(palette.writePpm(file));
+    TEST_ASSERT_EQUAL(12 + (16 * 8 * 3), ftell(file));
+    rewind(file);
+    char header[12] = {};
+    TEST_ASSERT_EQUAL(11, fread(header, 1, 11, file));
+    TEST_ASSERT_EQUAL_STRING("P6\n16 8\n255", header);
+    fclose(file);
+#endif
+}
+
+void testFrameBufferSpritesCopyToParent() {
+    FrameBufferDrawable fb(Coord(32, 16), FrameBufferDrawable::FRAMEBUFFER_RGB565);
+    TEST_ASSERT_NULL(fb.getSubDeviceFor(Coord(4, 4), Coord(8, 4), frameBufferPalette, 4));
+    TEST_ASSERT_EQUAL(DeviceDrawable::NO_SUB_DEVICE, fb.getSubDeviceType());
+
+    fb.enableSprites(Coord(16, 8));
+    TEST_ASSERT_EQUAL(DeviceDrawable::SUB_DEVICE_4BPP, fb.getSubDeviceType());
+    TEST_ASSERT_NULL(fb.getSubDeviceFor(Coord(4, 4), Coord(20, 4), frameBufferPalette, 4));
+
+    fb.startDraw();
+    auto* sprite = fb.getSubDeviceFor(Coord(4, 4), Coord(8, 4), frameBufferPalette, 4);
+    TEST_ASSERT_NOT_NULL(sprite);
+    sprite->startDraw();
+    sprite->setDrawColor(frameBufferPalette[1]);
+    sprite->drawBox(Coord(0, 0), Coord(8, 4), true);
+    sprite->setDrawColor(frameBufferPalette[3]);
+    sprite->drawPixel(1, 1);
+    TEST_ASSERT_EQUAL(0, fb.getPixelsWritten());
+    sprite->endDraw();
+    fb.endDraw();
+
+    TEST_ASSERT_EQUAL_HEX32(0xffffff, fb.getPixelRgb(4, 4));
+    TEST_ASSERT_EQUAL_HEX32(0x0000ff, fb.getPixelRgb(5, 5));
+    TEST_ASSERT_EQUAL_HEX32(0xffffff, fb.getPixelRgb(11, 7));
+    TEST_ASSERT_EQUAL_HEX32(0, fb.getPixelRgb(3, 4));
+    TEST_ASSERT_EQUAL_HEX32(0, fb.getPixelRgb(12, 8));
+
+    // the whole sprite is copied onto the framebuffer, so each of its pixels is counted once
+    TEST_ASSERT_EQUAL(32, fb.getPixelsLastFrame());
+    TEST_ASSERT_EQUAL(1, fb.getFramesDrawn());
+
+    fb.startDraw();
+    fb.endDraw();
+    TEST_ASSERT_EQUAL(0, fb.getPixelsLastFrame());
+    TEST_ASSERT_EQUAL(32, fb.getPixelsWritten());
+}
+
+int countPixelsOfRgb(FrameBufferDrawable& fb, uint32_t rgb) {
+    int count = 0;
+    for(int y = 0; y < fb.getDisplayDimensions().y; y++) {
+        for(int x = 0; x < fb.getDisplayDimensions().x; x++) {
+            if(fb.getPixelRgb(x, y) == rgb) count++;
+        }
+    }
+    return count;
+}
+
+void drawRedTextOnto(FrameBufferDrawable& fb) {
+    fb.enableTcUnicode();
+    fb.startDraw();
+    DeviceDrawableHelper helper(&fb);
+    helper.setFontFromParameters(&testFont, 1);
+    helper.drawText(Coord(0, 0), RGB(250, 0, 0), "B");
+    fb.setDrawColor(RGB(250, 0, 0));
+    fb.drawText(Coord(8, 0), &testFont, 1, "B");
+    fb.endDraw();
+}
+
+void testFrameBufferTextInEachFormat() {
+    // text colors are mapped once for the framebuffer, each B is a 3x5 block so 30 pixels are drawn in total
+    FrameBufferDrawable mono(Coord(16, 8), FrameBufferDrawable::FRAMEBUFFER_MONO);
+    FrameBufferDrawable palette(Coord(16, 8), FrameBufferDrawable::FRAMEBUFFER_4BPP, frameBufferPalette, 4);
+    FrameBufferDrawable rgb(Coord(16, 8), FrameBufferDrawable::FRAMEBUFFER_RGB565);
+    drawRedTextOnto(mono);
+    drawRedTextOnto(palette);
+    drawRedTextOnto(rgb);
+    TEST_ASSERT_EQUAL(30, countPixelsOfRgb(mono, 0xffffff));
+    TEST_ASSERT_EQUAL(30, countPixelsOfRgb(palette, 0xff0000));
+    TEST_ASSERT_EQUAL(30, countPixelsOfRgb(rgb, 0xff0000));
+    TEST_ASSERT_EQUAL(16 * 8 - 30, countPixelsOfRgb(rgb, 0));
+
+    // and on a sprite, the palette index is mapped onto the parent when it is copied
+    FrameBufferDrawable fb(Coord(32, 16), FrameBufferDrawable::FRAMEBUFFER_RGB565);
+    fb.enableSprites(Coord(16, 8));
+    fb.startDraw();
+    auto* sprite = static_cast<FrameBufferDrawable*>(fb.getSubDeviceFor(Coord(4, 4), Coord(16, 8), frameBufferPalette, 4));
+    TEST_ASSERT_NOT_NULL(sprite);
+    drawRedTextOnto(*sprite);
+    fb.endDraw();
+    TEST_ASSERT_EQUAL(30, countPixelsOfRgb(fb, 0xff0000));
+    TEST_ASSERT_EQUAL(32 * 16 - 30, countPixelsOfRgb(fb, 0));
+}
+
+// two actions that only use the letters in the test font, so that every pixel of the menu is known.
+const AnyMenuInfo minfoFrameBufferBA PROGMEM = { "BA", 901, 0xffff, 0, NO_CALLBACK };
+ActionMenuItem menuFrameBufferBA(&minfoFrameBufferBA, nullptr);
+const AnyMenuInfo minfoFrameBufferAB PROGMEM = { "AB", 900, 0xffff, 0, NO_CALLBACK };
+ActionMenuItem menuFrameBufferAB(&minfoFrameBufferAB, &menuFrameBufferBA);
+const char frameBufferMenuName[] PROGMEM = "FB";
+
+void testGraphicsRendererDrawsMenuOntoFrameBuffer() {
+    FrameBufferDrawable fb(Coord(32, 24), FrameBufferDrawable::FRAMEBUFFER_RGB565);
+    GraphicsDeviceRenderer renderer(30, frameBufferMenuName, &fb);
+    renderer.enableTcUnicode();
+    color_t actionPalette[] = { RGB(255, 255, 255), RGB(0, 0, 255), RGB(0, 0, 255), RGB(255, 255, 255) };
+    auto& factory = renderer.getGraphicsPropertiesFactory();
+    factory.setDrawingPropertiesDefault(ItemDisplayProperties::COMPTYPE_TITLE, actionPalette, MenuPadding(2), &testFont, 1, 0, 11, GridPosition::JUSTIFY_LEFT_NO_VALUE, MenuBorder(0));
+    factory.setDrawingPropertiesDefault(ItemDisplayProperties::COMPTYPE_ITEM, actionPalette, MenuPadding(2), &testFont, 1, 0, 11, GridPosition::JUSTIFY_LEFT_NO_VALUE, MenuBorder(0));
+    factory.setDrawingPropertiesDefault(ItemDisplayProperties::COMPTYPE_ACTION, actionPalette, MenuPadding(2), &testFont, 1, 0, 11, GridPosition::JUSTIFY_LEFT_NO_VALUE, MenuBorder(0));
+    menuMgr.getNavigationStore().clearNavigationListeners();
+    menuMgr.initWithoutInput(&renderer, &menuFrameBufferAB);
+    renderer.setTitleMode(BaseGraphicalRenderer::NO_TITLE);
+    renderer.turnOffResetLogic();
+    taskManager.reset();
+    renderer.exec();
+
+    // each A is 12 pixels and each B 15, the rest of the display is the item background
+    TEST_ASSERT_EQUAL(54, countPixelsOfRgb(fb, 0xffffff));
+    TEST_ASSERT_EQUAL(32 * 24 - 54, countPixelsOfRgb(fb, 0x0000ff));
+    TEST_ASSERT_EQUAL_HEX32(0xffffff, fb.getPixelRgb(3, 2));   // top of the A in the first row
+    TEST_ASSERT_EQUAL_HEX32(0x0000ff, fb.getPixelRgb(2, 2));   // beside the top of the A
+    TEST_ASSERT_EQUAL_HEX32(0xffffff, fb.getPixelRgb(7, 6));   // bottom of the B
+    TEST_ASSERT_EQUAL_HEX32(0xffffff, fb.getPixelRgb(2, 13));  // the second row starts with B
+    TEST_ASSERT_EQUAL_HEX32(0x0000ff, fb.getPixelRgb(7, 14));  // inside the A of the second row
+    TEST_ASSERT_EQUAL_HEX32(0x0000ff, fb.getPixelRgb(2, 8));   // the padding between the rows
+    TEST_ASSERT_EQUAL(1, fb.getFramesDrawn());
+    uint32_t pixelsForMenu = fb.getPixelsLastFrame();
+    TEST_ASSERT_TRUE(pixelsForMenu >= 32 * 24);
+
+    // nothing has changed so the next frame writes no pixels, and a complete redraw writes the same pixels again
+    renderer.exec();
+    TEST_ASSERT_EQUAL(0, fb.getPixelsLastFrame());
+    renderer.redrawRequirement(MENUDRAW_COMPLETE_REDRAW);
+    renderer.exec();
+    TEST_ASSERT_EQUAL(pixelsForMenu, fb.getPixelsLastFrame());
+    TEST_ASSERT_EQUAL(pixelsForMenu * 2, fb.getPixelsWritten());
+    TEST_ASSERT_EQUAL(54, countPixelsOfRgb(fb, 0xffffff));
+    taskManager.reset();
+}
@@ -0,0 +1,125 @@
+#include <unity.h>
+#include <tcUnicodeHelper.h>
+#include <graphics/SoftwareRasterDrawable.h>
+#include <graphics/DeviceDrawableHelper.h>
+
+using namespace tcgfx;
+
+// A tiny two character Adafruit style font, 'A' is a 4x5 triangle and 'B' a 3x5 block, both set on the baseline.
+const uint8_t testFontBitmaps[] PROGMEM = {
+        0x69, 0xF9, 0x90, // A 4x5
+        0xFF, 0xFE        // B 3x5
+};
+
+const GFXglyph testFontGlyphs[] PROGMEM = {
+        { 0, 4, 5, 5, 0, -5 },
+        { 3, 3, 5, 4, 0, -5 }
+};
+
+// shared with the framebuffer tests, so it is given external linkage
+extern const GFXfont testFont;
+const GFXfont testFont PROGMEM = { (uint8_t*)testFontBitmaps, (GFXglyph*)testFontGlyphs, 'A', 'B', 7 };
+
+/**
+ * Keeps a byte per pixel so that the output with and without the glyph cache can be compared, and counts the calls.
+ */
+class MemoryDrawable : public SoftwareRasterDrawable {
+private:
+    uint8_t pixels[32 * 8];
+    int pixelCalls = 0;
+    int spanCalls = 0;
+public:
+    MemoryDrawable() : SoftwareRasterDrawable(Coord(32, 8)) { memset(pixels, 0, sizeof pixels); }
+
+    DeviceDrawable* getSubDeviceFor(const Coord &where, const Coord &size, const color_t *palette, int paletteSize) override { return nullptr; }
+    void transaction(bool isStarting, bool redrawNeeded) override {}
+    void drawPixel(uint16_t x, uint16_t y) override {
+        pixelCalls++;
+        SoftwareRasterDrawable::drawPixel(x, y);
+    }
+    void drawHorizontalSpan(const Coord& where, int width) override {
+        spanCalls++;
+        SoftwareRasterDrawable::drawHorizontalSpan(where, width);
+    }
+
+    const uint8_t* getPixels() const { return pixels; }
+    int getPixelCalls() const { return pixelCalls; }
+    int getSpanCalls() const { return spanCalls; }
+protected:
+    void writeSpan(int x, int y, int len, color_t color) override { memset(&pixels[y * 32 + x], int(color), len); }
+};
+
+void testTextPipelineDrawsSpans() {
+    MemoryDrawable drawable;
+    drawable.enableTcUnicode();
+    drawable.setDrawColor(1);
+    drawable.drawText(Coord(0, 0), &testFont, 1, "AB");
+
+    // A has 8 runs of pixels and B has 5, each is drawn as a single span instead of pixel by pixel
+    TEST_ASSERT_EQUAL(0, drawable.getPixelCalls());
+    TEST_ASSERT_EQUAL(13, drawable.getSpanCalls());
+    const uint8_t* pixels = drawable.getPixels();
+    TEST_ASSERT_EQUAL(1, pixels[2 * 32 + 0]);
+    TEST_ASSERT_EQUAL(0, pixels[2 * 32 + 4]);
+    TEST_ASSERT_EQUAL(1, pixels[2 * 32 + 5]);
+}
+
+void testGlyphCacheDrawsSameAsTcUnicode() {
+    MemoryDrawable plain;
+    plain.enableTcUnicode();
+    plain.setDrawColor(1);
+    plain.drawText(Coord(1, 0), &testFont, 1, "ABA B");
+
+    MemoryDrawable cached;
+    TEST_ASSERT_TRUE(cached.enableGlyphCache());
+    cached.setDrawColor(1);
+    cached.drawText(Coord(1, 0), &testFont, 1, "ABA B");
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(plain.getPixels(), cached.getPixels(), 32 * 8);
+
+    // A and B are only rasterised once, the space has no pixels but is still cached for its advance.
+    auto cache = cached.getGlyphCache();
+    TEST_ASSERT_EQUAL(3, cache->getMisses());
+    TEST_ASSERT_EQUAL(2, cache->getHits());
+    TEST_ASSERT_EQUAL(0, cached.getPixelCalls());
+
+    // drawing again in another color comes entirely from the cache
+    cached.setDrawColor(2);
+    plain.setDrawColor(2);
+    cached.drawText(Coord(1, 0), &testFont, 1, "BA");
+    plain.drawText(Coord(1, 0), &testFont, 1, "BA");
+    TEST_ASSERT_EQUAL(3, cache->getMisses());
+    TEST_ASSERT_EQUAL(4, cache->getHits());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(plain.getPixels(), cached.getPixels(), 32 * 8);
+}
+
+void testGlyphCacheRemovesOldestWhenFull() {
+    MemoryDrawable cached;
+    TEST_ASSERT_TRUE(cached.enableGlyphCache(2, 16));
+    cached.setDrawColor(1);
+    cached.drawText(Coord(0, 0), &testFont, 1, "AB");
+    cached.drawText(Coord(0, 0), &testFont, 1, "A");
+    TEST_ASSERT_EQUAL(1, cached.getGlyphCache()->getHits());
+
+    // the space needs a slot, B was used least recently so it is removed and A stays cached
+    cached.drawText(Coord(0, 0), &testFont, 1, " A");
+    TEST_ASSERT_EQUAL(2, cached.getGlyphCache()->getHits());
+    cached.drawText(Coord(0, 0), &testFont, 1, "B");
+    TEST_ASSERT_EQUAL(4, cached.getGlyphCache()->getMisses());
+}
+
+void testGlyphCacheDrawsInTextColor() {
+    MemoryDrawable cached;
+    TEST_ASSERT_TRUE(cached.enableGlyphCache());
+    DeviceDrawableHelper helper(&cached);
+    helper.setFontFromParameters(&testFont, 1);
+    helper.drawText(Coord(0, 0), 1, "AB");
+    TEST_ASSERT_EQUAL(1, cached.getPixels()[2 * 32 + 0]);
+
+    // the drawable was last used for something else, such as a cursor, the cached text must not take its color
+    cached.setDrawColor(3);
+    helper.drawText(Coord(0, 0), 2, "AB");
+    TEST_ASSERT_EQUAL(2, cached.getGlyphCache()->getHits());
+    TEST_ASSERT_EQUAL(2, cached.getPixels()[2 * 32 + 0]);
+    TEST_ASSERT_EQUAL(2, cached.getPixels()[4 * 32 + 5]);
+    TEST_ASSERT_EQUAL(0, cached.getPixels()[2 * 32 + 4]);
+}
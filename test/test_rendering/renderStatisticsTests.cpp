@@ -0,0 +1,49 @@
+#include <unity.h>
+#include <graphics/RenderStatistics.h>
+
+using namespace tcgfx;
+
+void recordFrame(RenderStatistics& stats, int drawn, int skipped, bool complete) {
+    stats.startFrame(complete);
+    for(int i = 0; i < drawn; i++) stats.itemDrawn(100);
+    for(int i = 0; i < skipped; i++) stats.itemSkipped();
+    stats.endFrame();
+}
+
+void testRenderStatisticsKeepsRollingHistory() {
+    RenderStatistics stats(4);
+    TEST_ASSERT_EQUAL(0, stats.getFramesStored());
+    TEST_ASSERT_EQUAL(0, stats.getAverage(METRIC_ITEMS_DRAWN));
+
+    // six frames into a history of four, so only the frames drawing 2..5 items remain
+    for(int i = 0; i < 6; i++) {
+        recordFrame(stats, i, 10 - i, i == 0);
+    }
+    TEST_ASSERT_EQUAL(4, stats.getFramesStored());
+    TEST_ASSERT_EQUAL(6, stats.getTotalFrames());
+    TEST_ASSERT_EQUAL(1, stats.getCompleteRedraws());
+    TEST_ASSERT_EQUAL(5, stats.getFrame(0).itemsDrawn);
+    TEST_ASSERT_EQUAL(500, stats.getFrame(0).drawItemMicros);
+    TEST_ASSERT_EQUAL(2, stats.getFrame(3).itemsDrawn);
+    TEST_ASSERT_EQUAL(3, stats.getAverage(METRIC_ITEMS_DRAWN));
+    TEST_ASSERT_EQUAL(5, stats.getMaximum(METRIC_ITEMS_DRAWN));
+    TEST_ASSERT_EQUAL(8, stats.getMaximum(METRIC_ITEMS_SKIPPED));
+
+    stats.reset();
+    TEST_ASSERT_EQUAL(0, stats.getFramesStored());
+    TEST_ASSERT_EQUAL(0, stats.getTotalFrames());
+}
+
+void testRenderStatisticsHistogram() {
+    RenderStatistics stats(8);
+    int drawn[] = { 0, 1, 1, 3, 4, 7, 9, 20 };
+    for(int d : drawn) recordFrame(stats, d, 0, false);
+
+    uint32_t limits[] = { 1, 4, 8 };
+    uint16_t counts[4];
+    stats.histogram(METRIC_ITEMS_DRAWN, limits, counts, 4);
+    TEST_ASSERT_EQUAL(1, counts[0]);
+    TEST_ASSERT_EQUAL(3, counts[1]);
+    TEST_ASSERT_EQUAL(2, counts[2]);
+    TEST_ASSERT_EQUAL(2, counts[3]);
+}
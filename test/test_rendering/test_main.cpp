@@ -8,6 +8,36 @@
 void testBaseDialogInfo();
 void testBaseDialogQuestion();
 
+// dirty region tests
+void testDirtyRegionsMergeTouchingAreas();
+void testDirtyRegionsMergeNearestWhenFull();
+
+// tile hashing tests
+void testTileHashingOnlyPushesChangedTiles();
+void testTileHashingOnlyChecksDirtyTiles();
+void testTileHashingClampsEdgeTiles();
+void testTileHashingBytesPerFrame();
+
+// text plotting and glyph cache tests
+void testTextPipelineDrawsSpans();
+void testGlyphCacheDrawsSameAsTcUnicode();
+void testGlyphCacheRemovesOldestWhenFull();
+void testGlyphCacheDrawsInTextColor();
+
+// text extents cache tests
+void testTextExtentsCacheRemembersMeasurements();
+void testTextExtentsCacheReplacesLeastRecentlyUsed();
+
+// render statistics tests
+void testRenderStatisticsKeepsRollingHistory();
+void testRenderStatisticsHistogram();
+
+// frame buffer tests
+void testFrameBufferFormats();
+void testFrameBufferSpritesCopyToParent();
+void testFrameBufferTextInEachFormat();
+void testGraphicsRendererDrawsMenuOntoFrameBuffer();
+
 // core renderer tests
 void testEmptyItemPropertiesFactory();
 void testDefaultItemPropertiesFactory();
@@ -17,7 +47,13 @@ void testGridPositionStorageAndRetrival();
 void testWidgetFunctionality();
 void testBaseRendererWithDefaults();
 void testTakeOverDisplay();
+void testEventDrivenRendering();
+void testAdaptiveFrameRate();
+void testRendererCollectsStatistics();
 void testListRendering();
+void testGraphicsRendererRedrawsOnlyValue();
+void testGraphicsRendererPassesDirtyRegionsToDrawable();
+void testGraphicsRendererCardLayoutDrawsWholeItem();
 
 void setup() {
     menuMgr.initWithoutInput(&noRenderer, &menuVolume);
@@ -29,6 +65,36 @@ void setup() {
     RUN_TEST(testBaseDialogInfo);
     RUN_TEST(testBaseDialogQuestion);
 
+    /* dirty regions */
+    RUN_TEST(testDirtyRegionsMergeTouchingAreas);
+    RUN_TEST(testDirtyRegionsMergeNearestWhenFull);
+
+    /* tile hashing */
+    RUN_TEST(testTileHashingOnlyPushesChangedTiles);
+    RUN_TEST(testTileHashingOnlyChecksDirtyTiles);
+    RUN_TEST(testTileHashingClampsEdgeTiles);
+    RUN_TEST(testTileHashingBytesPerFrame);
+
+    /* text plotting and glyph cache */
+    RUN_TEST(testTextPipelineDrawsSpans);
+    RUN_TEST(testGlyphCacheDrawsSameAsTcUnicode);
+    RUN_TEST(testGlyphCacheRemovesOldestWhenFull);
+    RUN_TEST(testGlyphCacheDrawsInTextColor);
+
+    /* text extents cache */
+    RUN_TEST(testTextExtentsCacheRemembersMeasurements);
+    RUN_TEST(testTextExtentsCacheReplacesLeastRecentlyUsed);
+
+    /* render statistics */
+    RUN_TEST(testRenderStatisticsKeepsRollingHistory);
+    RUN_TEST(testRenderStatisticsHistogram);
+
+    /* frame buffer */
+    RUN_TEST(testFrameBufferFormats);
+    RUN_TEST(testFrameBufferSpritesCopyToParent);
+    RUN_TEST(testFrameBufferTextInEachFormat);
+    RUN_TEST(testGraphicsRendererDrawsMenuOntoFrameBuffer);
+
     /* core renderer - keep last */
     RUN_TEST(testEmptyItemPropertiesFactory);
     RUN_TEST(testDefaultItemPropertiesFactory);
@@ -38,7 +104,13 @@ void setup() {
     RUN_TEST(testWidgetFunctionality);
     RUN_TEST(testBaseRendererWithDefaults);
     RUN_TEST(testTakeOverDisplay);
+    RUN_TEST(testEventDrivenRendering);
+    RUN_TEST(testAdaptiveFrameRate);
+    RUN_TEST(testRendererCollectsStatistics);
     RUN_TEST(testListRendering);
+    RUN_TEST(testGraphicsRendererRedrawsOnlyValue);
+    RUN_TEST(testGraphicsRendererPassesDirtyRegionsToDrawable);
+    RUN_TEST(testGraphicsRendererCardLayoutDrawsWholeItem);
 
     UNITY_END();
 }
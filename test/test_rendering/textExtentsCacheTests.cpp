@@ -0,0 +1,80 @@
+#include <unity.h>
+#include <graphics/SoftwareRasterDrawable.h>
+
+using namespace tcgfx;
+
+/**
+ * Measures native text as six pixels per character, counting how many times it is asked to measure.
+ */
+class MeasuringDrawable : public SoftwareRasterDrawable {
+private:
+    int measureCalls = 0;
+public:
+    MeasuringDrawable() : SoftwareRasterDrawable(Coord(32, 8)) {}
+
+    DeviceDrawable* getSubDeviceFor(const Coord &where, const Coord &size, const color_t *palette, int paletteSize) override { return nullptr; }
+    void transaction(bool isStarting, bool redrawNeeded) override {}
+    Coord internalTextExtents(const void *font, int mag, const char *text, int *baseline) override {
+        measureCalls++;
+        if(baseline) *baseline = 2;
+        return Coord(int(strlen(text)) * 6 * (mag ? mag : 1), 10);
+    }
+    int getMeasureCalls() const { return measureCalls; }
+protected:
+    void writeSpan(int x, int y, int len, color_t color) override {}
+};
+
+static const char fontOne[] = "font1";
+static const char fontTwo[] = "font2";
+
+void testTextExtentsCacheRemembersMeasurements() {
+    MeasuringDrawable drawable;
+    drawable.enableTextExtentsCache();
+    int baseline = 0;
+
+    Coord extents = drawable.textExtents(fontOne, 1, "12.5V", &baseline);
+    TEST_ASSERT_EQUAL(30, extents.x);
+    TEST_ASSERT_EQUAL(2, baseline);
+
+    // the same text again comes from the cache, including the baseline
+    baseline = 0;
+    extents = drawable.textExtents(fontOne, 1, "12.5V", &baseline);
+    TEST_ASSERT_EQUAL(30, extents.x);
+    TEST_ASSERT_EQUAL(2, baseline);
+    TEST_ASSERT_EQUAL(1, drawable.getMeasureCalls());
+
+    // a different string, font or magnification all need measuring
+    TEST_ASSERT_EQUAL(36, drawable.textExtents(fontOne, 1, "12.55V", &baseline).x);
+    TEST_ASSERT_EQUAL(30, drawable.textExtents(fontTwo, 1, "12.5V", &baseline).x);
+    TEST_ASSERT_EQUAL(60, drawable.textExtents(fontOne, 2, "12.5V", &baseline).x);
+    TEST_ASSERT_EQUAL(4, drawable.getMeasureCalls());
+
+    auto cache = drawable.getTextExtentsCache();
+    TEST_ASSERT_EQUAL(1, cache->getHits());
+    TEST_ASSERT_EQUAL(4, cache->getMisses());
+    TEST_ASSERT_EQUAL(20, cache->getHitRatePercent());
+
+    // replacing the font handler means fonts may be measured differently, so everything is forgotten
+    drawable.setFontHandler(nullptr);
+    drawable.textExtents(fontOne, 1, "12.5V", &baseline);
+    TEST_ASSERT_EQUAL(5, drawable.getMeasureCalls());
+}
+
+void testTextExtentsCacheReplacesLeastRecentlyUsed() {
+    TextExtentsCache cache(2);
+    Coord extents;
+    cache.add(fontOne, 0, "a", Coord(6, 10), 1);
+    cache.add(fontOne, 0, "b", Coord(7, 10), 1);
+    TEST_ASSERT_TRUE(cache.find(fontOne, 0, "a", extents, nullptr));
+    TEST_ASSERT_EQUAL(6, extents.x);
+
+    // b was used least recently, so it is the one replaced
+    cache.add(fontOne, 0, "c", Coord(8, 10), 1);
+    TEST_ASSERT_TRUE(cache.find(fontOne, 0, "a", extents, nullptr));
+    TEST_ASSERT_FALSE(cache.find(fontOne, 0, "b", extents, nullptr));
+    TEST_ASSERT_TRUE(cache.find(fontOne, 0, "c", extents, nullptr));
+    TEST_ASSERT_EQUAL(8, extents.x);
+
+    cache.clear();
+    TEST_ASSERT_FALSE(cache.find(fontOne, 0, "a", extents, nullptr));
+}
@@ -0,0 +1,164 @@
+#include <unity.h>
+#include <graphics/TileHashingDrawable.h>
+
+using namespace tcgfx;
+
+/**
+ * Stands in for a real display, counting the pixels that it receives and how many transactions were ended.
+ */
+class CountingDrawable : public SoftwareRasterDrawable {
+private:
+    uint32_t pixelsWritten = 0;
+    int transactionsEnded = 0;
+    DirtyRegions lastChanged;
+public:
+    explicit CountingDrawable(const Coord& size = Coord(128, 64)) : SoftwareRasterDrawable(size) {}
+
+    DeviceDrawable* getSubDeviceFor(const Coord &where, const Coord &size, const color_t *palette, int paletteSize) override { return nullptr; }
+    void transaction(bool isStarting, bool redrawNeeded) override { if(!isStarting) transactionsEnded++; }
+    void endTransaction(const DirtyRegions& changed) override {
+        lastChanged = changed;
+        transactionsEnded++;
+    }
+
+    uint32_t getPixelsWritten() const { return pixelsWritten; }
+    int getTransactionsEnded() const { return transactionsEnded; }
+    const DirtyRegions& getLastChanged() const { return lastChanged; }
+protected:
+    void writeSpan(int x, int y, int len, color_t color) override { pixelsWritten += len; }
+};
+
+static void drawFrame(TileHashingDrawable& drawable, const char* valueWidth) {
+    DirtyRegions changed;
+    drawable.startDraw();
+    drawable.setDrawColor(1);
+    drawable.drawBox(Coord(0, 0), Coord(128, 64), true);
+    drawable.setDrawColor(2);
+    drawable.drawBox(Coord(4, 20), Coord(int(strlen(valueWidth)) * 6, 8), true);
+    changed.add(Coord(0, 0), Coord(128, 64));
+    drawable.endDraw(changed);
+}
+
+void testTileHashingOnlyPushesChangedTiles() {
+    CountingDrawable display;
+    TileHashingDrawable tiles(&display);
+
+    // the first frame has never been sent, so every tile goes to the display
+    drawFrame(tiles, "12.5");
+    TEST_ASSERT_EQUAL(32, tiles.getTilesPushed());
+    TEST_ASSERT_EQUAL(128 * 64, tiles.getPixelsPushed());
+    TEST_ASSERT_EQUAL(128 * 64, display.getPixelsWritten());
+    TEST_ASSERT_EQUAL(1, display.getTransactionsEnded());
+
+    // repainting exactly the same pixels sends nothing, the display transaction is not even started
+    tiles.resetStatistics();
+    drawFrame(tiles, "12.5");
+    TEST_ASSERT_EQUAL(32, tiles.getTilesChecked());
+    TEST_ASSERT_EQUAL(0, tiles.getTilesPushed());
+    TEST_ASSERT_EQUAL(1, display.getTransactionsEnded());
+
+    // a value that grows by one character only changes the two tiles at its end, which are sent as one region
+    tiles.resetStatistics();
+    drawFrame(tiles, "12.55");
+    TEST_ASSERT_EQUAL(2, tiles.getTilesPushed());
+    TEST_ASSERT_EQUAL(2 * 16 * 16, tiles.getPixelsPushed());
+    TEST_ASSERT_EQUAL(2, display.getTransactionsEnded());
+    TEST_ASSERT_EQUAL(1, display.getLastChanged().getCount());
+    TEST_ASSERT_EQUAL(16, display.getLastChanged().getRegion(0).where.x);
+    TEST_ASSERT_EQUAL(16, display.getLastChanged().getRegion(0).where.y);
+    TEST_ASSERT_EQUAL(32, display.getLastChanged().getRegion(0).size.x);
+
+    // after invalidating, everything is sent again
+    tiles.resetStatistics();
+    tiles.invalidate();
+    drawFrame(tiles, "12.55");
+    TEST_ASSERT_EQUAL(32, tiles.getTilesPushed());
+}
+
+void testTileHashingOnlyChecksDirtyTiles() {
+    CountingDrawable display;
+    TileHashingDrawable tiles(&display);
+    drawFrame(tiles, "1");
+    tiles.resetStatistics();
+
+    // only the tiles under the changed area are hashed, including partial tiles at the edges
+    DirtyRegions changed;
+    tiles.startDraw();
+    tiles.setDrawColor(3);
+    tiles.drawBox(Coord(20, 20), Coord(20, 4), true);
+    changed.add(Coord(20, 20), Coord(20, 4));
+    tiles.endDraw(changed);
+    TEST_ASSERT_EQUAL(2, tiles.getTilesChecked());
+    TEST_ASSERT_EQUAL(2, tiles.getTilesPushed());
+}
+
+void testTileHashingClampsEdgeTiles() {
+    // neither dimension is a multiple of the tile size, so the right and bottom tiles are partial
+    CountingDrawable display(Coord(100, 50));
+    TileHashingDrawable tiles(&display);
+
+    DirtyRegions changed;
+    tiles.startDraw();
+    tiles.setDrawColor(1);
+    tiles.drawBox(Coord(0, 0), Coord(100, 50), true);
+    changed.add(Coord(0, 0), Coord(100, 50));
+    tiles.endDraw(changed);
+
+    TEST_ASSERT_EQUAL(7 * 4, tiles.getTilesPushed());
+    TEST_ASSERT_EQUAL(100 * 50, tiles.getPixelsPushed());
+    TEST_ASSERT_EQUAL(100 * 50, display.getPixelsWritten());
+    const DirtyRegions& pushed = display.getLastChanged();
+    TEST_ASSERT_TRUE(pushed.getCount() > 0);
+    for(uint8_t i = 0; i < pushed.getCount(); i++) {
+        TEST_ASSERT_TRUE(pushed.getRegion(i).where.x + pushed.getRegion(i).size.x <= 100);
+        TEST_ASSERT_TRUE(pushed.getRegion(i).where.y + pushed.getRegion(i).size.y <= 50);
+    }
+
+    // changing only the bottom right corner pushes just that partial tile
+    tiles.resetStatistics();
+    changed.clear();
+    tiles.startDraw();
+    tiles.setDrawColor(2);
+    tiles.drawPixel(99, 49);
+    changed.add(Coord(99, 49), Coord(1, 1));
+    tiles.endDraw(changed);
+    TEST_ASSERT_EQUAL(1, tiles.getTilesPushed());
+    TEST_ASSERT_EQUAL(4 * 2, tiles.getPixelsPushed());
+    TEST_ASSERT_EQUAL(1, display.getLastChanged().getCount());
+    TEST_ASSERT_EQUAL(96, display.getLastChanged().getRegion(0).where.x);
+    TEST_ASSERT_EQUAL(48, display.getLastChanged().getRegion(0).where.y);
+    TEST_ASSERT_EQUAL(4, display.getLastChanged().getRegion(0).size.x);
+    TEST_ASSERT_EQUAL(2, display.getLastChanged().getRegion(0).size.y);
+}
+
+void testTileHashingBytesPerFrame() {
+    // measures what reaches the display bus when a value row is repainted every frame, against sending the whole
+    // dirty region, at two bytes per pixel as on an RGB565 display. The value changes width on one frame in five.
+    const uint32_t bytesPerPixel = 2;
+    CountingDrawable display;
+    TileHashingDrawable tiles(&display);
+    drawFrame(tiles, "1");
+    tiles.resetStatistics();
+
+    uint32_t regionBytes = 0;
+    for(int frame = 0; frame < 10; frame++) {
+        DirtyRegions changed;
+        tiles.startDraw();
+        tiles.setDrawColor(1);
+        tiles.drawBox(Coord(0, 26), Coord(128, 12), true);
+        tiles.setDrawColor(2);
+        tiles.drawBox(Coord(80, 28), Coord((frame % 5) == 4 ? 30 : 24, 8), true);
+        changed.add(Coord(0, 26), Coord(128, 12));
+        tiles.endDraw(changed);
+        regionBytes += 128 * 12 * bytesPerPixel;
+    }
+
+    uint32_t tileBytes = tiles.getPixelsPushed() * bytesPerPixel;
+    TEST_ASSERT_EQUAL(10 * 128 * 12 * 2, regionBytes);
+    TEST_ASSERT_EQUAL(160, tiles.getTilesChecked());
+    // the first frame covers the old value and draws the new one, five tiles, then each width change alters the two
+    // tiles at the end of the value, on three frames. Everything else repaints identical pixels.
+    TEST_ASSERT_EQUAL(11, tiles.getTilesPushed());
+    TEST_ASSERT_EQUAL(11 * 16 * 16 * 2, tileBytes);
+    TEST_ASSERT_TRUE(tileBytes * 5 < regionBytes);
+}
@@ -0,0 +1,81 @@
+#ifndef TCMENU_POSIXLOOPBACKCLIENT_H
+#define TCMENU_POSIXLOOPBACKCLIENT_H
+
+#include <remote/PosixSocketTransport.h>
+
+#ifdef TC_POSIX_REMOTE_SUPPORT
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+/**
+ * The remote end of a loopback TCP connection for testing PosixSocketTransport, it sends tag value messages and
+ * keeps what the device sends back so that it can be checked. When the receive buffer fills, the older half is
+ * discarded, so it can also follow a long running stream.
+ */
+class PosixLoopbackClient {
+public:
+    int fd = -1;
+    char received[4096] = {};
+    size_t receivedLen = 0;
+    uint32_t totalReceived = 0;
+
+    ~PosixLoopbackClient() { if(fd >= 0) ::close(fd); }
+
+    bool connectTo(uint16_t port) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if(fd < 0) return false;
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        return connect(fd, (sockaddr*)&addr, sizeof addr) == 0;
+    }
+
+    /** Sends a tag value message with the fields given in wire format such as "ID=1|VC=2|" */
+    bool sendMessage(uint16_t msgType, const char* fields) {
+        char msg[256];
+        int len = snprintf(msg, sizeof msg, "%c%c%c%c%s%c", START_OF_MESSAGE, TAG_VAL_PROTOCOL, char(msgType >> 8),
+                           char(msgType & 0xff), fields, 0x02);
+        return send(fd, msg, len, 0) == len;
+    }
+
+    /** Reads anything waiting on the socket without blocking, @return the number of bytes read */
+    int readAvailable() {
+        int total = 0;
+        while(true) {
+            if(receivedLen == sizeof(received) - 1) {
+                size_t half = receivedLen / 2;
+                memmove(received, &received[half], receivedLen - half);
+                receivedLen -= half;
+            }
+            auto amt = recv(fd, &received[receivedLen], sizeof(received) - 1 - receivedLen, MSG_DONTWAIT);
+            if(amt <= 0) break;
+            receivedLen += amt;
+            received[receivedLen] = 0;
+            total += int(amt);
+        }
+        totalReceived += total;
+        return total;
+    }
+
+    /** @return true if the text appears anywhere in what has been received */
+    bool hasReceived(const char* text) const {
+        size_t len = strlen(text);
+        for(size_t i = 0; i + len <= receivedLen; i++) {
+            if(memcmp(&received[i], text, len) == 0) return true;
+        }
+        return false;
+    }
+
+    void clearReceived() {
+        receivedLen = 0;
+        received[0] = 0;
+    }
+};
+
+#endif // TC_POSIX_REMOTE_SUPPORT
+
+#endif //TCMENU_POSIXLOOPBACKCLIENT_H
@@ -0,0 +1,111 @@
+#ifndef TCMENU_TESTREMOTETRANSPORT_H
+#define TCMENU_TESTREMOTETRANSPORT_H
+
+#include <RemoteConnector.h>
+#include <RemoteAuthentication.h>
+#include <MessageProcessors.h>
+
+/**
+ * A transport for testing the remote connector, everything written is captured so that it can be checked, and
+ * messages can be queued up for the connector to read.
+ */
+class TestRemoteTransport : public TagValueTransport {
+public:
+    char written[4096];
+    size_t writtenLen = 0;
+    char inbound[512];
+    size_t inboundLen = 0;
+    size_t inboundPos = 0;
+    bool isConnected = true;
+
+    TestRemoteTransport() : TagValueTransport(TVAL_UNBUFFERED), written{}, inbound{} {}
+
+    int writeChar(char data) override {
+        if(writtenLen >= sizeof(written) - 1) return 0;
+        written[writtenLen++] = data;
+        written[writtenLen] = 0;
+        return 1;
+    }
+
+    int writeStr(const char* data) override {
+        int len = 0;
+        while(*data) len += writeChar(*data++);
+        return len;
+    }
+
+    void flush() override { }
+    uint8_t readByte() override { return inboundPos < inboundLen ? inbound[inboundPos++] : 0; }
+    bool readAvailable() override { return inboundPos < inboundLen; }
+    bool available() override { return isConnected; }
+    bool connected() override { return isConnected; }
+    void close() override { isConnected = false; }
+
+    /**
+     * Queue a tag value message to be read, the fields are written in wire format such as "ID=1|VC=2|".
+     */
+    void queueMessage(uint16_t msgType, const char* fields) {
+        inbound[inboundLen++] = START_OF_MESSAGE;
+        inbound[inboundLen++] = TAG_VAL_PROTOCOL;
+        inbound[inboundLen++] = char(msgType >> 8);
+        inbound[inboundLen++] = char(msgType & 0xff);
+        while(*fields) inbound[inboundLen++] = *fields++;
+        inbound[inboundLen++] = 0x02;
+    }
+
+    /** @return true if the text appears anywhere in what has been written, even after binary data containing zeros */
+    bool hasWritten(const char* text) const {
+        size_t len = strlen(text);
+        for(size_t i = 0; i + len <= writtenLen; i++) {
+            if(memcmp(&written[i], text, len) == 0) return true;
+        }
+        return false;
+    }
+
+    /** @return the number of times the message type has been started in what has been written */
+    int countMessages(uint16_t msgType) const {
+        int count = 0;
+        for(size_t i = 0; i + 3 < writtenLen; i++) {
+            if(written[i] == START_OF_MESSAGE && written[i + 2] == char(msgType >> 8) && written[i + 3] == char(msgType & 0xff)) count++;
+        }
+        return count;
+    }
+
+    void clearWritten() {
+        writtenLen = 0;
+        written[0] = 0;
+    }
+};
+
+const ConnectorLocalInfo testRemoteLocalInfo PROGMEM = { "unit test", "2ba37227-a412-40b7-94e7-42caf9bb0ff4" };
+
+/**
+ * A remote connector that is wired up to a test transport with no authentication, it can join with any join mode.
+ */
+class TestRemoteConnection {
+public:
+    TestRemoteTransport transport;
+    CombinedMessageProcessor processor;
+    NoAuthenticationManager authenticator;
+    TagValueRemoteConnector connector;
+
+    explicit TestRemoteConnection(TagValueTransport* overrideTransport = nullptr) {
+        processor.initialise();
+        connector.setAuthManager(&authenticator);
+        connector.initialise(overrideTransport ? overrideTransport : &transport, &processor, &testRemoteLocalInfo, 0);
+    }
+
+    void tickFor(int ticks) {
+        for(int i = 0; i < ticks; i++) connector.tick();
+    }
+
+    /** queue up a join message in the given mode and tick until it has been processed and the bootstrap sent */
+    void join(JoinMode mode, uint8_t capabilities = 0) {
+        char sz[80];
+        snprintf(sz, sizeof sz, "NM=tester|UU=%s|VE=100|PF=0|JM=%d|JC=%d|", "2ba37227-a412-40b7-94e7-42caf9bb0ff4",
+                 int(mode), int(capabilities));
+        transport.queueMessage(MSG_JOIN, sz);
+        tickFor(60);
+    }
+};
+
+#endif //TCMENU_TESTREMOTETRANSPORT_H